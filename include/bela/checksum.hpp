@@ -0,0 +1,86 @@
+// bela::hash non-cryptographic checksums: CRC32C, XXH64, XXH3-64/128
+// for cache validation and framing on hot paths, not for anything an attacker controls
+#ifndef BELA_CHECKSUM_HPP
+#define BELA_CHECKSUM_HPP
+#include "hash.hpp"
+
+namespace bela::hash {
+namespace crc32c {
+// Extend continue crc over data, Extend(0, data, len) is the CRC-32C (Castagnoli) of data.
+// SSE4.2 (x64) or ARMv8 CRC32 instructions on three interleaved streams, combined with
+// precomputed shift tables, slicing-by-8 elsewhere
+uint32_t Extend(uint32_t crc, const void *data, size_t len);
+inline uint32_t Checksum(const void *data, size_t len) { return Extend(0, data, len); }
+struct Hasher {
+  uint32_t crc{0};
+  void Initialize() { crc = 0; }
+  void Update(const void *input, size_t input_len) { crc = Extend(crc, input, input_len); }
+  uint32_t Value() const { return crc; }
+  // Finalize big-endian bytes, the order the value is usually printed in
+  void Finalize(uint8_t *out, size_t out_len) {
+    for (size_t i = 0; i < 4 && i < out_len; i++) {
+      out[i] = static_cast<uint8_t>(crc >> (24 - i * 8));
+    }
+  }
+  std::wstring Finalize() {
+    uint8_t buf[4];
+    Finalize(buf, sizeof(buf));
+    std::wstring s;
+    HashEncode(buf, sizeof(buf), s);
+    return s;
+  }
+};
+} // namespace crc32c
+
+namespace xxh64 {
+uint64_t Hash(const void *data, size_t len, uint64_t seed = 0);
+struct Hasher {
+  alignas(8) uint8_t state[88]; // XXH64_state_t
+  void Initialize(uint64_t seed = 0);
+  void Update(const void *input, size_t input_len);
+  uint64_t Value() const;
+  // Finalize canonical (big-endian) bytes
+  void Finalize(uint8_t *out, size_t out_len);
+  std::wstring Finalize() {
+    uint8_t buf[8];
+    Finalize(buf, sizeof(buf));
+    std::wstring s;
+    HashEncode(buf, sizeof(buf), s);
+    return s;
+  }
+};
+} // namespace xxh64
+
+namespace xxh3 {
+struct Uint128 {
+  uint64_t low;
+  uint64_t high;
+  friend constexpr bool operator==(const Uint128 &a, const Uint128 &b) { return a.low == b.low && a.high == b.high; }
+  friend constexpr bool operator!=(const Uint128 &a, const Uint128 &b) { return !(a == b); }
+};
+enum class HashBits { XXH3_64 = 64, XXH3_128 = 128 };
+// SSE2/NEON accumulators, AVX2 and AVX-512 picked at runtime when the CPU has them
+uint64_t Hash64(const void *data, size_t len, uint64_t seed = 0);
+Uint128 Hash128(const void *data, size_t len, uint64_t seed = 0);
+struct Hasher {
+  alignas(64) uint8_t state[576]; // XXH3_state_t
+  HashBits hb;
+  void Initialize(HashBits hb_ = HashBits::XXH3_64, uint64_t seed = 0);
+  void Update(const void *input, size_t input_len);
+  uint64_t Value64() const;
+  Uint128 Value128() const;
+  // Finalize canonical (big-endian) bytes, 8 or 16 depending on hb
+  void Finalize(uint8_t *out, size_t out_len);
+  std::wstring Finalize() {
+    uint8_t buf[16];
+    const size_t len = hb == HashBits::XXH3_128 ? 16 : 8;
+    Finalize(buf, len);
+    std::wstring s;
+    HashEncode(buf, len, s);
+    return s;
+  }
+};
+} // namespace xxh3
+} // namespace bela::hash
+
+#endif
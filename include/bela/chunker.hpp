@@ -0,0 +1,74 @@
+// bela::hash::Chunker content-defined chunking (FastCDC) with a digest per chunk
+#ifndef BELA_CHUNKER_HPP
+#define BELA_CHUNKER_HPP
+#include <deque>
+#include <memory>
+#include "hashfile.hpp"
+
+namespace bela {
+class TaskGroup;
+}
+
+namespace bela::hash {
+// ChunkerOptions sizes are sanitized: avg_size is rounded down to a power of two,
+// 64 <= min_size <= avg_size <= max_size
+struct ChunkerOptions {
+  size_t min_size{16 * 1024};
+  size_t avg_size{64 * 1024};
+  size_t max_size{256 * 1024};
+  Algorithm algorithm{Algorithm::BLAKE3};
+  // chunk digests are computed on this pool, nullptr use ThreadPool::Default()
+  bela::ThreadPool *pool{nullptr};
+};
+
+struct Chunk {
+  uint64_t offset{0};
+  size_t length{0};
+  FileDigest digest;
+};
+
+// Chunker cuts where a gear rolling hash matches a mask, so boundaries follow content and
+// resynchronize right after an insertion or deletion. Normalized chunking (FastCDC level 2)
+// uses a stricter mask before avg_size and a looser one after, which keeps chunk sizes close
+// to avg_size. The gear table is fixed: the same bytes and options always give the same chunks.
+//
+//   bela::hash::Chunker chunker;
+//   while (auto n = read(buf)) { chunker.Update(buf, n); }
+//   for (const auto &c : chunker.Finalize()) { upload_if_missing(c.digest, c.offset, c.length); }
+class Chunker {
+public:
+  explicit Chunker(const ChunkerOptions &options_ = {});
+  Chunker(const Chunker &) = delete;
+  Chunker &operator=(const Chunker &) = delete;
+  ~Chunker();
+  // Cut length of the chunk starting at data, n bytes available. The boundary is final only when
+  // it is less than n, or n >= max_size, or no data follows
+  size_t Cut(const uint8_t *data, size_t n) const;
+  // Update feed the next stream bytes. Chunks that need bytes of an earlier call are copied and hashed in
+  // the background, the others are hashed in place before Update returns. Less than max_size bytes are kept
+  void Update(const void *input, size_t input_len);
+  // Finalize cut the tail, wait for every digest and reset for a new stream
+  std::vector<Chunk> Finalize();
+  // Split chunk an in-memory buffer, boundaries first then digests in parallel
+  std::vector<Chunk> Split(const void *data, size_t len);
+#if defined(_WIN32)
+  // SplitFile map the file and Split it, an empty file has no chunks
+  bool SplitFile(std::wstring_view path, std::vector<Chunk> &out, bela::error_code &ec);
+#endif
+  const ChunkerOptions &Options() const { return options; }
+
+private:
+  void Emit(const uint8_t *data, size_t n);
+  ChunkerOptions options;
+  uint64_t mask_s{0}; // before avg_size, harder to match
+  uint64_t mask_l{0}; // after avg_size
+  bela::ThreadPool &pool;
+  std::unique_ptr<bela::TaskGroup> group;
+  std::vector<uint8_t> pending; // carry-over, shorter than max_size
+  std::deque<Chunk> chunks; // stable references, digests are written by pool tasks
+  uint64_t offset{0};
+  size_t inflight{0};
+};
+} // namespace bela::hash
+
+#endif
@@ -1,6 +1,7 @@
 //////////
 #ifndef BELA_CODECVT_HPP
 #define BELA_CODECVT_HPP
+#include <cstdint>
 #include <string>
 #include <vector>
 #include "ucwidth.hpp"
@@ -28,8 +29,16 @@ size_t char32tochar16(char32_t rune, char16_t *dest, size_t dlen);
 size_t char32tochar8(char32_t rune, char *dest, size_t dlen);
 // UTF-8/UTF-16 codecvt
 std::string c16tomb(const char16_t *data, size_t len);
+// mbrtowc/mbrtoc16 valid UTF-8 is validated and measured first, then transcoded into a single allocation by the
+// widest SIMD kernel the CPU supports. Invalid input takes the lenient rune at a time decoder.
 std::wstring mbrtowc(const unsigned char *str, size_t len);
 std::u16string mbrtoc16(const unsigned char *str, size_t len);
+namespace codecvt_internal {
+enum class Backend : uint32_t { Auto = 0, Portable, SSE41, AVX2, NEON };
+// SetBackend pin the UTF-8 to UTF-16 kernel, returns false if it isn't compiled in or the CPU can't run it
+bool SetBackend(Backend b);
+Backend ActiveBackend();
+} // namespace codecvt_internal
 // Narrow std::wstring_view to UTF-8
 inline std::string ToNarrow(std::wstring_view uw) {
   return c16tomb(reinterpret_cast<const char16_t *>(uw.data()), uw.size());
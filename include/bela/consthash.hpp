@@ -0,0 +1,237 @@
+// constexpr SHA-256 and BLAKE3: digests of embedded data computed by the compiler.
+//
+//   constexpr auto schema_digest = bela::hash::sha256::ConstexprHash(schema_json);
+//   static_assert(bela::hash::blake3::ConstexprHash("abc") == expected);
+//   // at startup the runtime Hasher output is compared with schema_digest, a 32 byte compare
+//
+// Straightforward portable code for constant evaluation, use the runtime Hasher for anything large.
+#ifndef BELA_CONSTHASH_HPP
+#define BELA_CONSTHASH_HPP
+#include "hash.hpp"
+
+namespace bela::hash {
+namespace consthash_internal {
+constexpr uint32_t rotr32(uint32_t x, int n) { return (x >> n) | (x << (32 - n)); }
+
+// bytes of data, string_view and uint8_t arrays alike
+struct ByteView {
+  const char *chars{nullptr};
+  const uint8_t *bytes{nullptr};
+  size_t size{0};
+  constexpr uint8_t operator[](size_t i) const {
+    return bytes != nullptr ? bytes[i] : static_cast<uint8_t>(chars[i]);
+  }
+};
+
+constexpr uint32_t sha256_k[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2};
+
+constexpr void sha256_block(uint32_t h[8], const uint8_t block[64]) {
+  uint32_t w[64]{};
+  for (int i = 0; i < 16; i++) {
+    w[i] = static_cast<uint32_t>(block[i * 4]) << 24 | static_cast<uint32_t>(block[i * 4 + 1]) << 16 |
+           static_cast<uint32_t>(block[i * 4 + 2]) << 8 | static_cast<uint32_t>(block[i * 4 + 3]);
+  }
+  for (int i = 16; i < 64; i++) {
+    const auto s0 = rotr32(w[i - 15], 7) ^ rotr32(w[i - 15], 18) ^ (w[i - 15] >> 3);
+    const auto s1 = rotr32(w[i - 2], 17) ^ rotr32(w[i - 2], 19) ^ (w[i - 2] >> 10);
+    w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+  }
+  uint32_t a = h[0], b = h[1], c = h[2], d = h[3], e = h[4], f = h[5], g = h[6], hh = h[7];
+  for (int i = 0; i < 64; i++) {
+    const auto t1 = hh + (rotr32(e, 6) ^ rotr32(e, 11) ^ rotr32(e, 25)) + ((e & f) ^ (~e & g)) + sha256_k[i] + w[i];
+    const auto t2 = (rotr32(a, 2) ^ rotr32(a, 13) ^ rotr32(a, 22)) + ((a & b) ^ (a & c) ^ (b & c));
+    hh = g, g = f, f = e, e = d + t1, d = c, c = b, b = a, a = t1 + t2;
+  }
+  h[0] += a, h[1] += b, h[2] += c, h[3] += d, h[4] += e, h[5] += f, h[6] += g, h[7] += hh;
+}
+
+constexpr Digest<32> sha256(ByteView data) {
+  uint32_t h[8] = {0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19};
+  uint8_t block[64]{};
+  size_t i = 0;
+  for (; i + 64 <= data.size; i += 64) {
+    for (size_t k = 0; k < 64; k++) {
+      block[k] = data[i + k];
+    }
+    sha256_block(h, block);
+  }
+  // padding: 0x80, zeros, 64-bit big-endian bit length, one or two blocks
+  const auto rest = data.size - i;
+  for (size_t k = 0; k < 64; k++) {
+    block[k] = k < rest ? data[i + k] : 0;
+  }
+  block[rest] = 0x80;
+  if (rest >= 56) {
+    sha256_block(h, block);
+    for (auto &b : block) {
+      b = 0;
+    }
+  }
+  const uint64_t bits = static_cast<uint64_t>(data.size) * 8;
+  for (int k = 0; k < 8; k++) {
+    block[56 + k] = static_cast<uint8_t>(bits >> (56 - k * 8));
+  }
+  sha256_block(h, block);
+  Digest<32> d;
+  for (int k = 0; k < 8; k++) {
+    d.bytes[k * 4] = static_cast<uint8_t>(h[k] >> 24);
+    d.bytes[k * 4 + 1] = static_cast<uint8_t>(h[k] >> 16);
+    d.bytes[k * 4 + 2] = static_cast<uint8_t>(h[k] >> 8);
+    d.bytes[k * 4 + 3] = static_cast<uint8_t>(h[k]);
+  }
+  return d;
+}
+
+constexpr uint32_t blake3_iv[8] = {0x6A09E667, 0xBB67AE85, 0x3C6EF372, 0xA54FF53A,
+                                   0x510E527F, 0x9B05688C, 0x1F83D9AB, 0x5BE0CD19};
+constexpr uint8_t blake3_schedule[7][16] = {
+    {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15}, {2, 6, 3, 10, 7, 0, 4, 13, 1, 11, 12, 5, 9, 14, 15, 8},
+    {3, 4, 10, 12, 13, 2, 7, 14, 6, 5, 9, 0, 11, 15, 8, 1}, {10, 7, 12, 9, 14, 3, 13, 15, 4, 0, 11, 2, 5, 8, 1, 6},
+    {12, 13, 9, 11, 15, 10, 14, 8, 7, 2, 5, 3, 0, 1, 6, 4}, {9, 14, 11, 5, 8, 12, 15, 1, 13, 3, 0, 10, 2, 6, 4, 7},
+    {11, 15, 5, 0, 1, 9, 8, 6, 14, 10, 2, 12, 3, 4, 7, 13}};
+constexpr uint32_t blake3_chunk_start = 1;
+constexpr uint32_t blake3_chunk_end = 2;
+constexpr uint32_t blake3_parent = 4;
+constexpr uint32_t blake3_root = 8;
+
+constexpr void blake3_g(uint32_t s[16], int a, int b, int c, int d, uint32_t x, uint32_t y) {
+  s[a] = s[a] + s[b] + x;
+  s[d] = rotr32(s[d] ^ s[a], 16);
+  s[c] = s[c] + s[d];
+  s[b] = rotr32(s[b] ^ s[c], 12);
+  s[a] = s[a] + s[b] + y;
+  s[d] = rotr32(s[d] ^ s[a], 8);
+  s[c] = s[c] + s[d];
+  s[b] = rotr32(s[b] ^ s[c], 7);
+}
+
+// blake3_compress new chaining value (first 8 words of the output block) into cv
+constexpr void blake3_compress(uint32_t cv[8], const uint32_t m[16], uint32_t block_len, uint64_t counter,
+                               uint32_t flags) {
+  uint32_t s[16] = {cv[0],
+                    cv[1],
+                    cv[2],
+                    cv[3],
+                    cv[4],
+                    cv[5],
+                    cv[6],
+                    cv[7],
+                    blake3_iv[0],
+                    blake3_iv[1],
+                    blake3_iv[2],
+                    blake3_iv[3],
+                    static_cast<uint32_t>(counter),
+                    static_cast<uint32_t>(counter >> 32),
+                    block_len,
+                    flags};
+  for (const auto &r : blake3_schedule) {
+    blake3_g(s, 0, 4, 8, 12, m[r[0]], m[r[1]]);
+    blake3_g(s, 1, 5, 9, 13, m[r[2]], m[r[3]]);
+    blake3_g(s, 2, 6, 10, 14, m[r[4]], m[r[5]]);
+    blake3_g(s, 3, 7, 11, 15, m[r[6]], m[r[7]]);
+    blake3_g(s, 0, 5, 10, 15, m[r[8]], m[r[9]]);
+    blake3_g(s, 1, 6, 11, 12, m[r[10]], m[r[11]]);
+    blake3_g(s, 2, 7, 8, 13, m[r[12]], m[r[13]]);
+    blake3_g(s, 3, 4, 9, 14, m[r[14]], m[r[15]]);
+  }
+  for (int i = 0; i < 8; i++) {
+    cv[i] = s[i] ^ s[i + 8];
+  }
+}
+
+// blake3_chunk chaining value of the chunk at data[offset, offset+len), extra flags go on the last block
+constexpr void blake3_chunk(ByteView data, size_t offset, size_t len, uint64_t counter, uint32_t last_flags,
+                            uint32_t cv[8]) {
+  for (int i = 0; i < 8; i++) {
+    cv[i] = blake3_iv[i];
+  }
+  const size_t blocks = len == 0 ? 1 : (len + BLAKE3_BLOCK_LEN - 1) / BLAKE3_BLOCK_LEN;
+  for (size_t b = 0; b < blocks; b++) {
+    uint32_t m[16]{};
+    const auto start = b * BLAKE3_BLOCK_LEN;
+    const auto n = (len - start) < BLAKE3_BLOCK_LEN ? len - start : size_t{BLAKE3_BLOCK_LEN};
+    for (size_t k = 0; k < n; k++) {
+      m[k / 4] |= static_cast<uint32_t>(data[offset + start + k]) << ((k % 4) * 8);
+    }
+    uint32_t flags = b == 0 ? blake3_chunk_start : 0;
+    if (b + 1 == blocks) {
+      flags |= blake3_chunk_end | last_flags;
+    }
+    blake3_compress(cv, m, static_cast<uint32_t>(n), counter, flags);
+  }
+}
+
+constexpr void blake3_parent_cv(const uint32_t left[8], const uint32_t right[8], uint32_t flags, uint32_t out[8]) {
+  uint32_t m[16]{};
+  for (int i = 0; i < 8; i++) {
+    m[i] = left[i];
+    m[i + 8] = right[i];
+    out[i] = blake3_iv[i];
+  }
+  blake3_compress(out, m, BLAKE3_BLOCK_LEN, 0, blake3_parent | flags);
+}
+
+// same lazy cv stack as the reference implementation: the last chunk is finalized with ROOT
+// when it is the only one, otherwise it is folded into the stack from the top down
+constexpr Digest<32> blake3(ByteView data) {
+  uint32_t stack[BLAKE3_MAX_DEPTH + 1][8]{};
+  size_t depth = 0;
+  const size_t chunks = data.size == 0 ? 1 : (data.size + BLAKE3_CHUNK_LEN - 1) / BLAKE3_CHUNK_LEN;
+  for (size_t c = 0; c + 1 < chunks; c++) {
+    uint32_t cv[8]{};
+    blake3_chunk(data, c * BLAKE3_CHUNK_LEN, BLAKE3_CHUNK_LEN, c, 0, cv);
+    for (auto total = c + 1; (total & 1) == 0; total >>= 1) {
+      depth--;
+      blake3_parent_cv(stack[depth], cv, 0, cv);
+    }
+    for (int i = 0; i < 8; i++) {
+      stack[depth][i] = cv[i];
+    }
+    depth++;
+  }
+  const auto last = (chunks - 1) * BLAKE3_CHUNK_LEN;
+  uint32_t cv[8]{};
+  blake3_chunk(data, last, data.size - last, chunks - 1, depth == 0 ? blake3_root : 0, cv);
+  while (depth > 0) {
+    depth--;
+    blake3_parent_cv(stack[depth], cv, depth == 0 ? blake3_root : 0, cv);
+  }
+  Digest<32> d;
+  for (int k = 0; k < 8; k++) {
+    for (int j = 0; j < 4; j++) {
+      d.bytes[k * 4 + j] = static_cast<uint8_t>(cv[k] >> (j * 8));
+    }
+  }
+  return d;
+}
+} // namespace consthash_internal
+
+namespace sha256 {
+constexpr Digest ConstexprHash(std::string_view data) {
+  return consthash_internal::sha256(consthash_internal::ByteView{data.data(), nullptr, data.size()});
+}
+constexpr Digest ConstexprHash(const uint8_t *data, size_t len) {
+  return consthash_internal::sha256(consthash_internal::ByteView{nullptr, data, len});
+}
+} // namespace sha256
+
+namespace blake3 {
+// 32 byte default-mode BLAKE3 (no key, no extended output)
+constexpr bela::hash::Digest<BLAKE3_OUT_LEN> ConstexprHash(std::string_view data) {
+  return consthash_internal::blake3(consthash_internal::ByteView{data.data(), nullptr, data.size()});
+}
+constexpr bela::hash::Digest<BLAKE3_OUT_LEN> ConstexprHash(const uint8_t *data, size_t len) {
+  return consthash_internal::blake3(consthash_internal::ByteView{nullptr, data, len});
+}
+} // namespace blake3
+} // namespace bela::hash
+
+#endif
@@ -0,0 +1,89 @@
+// bela::Cord chunked string builder, appends never move text that is already stored
+#ifndef BELA_CORD_HPP
+#define BELA_CORD_HPP
+#include <vector>
+#include "strcat.hpp"
+
+namespace bela {
+// Cord keeps text as a list of chunks. Appended pieces are copied into the tail chunk while it has room, otherwise a
+// new chunk is started (chunk capacity doubles up to max_chunk), so building a multi-MB report copies every character
+// once instead of once per std::wstring reallocation. Appending an owned std::wstring moves the buffer in as a chunk.
+// Chunks can be written one by one (bela::io::WriteText has Cord overloads) or flattened into a single string.
+//
+//   bela::Cord c;
+//   for (const auto &e : entries) {
+//     c.Append(e.digest.Hex(), L" ", e.size, L" ", e.path, L"\n");
+//   }
+//   bela::io::WriteText(c, L"C:\\deploy.manifest", ec);
+class Cord {
+public:
+  static constexpr size_t min_chunk = 1024;
+  static constexpr size_t max_chunk = 64 * 1024;
+  // owned buffers shorter than this are copied, a chunk per tiny string would cost more than the copy
+  static constexpr size_t min_owned = 512;
+  Cord() = default;
+  explicit Cord(std::wstring &&s) { Append(std::move(s)); }
+  explicit Cord(std::wstring_view sv) { Append(sv); }
+  Cord(const Cord &) = default;
+  Cord &operator=(const Cord &) = default;
+  Cord(Cord &&other) noexcept { MoveFrom(other); }
+  Cord &operator=(Cord &&other) noexcept {
+    if (this != &other) {
+      MoveFrom(other);
+    }
+    return *this;
+  }
+
+  Cord &Append(const AlphaNum &a) { return AppendPieces({a.Piece()}); }
+  template <typename... AV> Cord &Append(const AlphaNum &a, const AlphaNum &b, const AV &...args) {
+    return AppendPieces({a.Piece(), b.Piece(), static_cast<const AlphaNum &>(args).Piece()...});
+  }
+  // Append take ownership of an rvalue std::wstring, its buffer becomes a chunk without copying
+  template <typename S, typename = std::enable_if_t<std::is_same_v<S, std::wstring>>> Cord &Append(S &&s) {
+    return AppendOwned(std::move(s));
+  }
+  Cord &Append(const Cord &other);
+  Cord &Append(Cord &&other);
+
+  size_t size() const { return size_; }
+  bool empty() const { return size_ == 0; }
+  size_t ChunkCount() const { return chunks.size(); }
+  // ForEachChunk call fn(std::wstring_view) for every chunk in order, chunks are never empty
+  template <typename Fn> void ForEachChunk(Fn &&fn) const {
+    for (const auto &c : chunks) {
+      fn(std::wstring_view(c));
+    }
+  }
+  // Flatten merge the chunks into one, the view is valid until the next modification
+  std::wstring_view Flatten();
+  // str copy of the whole text, the cord is unchanged
+  std::wstring str() const;
+  void clear() {
+    chunks.clear();
+    size_ = 0;
+    next_chunk = min_chunk;
+  }
+
+private:
+  Cord &AppendPieces(std::initializer_list<std::wstring_view> pieces);
+  Cord &AppendOwned(std::wstring &&s);
+  void MoveFrom(Cord &other) {
+    chunks = std::move(other.chunks);
+    size_ = other.size_;
+    next_chunk = other.next_chunk;
+    other.clear();
+  }
+  std::vector<std::wstring> chunks;
+  size_t size_{0};
+  size_t next_chunk{min_chunk};
+};
+
+// StrAppend into a Cord, same as dest->Append(...)
+template <typename... AV> inline void StrAppend(Cord *dest, const AV &...args) {
+  if constexpr (sizeof...(args) != 0) {
+    dest->Append(args...);
+  }
+}
+} // namespace bela
+
+#endif
@@ -138,6 +138,23 @@ inline constexpr int __DOUBLE_POW5_BITCOUNT = 121;
   return __shiftright128(__lo, __hi, static_cast<unsigned char>(__dist));
 }
 
+#elif defined(__SIZEOF_INT128__) // GCC/Clang 64-bit targets
+
+[[nodiscard]] inline uint64_t __ryu_umul128(const uint64_t __a,
+                                            const uint64_t __b,
+                                            uint64_t *const __productHi) {
+  const unsigned __int128 __p = static_cast<unsigned __int128>(__a) * __b;
+  *__productHi = static_cast<uint64_t>(__p >> 64);
+  return static_cast<uint64_t>(__p);
+}
+
+[[nodiscard]] inline uint64_t __ryu_shiftright128(const uint64_t __lo,
+                                                  const uint64_t __hi,
+                                                  const uint32_t __dist) {
+  assert(__dist > 0 && __dist < 64);
+  return (__hi << (64 - __dist)) | (__lo >> __dist);
+}
+
 #else // ^^^ intrinsics available ^^^ / vvv intrinsics unavailable vvv
 
 [[nodiscard]] BELA_BASE_INTERNAL_FORCEINLINE uint64_t __ryu_umul128(
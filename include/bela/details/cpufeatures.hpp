@@ -0,0 +1,95 @@
+// Runtime x86 cpu feature detection shared by bela and belahash
+#ifndef BELA_DETAILS_CPUFEATURES_HPP
+#define BELA_DETAILS_CPUFEATURES_HPP
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define BELA_CPU_X86 1
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#endif
+
+namespace bela::cpu_internal {
+// runtime cpu features, detected once. like blake3_dispatch.c get_cpu_features
+struct CpuFeatures {
+  bool sse2{false};
+  bool ssse3{false};
+  bool sse41{false};
+  bool sse42{false};
+  bool avx{false};
+  bool avx2{false};
+  bool bmi2{false};
+  bool sha{false};
+  bool avx512f{false};
+  bool avx512vl{false};
+  bool avx512bw{false};
+};
+
+#if defined(BELA_CPU_X86)
+inline void cpuidex(uint32_t out[4], uint32_t id, uint32_t sid) {
+#if defined(_MSC_VER)
+  __cpuidex(reinterpret_cast<int *>(out), static_cast<int>(id), static_cast<int>(sid));
+#else
+  __cpuid_count(id, sid, out[0], out[1], out[2], out[3]);
+#endif
+}
+
+inline uint64_t xgetbv() {
+#if defined(_MSC_VER)
+  return _xgetbv(0);
+#else
+  uint32_t eax = 0, edx = 0;
+  __asm__ __volatile__("xgetbv\n" : "=a"(eax), "=d"(edx) : "c"(0));
+  return (static_cast<uint64_t>(edx) << 32) | eax;
+#endif
+}
+
+inline CpuFeatures DetectCpuFeatures() {
+  CpuFeatures f;
+  uint32_t regs[4] = {0};
+  cpuidex(regs, 0, 0);
+  const auto max_id = regs[0];
+  cpuidex(regs, 1, 0);
+  const auto ecx1 = regs[2];
+  const auto edx1 = regs[3];
+  f.sse2 = (edx1 & (1U << 26)) != 0;
+  f.ssse3 = (ecx1 & (1U << 9)) != 0;
+  f.sse41 = (ecx1 & (1U << 19)) != 0;
+  f.sse42 = (ecx1 & (1U << 20)) != 0;
+  uint32_t ebx7 = 0;
+  if (max_id >= 7) {
+    cpuidex(regs, 7, 0);
+    ebx7 = regs[1];
+  }
+  f.bmi2 = (ebx7 & (1U << 8)) != 0;
+  f.sha = (ebx7 & (1U << 29)) != 0;
+  if ((ecx1 & (1U << 27)) == 0) { // OSXSAVE
+    return f;
+  }
+  const auto mask = xgetbv();
+  if ((mask & 6) != 6) { // SSE and AVX states
+    return f;
+  }
+  f.avx = (ecx1 & (1U << 28)) != 0;
+  f.avx2 = (ebx7 & (1U << 5)) != 0;
+  if ((mask & 224) == 224) { // Opmask, ZMM_Hi256, Hi16_Zmm
+    f.avx512f = (ebx7 & (1U << 16)) != 0;
+    f.avx512bw = (ebx7 & (1U << 30)) != 0;
+    f.avx512vl = (ebx7 & (1U << 31)) != 0;
+  }
+  return f;
+}
+#else
+inline CpuFeatures DetectCpuFeatures() { return CpuFeatures{}; }
+#endif
+
+inline const CpuFeatures &GetCpuFeatures() {
+  static const CpuFeatures features = DetectCpuFeatures();
+  return features;
+}
+} // namespace bela::cpu_internal
+
+#endif
@@ -0,0 +1,142 @@
+// Integer to decimal text shared by StringCat, StrFormat and FastIntToBuffer
+// Algorithm from jeaiii/itoa (https://github.com/jeaiii/itoa), MIT License, Copyright (c) 2022 James Edward Anhalt III
+#ifndef BELA_DETAILS_ITOA_HPP
+#define BELA_DETAILS_ITOA_HPP
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <type_traits>
+#include "../bits.hpp"
+
+namespace bela::numbers_internal {
+// kDigitPairs "00" to "99" in the output character type, one two character copy per pair
+template <typename CharT> struct DigitPairTable {
+  constexpr DigitPairTable() {
+    for (uint32_t i = 0; i < 100; i++) {
+      pairs[i * 2] = static_cast<CharT>('0' + i / 10);
+      pairs[i * 2 + 1] = static_cast<CharT>('0' + i % 10);
+    }
+  }
+  CharT pairs[200]{};
+};
+template <typename CharT> inline constexpr DigitPairTable<CharT> kDigitPairs{};
+
+template <typename CharT> constexpr void WritePair(CharT *p, uint32_t pair) {
+#if defined(__cpp_lib_is_constant_evaluated)
+  if (!std::is_constant_evaluated()) {
+    std::memcpy(p, kDigitPairs<CharT>.pairs + pair * 2, sizeof(CharT) * 2);
+    return;
+  }
+#endif
+  p[0] = kDigitPairs<CharT>.pairs[pair * 2];
+  p[1] = kDigitPairs<CharT>.pairs[pair * 2 + 1];
+}
+
+constexpr uint64_t Pow10(uint32_t n) { return n == 0 ? 1 : 10 * Pow10(n - 1); }
+
+// For u < 10^(N+2), t = u * 2^32 / 10^N as 32.32 fixed point: the integer part is the leading one or two digits and
+// every multiplication of the fraction by 100 moves the next pair into the integer part. The multiplier is rounded up
+// (with a few more bits of precision for large N) so the fraction never falls below the true value.
+template <uint32_t N> constexpr uint64_t LeadingFixed(uint32_t u) {
+  constexpr uint32_t shift = N / 5 * N * 53 / 16;
+  constexpr uint64_t magic = (uint64_t{1} << (32 + shift)) / Pow10(N) + 1 + N / 6 - N / 8;
+  return ((magic * u) >> shift) + N / 6 * 4;
+}
+
+// WritePairs the next Count pairs of the fraction, unrolled at compile time
+template <uint32_t Count, typename CharT> constexpr CharT *WritePairs(uint64_t t, CharT *p) {
+  if constexpr (Count == 0) {
+    return p;
+  } else {
+    t = uint64_t{100} * static_cast<uint32_t>(t);
+    WritePair(p, static_cast<uint32_t>(t >> 32));
+    return WritePairs<Count - 1>(t, p + 2);
+  }
+}
+
+// WriteFixed write exactly Pairs*2 (Odd: one less) digits of u, u < 10^(Pairs*2) and leading zeros are kept
+template <uint32_t Pairs, bool Odd, typename CharT> constexpr CharT *WriteFixed(uint32_t u, CharT *p) {
+  auto t = LeadingFixed<Pairs * 2 - 2>(u);
+  if constexpr (Odd) {
+    *p++ = static_cast<CharT>('0' + (t >> 32));
+  } else {
+    WritePair(p, static_cast<uint32_t>(t >> 32));
+    p += 2;
+  }
+  return WritePairs<Pairs - 1>(t, p);
+}
+
+// WriteDecimal digits of u without terminator, returns one past the last digit. The digit count is chosen by a
+// fixed comparison tree and each length is straight-line multiply code, there is no divide and no per-digit branch.
+template <typename CharT> constexpr CharT *WriteDecimal(uint32_t u, CharT *p) {
+  if (u < 100) {
+    if (u < 10) {
+      *p = static_cast<CharT>('0' + u);
+      return p + 1;
+    }
+    WritePair(p, u);
+    return p + 2;
+  }
+  if (u < 1000000) {
+    if (u < 10000) {
+      return u < 1000 ? WriteFixed<2, true>(u, p) : WriteFixed<2, false>(u, p);
+    }
+    return u < 100000 ? WriteFixed<3, true>(u, p) : WriteFixed<3, false>(u, p);
+  }
+  if (u < 100000000) {
+    return u < 10000000 ? WriteFixed<4, true>(u, p) : WriteFixed<4, false>(u, p);
+  }
+  return u < 1000000000 ? WriteFixed<5, true>(u, p) : WriteFixed<5, false>(u, p);
+}
+
+template <typename CharT> constexpr CharT *WriteDecimal(uint64_t u, CharT *p) {
+  if (static_cast<uint32_t>(u) == u) {
+    return WriteDecimal(static_cast<uint32_t>(u), p);
+  }
+  // at least ten digits: the top part and then groups of eight
+  auto top = u / 100000000;
+  auto low8 = static_cast<uint32_t>(u - top * 100000000);
+  if (static_cast<uint32_t>(top) == top) {
+    p = WriteDecimal(static_cast<uint32_t>(top), p);
+  } else {
+    auto top2 = static_cast<uint32_t>(top / 100000000); // at most 1844
+    p = WriteDecimal(top2, p);
+    p = WriteFixed<4, false>(static_cast<uint32_t>(top - uint64_t{top2} * 100000000), p);
+  }
+  return WriteFixed<4, false>(low8, p);
+}
+
+// WriteInteger any integer type up to 64 bits, negative values get a leading '-'
+template <typename CharT, typename Int> constexpr CharT *WriteInteger(Int v, CharT *p) {
+  static_assert(std::is_integral_v<Int> && sizeof(Int) <= 8, "WriteInteger works only with 64-bit-or-less integers");
+  using U = std::conditional_t<(sizeof(Int) > 4), uint64_t, uint32_t>;
+  auto u = static_cast<U>(v);
+  if constexpr (std::is_signed_v<Int>) {
+    if (v < 0) {
+      *p++ = static_cast<CharT>('-');
+      u = 0 - u;
+    }
+  }
+  return WriteDecimal(u, p);
+}
+
+// DigitCount decimal digits of u, 1 for 0. bits * 1233 / 4096 is bits * log10(2) rounded down, that is the digit
+// count or one more, a single comparison with a power of ten settles it.
+inline uint32_t DigitCount(uint64_t u) {
+  // clang-format off
+  constexpr uint64_t kPow10[20] = {
+      1ULL, 10ULL, 100ULL, 1000ULL, 10000ULL, 100000ULL, 1000000ULL, 10000000ULL, 100000000ULL, 1000000000ULL,
+      10000000000ULL, 100000000000ULL, 1000000000000ULL, 10000000000000ULL, 100000000000000ULL,
+      1000000000000000ULL, 10000000000000000ULL, 100000000000000000ULL, 1000000000000000000ULL,
+      10000000000000000000ULL};
+  // clang-format on
+  u |= 1;
+  auto t = static_cast<uint32_t>(64 - bela::base_internal::CountLeadingZeros64(u)) * 1233 >> 12;
+  return t + 1 - static_cast<uint32_t>(u < kPow10[t]);
+}
+
+// the longest text is "-9223372036854775808"
+constexpr const size_t kMaxIntegerChars = 20;
+} // namespace bela::numbers_internal
+
+#endif
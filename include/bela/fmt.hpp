@@ -6,8 +6,11 @@
 #include <cstdlib>
 #include <cstddef>
 #include <cstring>
+#include <algorithm>
 #include <string>
 #include <string_view>
+#include <type_traits>
+#include <utility>
 
 #if defined(_MSC_VER)
 // Define ssize_t inside of our namespace.
@@ -27,6 +30,78 @@ typedef long __bela__ssize_t;
 namespace bela {
 using ssize_t = __bela__ssize_t;
 
+// basic_format_buffer growable format sink, see FormatBuffer
+template <typename CharT> class basic_format_buffer {
+public:
+  using value_type = CharT;
+  basic_format_buffer(const basic_format_buffer &) = delete;
+  basic_format_buffer &operator=(const basic_format_buffer &) = delete;
+  ~basic_format_buffer() {
+    if (data_ != inline_) {
+      delete[] data_;
+    }
+  }
+  void push_back(CharT ch) {
+    if (len_ == cap_) {
+      grow(len_ + 1);
+    }
+    data_[len_++] = ch;
+  }
+  basic_format_buffer &append(const CharT *str, size_t n) {
+    if (n == 0) {
+      return *this; // an empty string_view may carry a null pointer
+    }
+    if (cap_ - len_ < n) {
+      grow(len_ + n);
+    }
+    memcpy(data_ + len_, str, n * sizeof(CharT));
+    len_ += n;
+    return *this;
+  }
+  basic_format_buffer &append(std::basic_string_view<CharT> sv) { return append(sv.data(), sv.size()); }
+  const CharT *data() const { return data_; }
+  size_t size() const { return len_; }
+  size_t capacity() const { return cap_; }
+  bool empty() const { return len_ == 0; }
+  // spilled the text no longer fits the inline storage and lives on the heap
+  bool spilled() const { return data_ != inline_; }
+  void clear() { len_ = 0; }
+  std::basic_string_view<CharT> view() const { return std::basic_string_view<CharT>(data_, len_); }
+  std::basic_string<CharT> str() const { return std::basic_string<CharT>(data_, len_); }
+
+protected:
+  basic_format_buffer(CharT *storage, size_t n) : data_(storage), inline_(storage), cap_(n) {}
+
+private:
+  void grow(size_t n) {
+    auto newcap = (std::max)(cap_ * 2, n);
+    auto p = new CharT[newcap];
+    memcpy(p, data_, len_ * sizeof(CharT));
+    if (data_ != inline_) {
+      delete[] data_;
+    }
+    data_ = p;
+    cap_ = newcap;
+  }
+  CharT *data_;
+  CharT *inline_;
+  size_t len_{0};
+  size_t cap_;
+};
+
+// FormatBuffer formats into N inline characters and moves to the heap only when a message is longer, a stack
+// FormatBuffer saves the allocation of the std::wstring returned by StrFormat:
+//   bela::FormatBuffer<256> buf;
+//   bela::StrAppendFormat(&buf, L"%s: %d\n", name, n);
+//   WriteLog(buf.view());
+template <size_t N = 256, typename CharT = wchar_t> class FormatBuffer : public basic_format_buffer<CharT> {
+public:
+  FormatBuffer() : basic_format_buffer<CharT>(storage, N) {}
+
+private:
+  CharT storage[N];
+};
+
 namespace format_internal {
 enum class ArgType {
   BOOLEAN,
@@ -99,7 +174,7 @@ struct FormatArg {
     integer.width = sizeof(long long);
   }
 
-  // %f
+  // %f %e %g, %v shortest round-trip
   FormatArg(float f) : at(ArgType::FLOAT) {
     floating.d = f;
     floating.width = sizeof(float);
@@ -245,10 +320,88 @@ struct FormatArg {
   const ArgType at;
 };
 
+// FormatOp one decoded piece of a format string, literal text or a '%' directive
+struct FormatOp {
+  wchar_t verb{0}; // 0 literal fmt[offset, offset+len), otherwise directive character
+  wchar_t pc{' '}; // pad character
+  bool left{false};
+  bool has_frac{false}; // '.' precision present, %f %e %g default to 6 otherwise
+  uint32_t width{0};
+  uint32_t frac_width{0};
+  uint32_t offset{0};
+  uint32_t len{0};
+};
+
+// directives that consume an argument, others (%%) write the character itself
+constexpr bool IsArgVerb(wchar_t verb) {
+  switch (verb) {
+  case 'b':
+  case 'c':
+  case 's':
+  case 'd':
+  case 'o':
+  case 'x':
+  case 'X':
+  case 'U':
+  case 'f':
+  case 'e':
+  case 'g':
+  case 'v':
+  case 'a':
+  case 'p':
+    return true;
+  default:
+    break;
+  }
+  return false;
+}
+
+// argument types a directive can print, anything else is silently skipped by StrFormat
+constexpr bool VerbAccepts(wchar_t verb, ArgType at) {
+  switch (verb) {
+  case 'b':
+    return at == ArgType::BOOLEAN || at == ArgType::CHARACTER || at == ArgType::INTEGER || at == ArgType::UINTEGER;
+  case 'c':
+  case 'U':
+    return at == ArgType::CHARACTER || at == ArgType::INTEGER || at == ArgType::UINTEGER;
+  case 's':
+    return at == ArgType::STRING || at == ArgType::USTRING;
+  case 'd':
+  case 'o':
+  case 'x':
+  case 'X':
+    return at != ArgType::STRING && at != ArgType::USTRING;
+  case 'f':
+  case 'e':
+  case 'g':
+  case 'v':
+  case 'a':
+    return at == ArgType::FLOAT;
+  case 'p':
+    return at == ArgType::POINTER;
+  default:
+    break;
+  }
+  return false;
+}
+
 // Format function
 ssize_t StrFormatInternal(wchar_t *buf, size_t sz, const wchar_t *fmt, const FormatArg *args, size_t max_args);
 std::wstring StrFormatInternal(const wchar_t *fmt, const FormatArg *args, size_t max_args);
 size_t StrAppendFormatInternal(std::wstring *buf, const wchar_t *fmt, const FormatArg *args, size_t max_args);
+// Precompiled format, ops already checked against args
+ssize_t StrFormatInternal(wchar_t *buf, size_t sz, const wchar_t *fmt, const FormatOp *ops, size_t nops,
+                          const FormatArg *args);
+std::wstring StrFormatInternal(const wchar_t *fmt, const FormatOp *ops, size_t nops, const FormatArg *args);
+size_t StrAppendFormatInternal(std::wstring *buf, const wchar_t *fmt, const FormatOp *ops, size_t nops,
+                               const FormatArg *args);
+// FormatBuffer sinks
+size_t StrAppendFormatInternal(basic_format_buffer<wchar_t> *buf, const wchar_t *fmt, const FormatArg *args,
+                               size_t max_args);
+size_t StrAppendFormatInternal(basic_format_buffer<wchar_t> *buf, const wchar_t *fmt, const FormatOp *ops, size_t nops,
+                               const FormatArg *args);
+// AppendFormatChecked false only when fmt and args don't match, an empty result is not an error
+bool AppendFormatChecked(basic_format_buffer<wchar_t> *buf, const wchar_t *fmt, const FormatArg *args, size_t max_args);
 } // namespace format_internal
 
 size_t StrAppendFormat(std::wstring *buf, const wchar_t *fmt);
@@ -257,6 +410,13 @@ template <typename... Args> size_t StrAppendFormat(std::wstring *buf, const wcha
   return format_internal::StrAppendFormatInternal(buf, fmt, arg_array, sizeof...(args));
 }
 
+size_t StrAppendFormat(basic_format_buffer<wchar_t> *buf, const wchar_t *fmt);
+template <typename... Args>
+size_t StrAppendFormat(basic_format_buffer<wchar_t> *buf, const wchar_t *fmt, Args... args) {
+  const format_internal::FormatArg arg_array[] = {args...};
+  return format_internal::StrAppendFormatInternal(buf, fmt, arg_array, sizeof...(args));
+}
+
 template <typename... Args> ssize_t StrFormat(wchar_t *buf, size_t N, const wchar_t *fmt, Args... args) {
   const format_internal::FormatArg arg_array[] = {args...};
   return format_internal::StrFormatInternal(buf, N, fmt, arg_array, sizeof...(args));
@@ -279,6 +439,206 @@ ssize_t StrFormat(wchar_t *buf, size_t N, const wchar_t *fmt);
 std::wstring StrFormat(const wchar_t *fmt);
 template <size_t N> inline ssize_t StrFormat(wchar_t (&buf)[N], const wchar_t *fmt) { return StrFormat(buf, N, fmt); }
 
+#if defined(__cpp_nontype_template_args) && __cpp_nontype_template_args >= 201911L
+#define BELA_HAVE_COMPILED_FORMAT 1
+namespace format_internal {
+// ArgTypeOf the ArgType FormatArg records for T, same overload set as the FormatArg constructors
+namespace arg_type {
+template <ArgType A> using tag = std::integral_constant<ArgType, A>;
+tag<ArgType::BOOLEAN> Of(bool);
+tag<ArgType::CHARACTER> Of(char);
+tag<ArgType::CHARACTER> Of(unsigned char);
+tag<ArgType::CHARACTER> Of(wchar_t);
+tag<ArgType::CHARACTER> Of(char16_t);
+tag<ArgType::CHARACTER> Of(char32_t);
+tag<ArgType::INTEGER> Of(signed short);
+tag<ArgType::UINTEGER> Of(unsigned short);
+tag<ArgType::INTEGER> Of(signed int);
+tag<ArgType::UINTEGER> Of(unsigned int);
+tag<ArgType::INTEGER> Of(signed long);
+tag<ArgType::UINTEGER> Of(unsigned long);
+tag<ArgType::INTEGER> Of(signed long long);
+tag<ArgType::UINTEGER> Of(unsigned long long);
+tag<ArgType::FLOAT> Of(float);
+tag<ArgType::FLOAT> Of(double);
+tag<ArgType::STRING> Of(const wchar_t *);
+tag<ArgType::STRING> Of(wchar_t *);
+template <typename Allocator>
+tag<ArgType::STRING> Of(const std::basic_string<wchar_t, std::char_traits<wchar_t>, Allocator> &);
+tag<ArgType::STRING> Of(std::wstring_view);
+tag<ArgType::STRING> Of(const char16_t *);
+tag<ArgType::STRING> Of(char16_t *);
+template <typename Allocator>
+tag<ArgType::STRING> Of(const std::basic_string<char16_t, std::char_traits<char16_t>, Allocator> &);
+tag<ArgType::STRING> Of(std::u16string_view);
+tag<ArgType::USTRING> Of(const char *);
+tag<ArgType::USTRING> Of(char *);
+template <typename Allocator>
+tag<ArgType::USTRING> Of(const std::basic_string<char, std::char_traits<char>, Allocator> &);
+tag<ArgType::USTRING> Of(std::string_view);
+template <class T> tag<ArgType::POINTER> Of(T *);
+} // namespace arg_type
+template <typename T> constexpr ArgType ArgTypeOf = decltype(arg_type::Of(std::declval<T>()))::value;
+
+// FormatLiteral format string as a template argument
+template <size_t N> struct FormatLiteral {
+  constexpr FormatLiteral(const wchar_t (&s)[N]) {
+    for (size_t i = 0; i < N; i++) {
+      data[i] = s[i];
+    }
+  }
+  wchar_t data[N]{};
+};
+
+constexpr size_t bad_format = static_cast<size_t>(-1);
+// ParseFormat decode the directives the way StrFormatInternal does, returns the number of ops (ops == nullptr only
+// counts) or bad_format for a dangling '%' or an unknown directive
+constexpr size_t ParseFormat(const wchar_t *fmt, size_t len, FormatOp *ops) {
+  size_t n = 0;
+  auto emit = [&](const FormatOp &op) {
+    if (ops != nullptr) {
+      ops[n] = op;
+    }
+    n++;
+  };
+  size_t i = 0;
+  while (i < len) {
+    auto pos = i;
+    while (pos < len && fmt[pos] != '%') {
+      pos++;
+    }
+    if (pos != i) {
+      emit(FormatOp{0, ' ', false, false, 0, 0, static_cast<uint32_t>(i), static_cast<uint32_t>(pos - i)});
+    }
+    if (pos == len) {
+      break;
+    }
+    i = pos + 1;
+    if (i >= len) {
+      return bad_format;
+    }
+    FormatOp op;
+    op.left = fmt[i] == '-';
+    if (op.left) {
+      i++;
+    } else {
+      op.pc = fmt[i] == '0' ? '0' : ' ';
+    }
+    while (i < len && fmt[i] >= '0' && fmt[i] <= '9') {
+      op.width = op.width * 10 + (fmt[i++] - '0');
+    }
+    if (i < len && fmt[i] == '.') {
+      op.has_frac = true;
+      i++;
+      while (i < len && fmt[i] >= '0' && fmt[i] <= '9') {
+        op.frac_width = op.frac_width * 10 + (fmt[i++] - '0');
+      }
+    }
+    if (i >= len) {
+      return bad_format;
+    }
+    if (fmt[i] == '%') {
+      emit(FormatOp{0, ' ', false, false, 0, 0, static_cast<uint32_t>(i), 1});
+    } else if (IsArgVerb(fmt[i])) {
+      op.verb = fmt[i];
+      emit(op);
+    } else {
+      return bad_format;
+    }
+    i++;
+  }
+  return n;
+}
+
+template <FormatLiteral S> struct CompiledFormat {
+  static constexpr size_t length = std::char_traits<wchar_t>::length(S.data);
+  static constexpr size_t size = ParseFormat(S.data, length, nullptr);
+  static_assert(size != bad_format, "bela::Format: dangling '%' or unknown directive");
+  struct Ops {
+    FormatOp ops[size == 0 || size == bad_format ? 1 : size]{};
+  };
+  static constexpr Ops decoded = [] {
+    Ops o;
+    if (size != bad_format) {
+      ParseFormat(S.data, length, o.ops);
+    }
+    return o;
+  }();
+  static constexpr size_t ArgCount() {
+    size_t n = 0;
+    for (size_t i = 0; size != bad_format && i < size; i++) {
+      n += decoded.ops[i].verb != 0 ? 1 : 0;
+    }
+    return n;
+  }
+  template <typename... Args> static constexpr bool ArgsMatch() {
+    if constexpr (sizeof...(Args) == 0) {
+      return true;
+    } else if (ArgCount() != sizeof...(Args)) {
+      return true; // reported by the count check
+    } else {
+      constexpr ArgType types[] = {ArgTypeOf<Args>...};
+      size_t ca = 0;
+      for (size_t i = 0; i < size; i++) {
+        if (decoded.ops[i].verb != 0 && !VerbAccepts(decoded.ops[i].verb, types[ca++])) {
+          return false;
+        }
+      }
+      return true;
+    }
+  }
+  template <typename... Args> static constexpr void Check() {
+    static_assert(ArgCount() == sizeof...(Args), "bela::Format: argument count doesn't match the directives");
+    static_assert(ArgsMatch<Args...>(), "bela::Format: argument type doesn't match its directive");
+  }
+};
+} // namespace format_internal
+
+// Format a format string parsed at compile time, the argument count and types are checked against the directives
+// and the runtime only replays the decoded ops:
+//   bela::FPrintF(stderr, bela::Format<L"%s: %d (%08x)\n">, name, n, n);
+template <format_internal::FormatLiteral S> struct FormatString {
+  using compiled = format_internal::CompiledFormat<S>;
+};
+template <format_internal::FormatLiteral S> inline constexpr FormatString<S> Format{};
+
+template <format_internal::FormatLiteral S, typename... Args>
+size_t StrAppendFormat(std::wstring *buf, FormatString<S>, Args... args) {
+  using F = format_internal::CompiledFormat<S>;
+  F::template Check<Args...>();
+  const format_internal::FormatArg arg_array[] = {args..., 0};
+  return format_internal::StrAppendFormatInternal(buf, S.data, F::decoded.ops, F::size, arg_array);
+}
+
+template <format_internal::FormatLiteral S, typename... Args>
+size_t StrAppendFormat(basic_format_buffer<wchar_t> *buf, FormatString<S>, Args... args) {
+  using F = format_internal::CompiledFormat<S>;
+  F::template Check<Args...>();
+  const format_internal::FormatArg arg_array[] = {args..., 0};
+  return format_internal::StrAppendFormatInternal(buf, S.data, F::decoded.ops, F::size, arg_array);
+}
+
+template <format_internal::FormatLiteral S, typename... Args>
+ssize_t StrFormat(wchar_t *buf, size_t N, FormatString<S>, Args... args) {
+  using F = format_internal::CompiledFormat<S>;
+  F::template Check<Args...>();
+  const format_internal::FormatArg arg_array[] = {args..., 0};
+  return format_internal::StrFormatInternal(buf, N, S.data, F::decoded.ops, F::size, arg_array);
+}
+
+template <size_t N, format_internal::FormatLiteral S, typename... Args>
+ssize_t StrFormat(wchar_t (&buf)[N], FormatString<S> f, Args... args) {
+  return StrFormat(buf, N, f, args...);
+}
+
+template <format_internal::FormatLiteral S, typename... Args> std::wstring StrFormat(FormatString<S>, Args... args) {
+  using F = format_internal::CompiledFormat<S>;
+  F::template Check<Args...>();
+  const format_internal::FormatArg arg_array[] = {args..., 0};
+  return format_internal::StrFormatInternal(S.data, F::decoded.ops, F::size, arg_array);
+}
+#endif
+
 } // namespace bela
 
 #endif
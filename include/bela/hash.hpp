@@ -1,8 +1,13 @@
 #ifndef BELA_HASH_HPP
 #define BELA_HASH_HPP
 #include <cstdint>
+#include <array>
+#include <functional>
 #include <string>
+#include <string_view>
+#include <variant>
 #include <cstddef>
+#include "span.hpp"
 
 #ifdef __cplusplus
 extern "C" {
@@ -43,29 +48,120 @@ void blake3_hasher_init_keyed(blake3_hasher *self, const uint8_t key[BLAKE3_KEY_
 void blake3_hasher_init_derive_key(blake3_hasher *self, const char *context);
 void blake3_hasher_init_derive_key_raw(blake3_hasher *self, const void *context, size_t context_len);
 void blake3_hasher_update(blake3_hasher *self, const void *input, size_t input_len);
+enum blake3_backend {
+  BLAKE3_BACKEND_AUTO = 0,
+  BLAKE3_BACKEND_PORTABLE,
+  BLAKE3_BACKEND_SSE2,
+  BLAKE3_BACKEND_SSE41,
+  BLAKE3_BACKEND_AVX2,
+  BLAKE3_BACKEND_AVX512,
+  BLAKE3_BACKEND_NEON,
+};
+int blake3_set_backend(int backend);
+int blake3_active_backend(void);
+typedef void (*blake3_join_fn)(void *ctx, void (*fn)(void *), void *left, void *right);
+void blake3_hasher_update_join(blake3_hasher *self, const void *input, size_t input_len, blake3_join_fn join,
+                               void *join_ctx);
 void blake3_hasher_finalize(const blake3_hasher *self, uint8_t *out, size_t out_len);
 void blake3_hasher_finalize_seek(const blake3_hasher *self, uint64_t seek, uint8_t *out, size_t out_len);
 #ifdef __cplusplus
 }
 #endif
 
+namespace bela {
+struct error_code;
+class ThreadPool;
+} // namespace bela
+
 namespace bela::hash {
+constexpr size_t HexEncodedLength(size_t len) { return len * 2; }
+constexpr size_t Base64EncodedLength(size_t len) { return (len + 2) / 3 * 4; }
+// EncodeHex write lowercase hex into out, no terminator, out holds HexEncodedLength(len) characters.
+// SSSE3/NEON nibble shuffle, 16 input bytes per step. returns characters written
+size_t EncodeHex(const uint8_t *b, size_t len, char *out);
+size_t EncodeHex(const uint8_t *b, size_t len, wchar_t *out);
+// EncodeBase64 RFC 4648 alphabet with '=' padding, out holds Base64EncodedLength(len) characters
+size_t EncodeBase64(const uint8_t *b, size_t len, char *out);
+size_t EncodeBase64(const uint8_t *b, size_t len, wchar_t *out);
+#if defined(__cpp_char8_t)
+inline size_t EncodeHex(const uint8_t *b, size_t len, char8_t *out) {
+  return EncodeHex(b, len, reinterpret_cast<char *>(out));
+}
+inline size_t EncodeBase64(const uint8_t *b, size_t len, char8_t *out) {
+  return EncodeBase64(b, len, reinterpret_cast<char *>(out));
+}
+#endif
+
 inline void HashEncode(const uint8_t *b, size_t len, std::wstring &hv) {
-  hv.resize(len * 2);
-  auto p = hv.data();
-  constexpr char hex[] = "0123456789abcdef";
-  for (size_t i = 0; i < len; i++) {
-    uint32_t val = b[i];
-    *p++ = hex[val >> 4];
-    *p++ = hex[val & 0xf];
-  }
+  hv.resize(HexEncodedLength(len));
+  EncodeHex(b, len, hv.data());
 }
 
+// Digest fixed size digest value: trivially copyable, constexpr comparable and hashable, so millions of
+// them can live in flat containers and hash maps without a string round-trip
+template <size_t N> struct Digest {
+  uint8_t bytes[N]{};
+  static constexpr size_t size() { return N; }
+  constexpr uint8_t *data() { return bytes; }
+  constexpr const uint8_t *data() const { return bytes; }
+  constexpr uint8_t *begin() { return bytes; }
+  constexpr const uint8_t *begin() const { return bytes; }
+  constexpr uint8_t *end() { return bytes + N; }
+  constexpr const uint8_t *end() const { return bytes + N; }
+  constexpr uint8_t &operator[](size_t i) { return bytes[i]; }
+  constexpr const uint8_t &operator[](size_t i) const { return bytes[i]; }
+  // digests are uniformly distributed, the leading 8 bytes are already a good hash value
+  constexpr size_t Hash() const {
+    uint64_t v = 0;
+    for (size_t i = 0; i < (N < 8 ? N : 8); i++) {
+      v |= static_cast<uint64_t>(bytes[i]) << (i * 8);
+    }
+    return static_cast<size_t>(v);
+  }
+  template <typename CharT> size_t EncodeHex(CharT *out) const { return bela::hash::EncodeHex(bytes, N, out); }
+  std::wstring Hex() const {
+    std::wstring s;
+    HashEncode(bytes, N, s);
+    return s;
+  }
+  friend constexpr bool operator==(const Digest &a, const Digest &b) {
+    for (size_t i = 0; i < N; i++) {
+      if (a.bytes[i] != b.bytes[i]) {
+        return false;
+      }
+    }
+    return true;
+  }
+  friend constexpr bool operator!=(const Digest &a, const Digest &b) { return !(a == b); }
+  friend constexpr bool operator<(const Digest &a, const Digest &b) {
+    for (size_t i = 0; i < N; i++) {
+      if (a.bytes[i] != b.bytes[i]) {
+        return a.bytes[i] < b.bytes[i];
+      }
+    }
+    return false;
+  }
+};
+
+// StateStatus RestoreState result, the hasher is left untouched unless Ok
+enum class StateStatus : uint32_t {
+  Ok,
+  NotState,           // no 'BHS' magic
+  UnsupportedVersion, // written by a newer state format
+  WrongAlgorithm,     // unknown algorithm, or the state of another algorithm
+  Corrupt             // truncated, trailing bytes or fields out of range
+};
+
 namespace sha256 {
 constexpr auto sha256_block_size = 64;
 constexpr auto sha256_hash_size = 32;
 constexpr auto sha224_hash_size = 28;
 enum class HashBits { SHA224 = 224, SHA256 = 256 };
+// Compression kernel, Auto picks the fastest supported by the CPU at runtime
+enum class Backend : uint32_t { Auto = 0, Portable, AVX2, SHANI };
+// SetBackend pin the kernel used by every sha256::Hasher. returns false if the CPU can't run it
+bool SetBackend(Backend b);
+Backend ActiveBackend();
 struct Hasher {
   uint32_t message[16];   /* 512-bit buffer for leftovers */
   uint64_t length;        /* number of processed bytes */
@@ -75,6 +171,9 @@ struct Hasher {
   void Initialize(HashBits hb_ = HashBits::SHA256);
   void Update(const void *input, size_t input_len);
   void Finalize(uint8_t *out, size_t out_len);
+  // SaveState checkpoint a running hash into a compact versioned blob, RestoreState resume from it
+  std::string SaveState() const;
+  StateStatus RestoreState(std::string_view state);
   std::wstring Finalize() {
     uint8_t buf[sha256_hash_size];
     std::wstring s;
@@ -88,6 +187,13 @@ struct Hasher {
     return s;
   }
 };
+
+using Digest = bela::hash::Digest<sha256_hash_size>;
+// HashMany hash many independent messages at once, interleaved across SIMD lanes (AVX2 8-way,
+// AVX-512 16-way) with a scalar fallback. SHA224 digests use the first 28 bytes of each Digest.
+// Hash min(messages.size(), digests.size()) messages
+void HashMany(bela::Span<const bela::Span<const uint8_t>> messages, bela::Span<Digest> digests,
+              HashBits hb = HashBits::SHA256);
 } // namespace sha256
 namespace sha512 {
 constexpr auto sha512_block_size = 128;
@@ -103,6 +209,8 @@ struct Hasher {
   void Initialize(HashBits hb_ = HashBits::SHA512);
   void Update(const void *input, size_t input_len);
   void Finalize(uint8_t *out, size_t out_len);
+  std::string SaveState() const;
+  StateStatus RestoreState(std::string_view state);
   std::wstring Finalize() {
     uint8_t buf[sha512_hash_size];
     std::wstring s;
@@ -139,6 +247,8 @@ struct Hasher {
   void Initialize(HashBits hb_ = HashBits::SHA3256);
   void Update(const void *input, size_t input_len);
   void Finalize(uint8_t *out, size_t out_len);
+  std::string SaveState() const;
+  StateStatus RestoreState(std::string_view state);
   std::wstring Finalize() {
     uint8_t buf[sha3_512_hash_size];
     std::wstring s;
@@ -165,9 +275,29 @@ struct Hasher {
     return s;
   }
 };
+
+using Digest = bela::hash::Digest<sha3_512_hash_size>;
+// HashMany hash many independent messages, four Keccak states permuted together with AVX2,
+// scalar fallback. Only the first hb/8 bytes of each Digest are written.
+// Hash min(messages.size(), digests.size()) messages
+void HashMany(bela::Span<const bela::Span<const uint8_t>> messages, bela::Span<Digest> digests,
+              HashBits hb = HashBits::SHA3256);
 } // namespace sha3
 
 namespace blake3 {
+// SIMD kernel used by every blake3::Hasher, Auto picks the fastest supported by the CPU at runtime
+enum class Backend : uint32_t {
+  Auto = BLAKE3_BACKEND_AUTO,
+  Portable = BLAKE3_BACKEND_PORTABLE,
+  SSE2 = BLAKE3_BACKEND_SSE2,
+  SSE41 = BLAKE3_BACKEND_SSE41,
+  AVX2 = BLAKE3_BACKEND_AVX2,
+  AVX512 = BLAKE3_BACKEND_AVX512,
+  NEON = BLAKE3_BACKEND_NEON
+};
+// SetBackend pin the kernel, returns false if it isn't compiled in or the CPU can't run it
+inline bool SetBackend(Backend b) { return blake3_set_backend(static_cast<int>(b)) != 0; }
+inline Backend ActiveBackend() { return static_cast<Backend>(blake3_active_backend()); }
 struct Hasher {
   blake3_hasher h;
   inline void Initialize() { //
@@ -183,12 +313,22 @@ struct Hasher {
     blake3_hasher_init_derive_key_raw(&h, context, len);
   }
   inline void Update(const void *input, size_t input_len) { blake3_hasher_update(&h, input, input_len); }
+  // UpdateParallel split large input into subtrees hashed on pool, digest is identical to Update.
+  // Worth it from a few MB, smaller inputs stay on the calling thread
+  void UpdateParallel(const void *input, size_t input_len, bela::ThreadPool &pool);
+#if defined(_WIN32)
+  // UpdateFile map file then UpdateParallel the whole content
+  bool UpdateFile(std::wstring_view file, bela::ThreadPool &pool, bela::error_code &ec);
+#endif
   inline void Finalize(uint8_t *out, size_t out_len) { //
     blake3_hasher_finalize(&h, out, out_len);
   }
   inline void FinalizeSeek(uint64_t seek, uint8_t *out, size_t out_len) { //
     blake3_hasher_finalize_seek(&h, seek, out, out_len);
   }
+  // SaveState checkpoint key, chunk state and cv stack, RestoreState resume from it
+  std::string SaveState() const;
+  StateStatus RestoreState(std::string_view state);
   std::wstring Finalize() {
     uint8_t buf[BLAKE3_OUT_LEN];
     Finalize(buf, sizeof(buf));
@@ -210,6 +350,8 @@ struct Hasher {
   void Initialize();
   void Update(const void *input, size_t input_len);
   void Finalize(uint8_t *out, size_t out_len);
+  std::string SaveState() const;
+  StateStatus RestoreState(std::string_view state);
   std::wstring Finalize() {
     uint8_t buf[sm3_digest_length];
     Finalize(buf, sizeof(buf));
@@ -220,6 +362,150 @@ struct Hasher {
 };
 } // namespace sm3
 
+// Algorithm identifies a digest so generic consumers (MultiHasher ...) can drive any hasher
+enum class Algorithm : uint32_t {
+  SHA224,
+  SHA256,
+  SHA384,
+  SHA512,
+  SHA3_224,
+  SHA3_256,
+  SHA3_384,
+  SHA3_512,
+  BLAKE3,
+  SM3,
+};
+constexpr size_t max_digest_length = 64;
+
+constexpr size_t DigestLength(Algorithm a) {
+  switch (a) {
+  case Algorithm::SHA224:
+    return sha256::sha224_hash_size;
+  case Algorithm::SHA256:
+    return sha256::sha256_hash_size;
+  case Algorithm::SHA384:
+    return sha512::sha384_hash_size;
+  case Algorithm::SHA512:
+    return sha512::sha512_hash_size;
+  case Algorithm::SHA3_224:
+    return sha3::sha3_224_hash_size;
+  case Algorithm::SHA3_256:
+    return sha3::sha3_256_hash_size;
+  case Algorithm::SHA3_384:
+    return sha3::sha3_384_hash_size;
+  case Algorithm::SHA3_512:
+    return sha3::sha3_512_hash_size;
+  case Algorithm::BLAKE3:
+    return BLAKE3_OUT_LEN;
+  case Algorithm::SM3:
+    return sm3::sm3_digest_length;
+  default:
+    break;
+  }
+  return 0;
+}
+
+constexpr std::wstring_view AlgorithmName(Algorithm a) {
+  switch (a) {
+  case Algorithm::SHA224:
+    return L"SHA224";
+  case Algorithm::SHA256:
+    return L"SHA256";
+  case Algorithm::SHA384:
+    return L"SHA384";
+  case Algorithm::SHA512:
+    return L"SHA512";
+  case Algorithm::SHA3_224:
+    return L"SHA3-224";
+  case Algorithm::SHA3_256:
+    return L"SHA3-256";
+  case Algorithm::SHA3_384:
+    return L"SHA3-384";
+  case Algorithm::SHA3_512:
+    return L"SHA3-512";
+  case Algorithm::BLAKE3:
+    return L"BLAKE3";
+  case Algorithm::SM3:
+    return L"SM3";
+  default:
+    break;
+  }
+  return L"";
+}
+
+// AnyHasher type-erased hasher, same Initialize/Update/Finalize shape as the algorithm Hasher
+class AnyHasher {
+public:
+  AnyHasher() = default;
+  explicit AnyHasher(Algorithm a) { Initialize(a); }
+  void Initialize(Algorithm a) {
+    alg = a;
+    switch (a) {
+    case Algorithm::SHA224:
+      h.emplace<sha256::Hasher>().Initialize(sha256::HashBits::SHA224);
+      break;
+    case Algorithm::SHA256:
+      h.emplace<sha256::Hasher>().Initialize(sha256::HashBits::SHA256);
+      break;
+    case Algorithm::SHA384:
+      h.emplace<sha512::Hasher>().Initialize(sha512::HashBits::SHA384);
+      break;
+    case Algorithm::SHA512:
+      h.emplace<sha512::Hasher>().Initialize(sha512::HashBits::SHA512);
+      break;
+    case Algorithm::SHA3_224:
+      h.emplace<sha3::Hasher>().Initialize(sha3::HashBits::SHA3224);
+      break;
+    case Algorithm::SHA3_256:
+      h.emplace<sha3::Hasher>().Initialize(sha3::HashBits::SHA3256);
+      break;
+    case Algorithm::SHA3_384:
+      h.emplace<sha3::Hasher>().Initialize(sha3::HashBits::SHA3384);
+      break;
+    case Algorithm::SHA3_512:
+      h.emplace<sha3::Hasher>().Initialize(sha3::HashBits::SHA3512);
+      break;
+    case Algorithm::BLAKE3:
+      h.emplace<blake3::Hasher>().Initialize();
+      break;
+    case Algorithm::SM3:
+      h.emplace<sm3::Hasher>().Initialize();
+      break;
+    }
+  }
+  void Update(const void *input, size_t input_len) {
+    std::visit([&](auto &x) { x.Update(input, input_len); }, h);
+  }
+  void Finalize(uint8_t *out, size_t out_len) {
+    std::visit([&](auto &x) { x.Finalize(out, out_len); }, h);
+  }
+  std::wstring Finalize() {
+    uint8_t buf[max_digest_length];
+    auto len = DigestLength();
+    Finalize(buf, len);
+    std::wstring s;
+    HashEncode(buf, len, s);
+    return s;
+  }
+  std::string SaveState() const {
+    return std::visit([](const auto &x) { return x.SaveState(); }, h);
+  }
+  // RestoreState switch to the algorithm recorded in state and resume it
+  StateStatus RestoreState(std::string_view state);
+  Algorithm algorithm() const { return alg; }
+  size_t DigestLength() const { return bela::hash::DigestLength(alg); }
+
+private:
+  Algorithm alg{Algorithm::SHA256};
+  std::variant<sha256::Hasher, sha512::Hasher, sha3::Hasher, blake3::Hasher, sm3::Hasher> h;
+};
+
 } // namespace bela::hash
 
-#endif
\ No newline at end of file
+namespace std {
+template <size_t N> struct hash<bela::hash::Digest<N>> {
+  constexpr size_t operator()(const bela::hash::Digest<N> &d) const noexcept { return d.Hash(); }
+};
+} // namespace std
+
+#endif
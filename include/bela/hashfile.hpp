@@ -0,0 +1,48 @@
+// bela::hash::HashFile digest a file with one or more algorithms in a single read pass
+#ifndef BELA_HASHFILE_HPP
+#define BELA_HASHFILE_HPP
+#include <optional>
+#include <vector>
+#include "error_code.hpp"
+#include "hash.hpp"
+
+namespace bela::hash {
+enum class ReadMode : uint32_t {
+  Auto,    // map files up to map_threshold, stream larger ones
+  Mapped,  // always map the whole file read-only
+  Streamed // positional reads fill one aligned buffer while the pool hashes the other
+};
+
+struct HashFileOptions {
+  ReadMode mode{ReadMode::Auto};
+  uint64_t map_threshold{256ull * 1024 * 1024}; // 256MB
+  size_t buffer_size{4 * 1024 * 1024};          // per buffer, rounded up to 64KB
+  // every algorithm hashes the same bytes concurrently on this pool (MultiHasher), nullptr use ThreadPool::Default()
+  bela::ThreadPool *pool{nullptr};
+};
+
+struct FileDigest {
+  Algorithm algorithm{Algorithm::SHA256};
+  size_t length{0};
+  uint8_t digest[max_digest_length];
+  std::wstring Hex() const {
+    std::wstring s;
+    HashEncode(digest, length, s);
+    return s;
+  }
+};
+
+// HashFile digests are in the order of algorithms, duplicates are ignored
+bool HashFile(std::wstring_view path, bela::Span<const Algorithm> algorithms, std::vector<FileDigest> &digests,
+              bela::error_code &ec, const HashFileOptions &options = {});
+inline std::optional<std::vector<FileDigest>> HashFile(std::wstring_view path, bela::Span<const Algorithm> algorithms,
+                                                       bela::error_code &ec, const HashFileOptions &options = {}) {
+  std::vector<FileDigest> digests;
+  if (HashFile(path, algorithms, digests, ec, options)) {
+    return std::make_optional(std::move(digests));
+  }
+  return std::nullopt;
+}
+} // namespace bela::hash
+
+#endif
@@ -3,6 +3,10 @@
 #define BELA_IO_HPP
 #include "base.hpp"
 
+namespace bela {
+class Cord;
+}
+
 namespace bela::io {
 [[maybe_unused]] constexpr auto MaximumRead = 1024ull * 1024 * 8; // 8MB
 [[maybe_unused]] constexpr auto MaximumLineLength = 1024ull * 64; // 64KB
@@ -25,6 +29,9 @@ inline bool WriteText(std::wstring_view text, std::wstring_view file, bela::erro
 inline bool WriteText(std::u16string_view text, std::wstring_view file, bela::error_code &ec) {
   return WriteText(bela::ToNarrow(text), file, ec);
 }
+// Cord overloads write chunk by chunk, the text is never flattened (UTF-8 is converted in bounded slices)
+bool WriteText(const bela::Cord &text, std::wstring_view file, bela::error_code &ec);
+bool WriteTextU16LE(const bela::Cord &text, std::wstring_view file, bela::error_code &ec);
 } // namespace bela::io
 
 #endif
\ No newline at end of file
@@ -0,0 +1,88 @@
+// bela::AsyncLogger formats on the calling thread, one background thread writes
+#ifndef BELA_LOGGER_HPP
+#define BELA_LOGGER_HPP
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include "terminal.hpp"
+
+namespace bela {
+enum class LogOverflow : uint32_t {
+  Block, // wait for the writer to free a slot (backpressure)
+  Drop   // discard the message and count it, callers never wait
+};
+
+struct AsyncLoggerOptions {
+  size_t capacity{4096}; // queued messages, rounded up to a power of two
+  LogOverflow overflow{LogOverflow::Block};
+};
+
+// AsyncLogger callers format into a stack buffer and push the text to a bounded lock-free ring (multiple producers,
+// the writer thread is the only consumer). The writer drains whatever is queued and hands consecutive messages for
+// the same FILE to a single WriteAuto call, so worker threads neither share the stdio lock nor wait on console I/O.
+// Memory is fixed at capacity slots, messages longer than a slot carry a heap copy.
+//
+//   bela::AsyncLogger::Default().FPrintF(stderr, L"request %d done in %d ms\n", id, ms);
+//   bela::AsyncLogger::Default().Flush(); // everything logged so far has been written
+class AsyncLogger {
+public:
+  static constexpr size_t inline_chars = 240;
+  explicit AsyncLogger(const AsyncLoggerOptions &options = {});
+  AsyncLogger(const AsyncLogger &) = delete;
+  AsyncLogger &operator=(const AsyncLogger &) = delete;
+  // ~AsyncLogger write queued messages then join the writer
+  ~AsyncLogger();
+  // Write queue preformatted text, false when it was dropped
+  bool Write(FILE *out, std::wstring_view msg);
+  // FPrintF false when the message was dropped or fmt doesn't match args, an empty message is queued like any other
+  template <typename... Args> bool FPrintF(FILE *out, const wchar_t *fmt, Args... args) {
+    const format_internal::FormatArg arg_array[] = {args...};
+    FormatBuffer<inline_chars> buf;
+    if (!format_internal::AppendFormatChecked(&buf, fmt, arg_array, sizeof...(args))) {
+      return false;
+    }
+    return Write(out, buf.view());
+  }
+  bool FPrintF(FILE *out, const wchar_t *fmt) {
+    FormatBuffer<inline_chars> buf;
+    StrAppendFormat(&buf, fmt);
+    return Write(out, buf.view());
+  }
+  // Flush block until every message queued before the call has been written
+  void Flush();
+  // Dropped messages discarded by LogOverflow::Drop
+  uint64_t Dropped() const { return dropped.load(std::memory_order_relaxed); }
+  // Default process wide logger, LogOverflow::Block
+  static AsyncLogger &Default();
+
+private:
+  struct Slot {
+    std::atomic<uint64_t> seq{0};
+    FILE *out{nullptr};
+    size_t len{0};
+    std::wstring large; // text longer than inline_chars
+    wchar_t text[inline_chars];
+  };
+  bool Ready(uint64_t pos) const;
+  void Wake();
+  void Work();
+  std::unique_ptr<Slot[]> slots;
+  size_t mask{0};
+  LogOverflow overflow;
+  alignas(64) std::atomic<uint64_t> enqueued{0}; // next position producers claim
+  alignas(64) std::atomic<uint64_t> written{0};  // positions below have been written
+  std::atomic<uint64_t> dropped{0};
+  std::atomic<bool> sleeping{false};
+  std::atomic<size_t> waiters{0}; // Flush callers and blocked producers
+  std::mutex mu;
+  std::condition_variable cv;      // wakes the writer
+  std::condition_variable done_cv; // wakes Flush and blocked producers
+  bool stopped{false};
+  std::thread writer;
+};
+} // namespace bela
+
+#endif
@@ -86,6 +86,8 @@ public:
   }
   bool MappingView(std::wstring_view file, bela::error_code &ec, std::size_t minsize = 1,
                    std::size_t maxsize = SIZE_MAX);
+  // MappingHandle map an opened file, MapView owns the handle from now on even when mapping fails
+  bool MappingHandle(HANDLE file, bela::error_code &ec, std::size_t minsize = 1, std::size_t maxsize = SIZE_MAX);
   MemView subview(size_t off = 0) const {
     if (off >= size_) {
       return MemView();
@@ -102,11 +104,17 @@ private:
 
 inline bool MapView::MappingView(std::wstring_view file, bela::error_code &ec, std::size_t minsize,
                                  std::size_t maxsize) {
-  if ((FileHandle = CreateFileW(file.data(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr, OPEN_EXISTING,
-                                FILE_ATTRIBUTE_NORMAL, nullptr)) == INVALID_HANDLE_VALUE) {
+  auto fd = CreateFileW(file.data(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr, OPEN_EXISTING,
+                        FILE_ATTRIBUTE_NORMAL, nullptr);
+  if (fd == INVALID_HANDLE_VALUE) {
     ec = bela::make_system_error_code();
     return false;
   }
+  return MappingHandle(fd, ec, minsize, maxsize);
+}
+
+inline bool MapView::MappingHandle(HANDLE file, bela::error_code &ec, std::size_t minsize, std::size_t maxsize) {
+  FileHandle = file;
   LARGE_INTEGER li;
   if (GetFileSizeEx(FileHandle, &li) != TRUE || (std::size_t)li.QuadPart < minsize) {
     ec = bela::make_error_code(bela::FileSizeTooSmall, L"File size too smal, size: ", li.QuadPart);
@@ -0,0 +1,73 @@
+// bela::hash::MultiHasher compute many digests with single read pass
+#ifndef BELA_MULTIHASH_HPP
+#define BELA_MULTIHASH_HPP
+#include <memory>
+#include <vector>
+#include "hash.hpp"
+#include "span.hpp"
+#include "threadpool.hpp"
+
+namespace bela::hash {
+// MultiHasher reads each block once, then fans it out to every algorithm on a ThreadPool.
+// Two shared, read-only buffers alternate: while the pool hashes one block the producer fills
+// the other, so wall-clock time approaches the slowest single algorithm (or the reads).
+//
+//   bela::hash::MultiHasher mh;
+//   mh.Initialize({Algorithm::SHA256, Algorithm::BLAKE3});
+//   for (;;) {
+//     size_t cap = 0;
+//     auto p = mh.Acquire(cap);
+//     auto n = fread(p, 1, cap, fd);
+//     mh.Commit(n);
+//     if (n < cap) break;
+//   }
+//   mh.Finalize();
+//   auto s = mh.Digest(Algorithm::SHA256);
+class MultiHasher {
+public:
+  static constexpr size_t default_block_size = 1024 * 1024; // 1MB
+  static constexpr size_t block_alignment = 4096;
+  MultiHasher() = default;
+  MultiHasher(const MultiHasher &) = delete;
+  MultiHasher &operator=(const MultiHasher &) = delete;
+  ~MultiHasher();
+  // Initialize hashers, duplicate algorithms are ignored. blockSize is at least 4096, blocks are
+  // hashed on pool, nullptr use ThreadPool::Default()
+  bool Initialize(bela::Span<const Algorithm> algorithms, size_t blockSize = default_block_size,
+                  bela::ThreadPool *pool = nullptr);
+  // Update copy input to the block buffers
+  void Update(const void *input, size_t input_len);
+  // UpdateInPlace hash caller memory (a mapped file) without copying, returns after every hasher consumed it
+  void UpdateInPlace(const void *input, size_t input_len);
+  // Acquire zero-copy producer: returns writable tail of the current block buffer, Commit the bytes filled
+  uint8_t *Acquire(size_t &capacity);
+  void Commit(size_t n);
+  // Finalize flush pending block, wait for the pool and finalize every hasher
+  void Finalize();
+  // Digest after Finalize. return digest length, zero when algorithm not found
+  size_t Digest(Algorithm a, uint8_t *out, size_t out_len) const;
+  std::wstring Digest(Algorithm a) const;
+  size_t Size() const { return lanes.size(); }
+
+private:
+  struct AlignedDelete {
+    void operator()(uint8_t *p) const;
+  };
+  struct Lane {
+    AnyHasher hasher;
+    uint8_t digest[max_digest_length];
+  };
+  void Publish();
+  std::vector<std::unique_ptr<Lane>> lanes;
+  std::unique_ptr<uint8_t[], AlignedDelete> buffers[2];
+  size_t sizes[2]{0, 0};
+  size_t current{0};
+  size_t blockSize{0};
+  bool acquired{false};
+  bool finalized{false};
+  // declared last: destroyed first, waits for tasks still reading the buffers
+  std::unique_ptr<bela::TaskGroup> group;
+};
+} // namespace bela::hash
+
+#endif
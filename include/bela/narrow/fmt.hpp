@@ -0,0 +1,53 @@
+// bela::narrow::StrFormat format straight into UTF-8, same directives and arguments as bela::StrFormat.
+// Wide string arguments are converted to UTF-8, narrow ones are copied as is, widths count UTF-8 code units.
+#ifndef BELA_NARROW_FMT_HPP
+#define BELA_NARROW_FMT_HPP
+#pragma once
+#include "../fmt.hpp"
+
+namespace bela {
+namespace format_internal {
+ssize_t StrFormatInternal(char *buf, size_t sz, const char *fmt, const FormatArg *args, size_t max_args);
+std::string StrFormatInternal(const char *fmt, const FormatArg *args, size_t max_args);
+size_t StrAppendFormatInternal(std::string *buf, const char *fmt, const FormatArg *args, size_t max_args);
+size_t StrAppendFormatInternal(basic_format_buffer<char> *buf, const char *fmt, const FormatArg *args, size_t max_args);
+} // namespace format_internal
+
+namespace narrow {
+template <size_t N = 256> using FormatBuffer = bela::FormatBuffer<N, char>;
+
+size_t StrAppendFormat(std::string *buf, const char *fmt);
+template <typename... Args> size_t StrAppendFormat(std::string *buf, const char *fmt, Args... args) {
+  const format_internal::FormatArg arg_array[] = {args...};
+  return format_internal::StrAppendFormatInternal(buf, fmt, arg_array, sizeof...(args));
+}
+
+size_t StrAppendFormat(basic_format_buffer<char> *buf, const char *fmt);
+template <typename... Args> size_t StrAppendFormat(basic_format_buffer<char> *buf, const char *fmt, Args... args) {
+  const format_internal::FormatArg arg_array[] = {args...};
+  return format_internal::StrAppendFormatInternal(buf, fmt, arg_array, sizeof...(args));
+}
+
+template <typename... Args> ssize_t StrFormat(char *buf, size_t N, const char *fmt, Args... args) {
+  const format_internal::FormatArg arg_array[] = {args...};
+  return format_internal::StrFormatInternal(buf, N, fmt, arg_array, sizeof...(args));
+}
+
+template <size_t N, typename... Args> ssize_t StrFormat(char (&buf)[N], const char *fmt, Args... args) {
+  const format_internal::FormatArg arg_array[] = {args...};
+  return format_internal::StrFormatInternal(buf, N, fmt, arg_array, sizeof...(args));
+}
+
+template <typename... Args> std::string StrFormat(const char *fmt, Args... args) {
+  const format_internal::FormatArg arg_array[] = {args...};
+  return format_internal::StrFormatInternal(fmt, arg_array, sizeof...(args));
+}
+
+// Fast-path when we don't actually need to substitute any arguments.
+ssize_t StrFormat(char *buf, size_t N, const char *fmt);
+std::string StrFormat(const char *fmt);
+template <size_t N> inline ssize_t StrFormat(char (&buf)[N], const char *fmt) { return StrFormat(buf, N, fmt); }
+} // namespace narrow
+} // namespace bela
+
+#endif
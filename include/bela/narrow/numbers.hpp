@@ -0,0 +1,56 @@
+// bela::narrow::SimpleAtoi/SimpleAtod parse numbers from char text (ASCII/UTF-8), same rules as the wide versions
+#ifndef BELA_NARROW_NUMBERS_HPP
+#define BELA_NARROW_NUMBERS_HPP
+#pragma once
+#include <cstdint>
+#include <string_view>
+#include <type_traits>
+#include "../numbers.hpp"
+
+namespace bela::narrow {
+namespace numbers_internal {
+bool safe_strto32_base(std::string_view text, int32_t *value, int base);
+bool safe_strto64_base(std::string_view text, int64_t *value, int base);
+bool safe_strtou32_base(std::string_view text, uint32_t *value, int base);
+bool safe_strtou64_base(std::string_view text, uint64_t *value, int base);
+
+template <typename int_type> bool safe_strtoi_base(std::string_view s, int_type *out, int base) {
+  static_assert(sizeof(*out) == 4 || sizeof(*out) == 8, "SimpleAtoi works only with 32-bit or 64-bit integers.");
+  static_assert(!std::is_floating_point<int_type>::value, "Use SimpleAtof or SimpleAtod instead.");
+  bool parsed;
+  if constexpr (static_cast<int_type>(1) - 2 < 0) { // Signed
+    if constexpr (sizeof(*out) == 64 / 8) {         // 64-bit
+      int64_t val;
+      parsed = numbers_internal::safe_strto64_base(s, &val, base);
+      *out = static_cast<int_type>(val);
+    } else { // 32-bit
+      int32_t val;
+      parsed = numbers_internal::safe_strto32_base(s, &val, base);
+      *out = static_cast<int_type>(val);
+    }
+  } else {                                  // Unsigned
+    if constexpr (sizeof(*out) == 64 / 8) { // 64-bit
+      uint64_t val;
+      parsed = numbers_internal::safe_strtou64_base(s, &val, base);
+      *out = static_cast<int_type>(val);
+    } else { // 32-bit
+      uint32_t val;
+      parsed = numbers_internal::safe_strtou32_base(s, &val, base);
+      *out = static_cast<int_type>(val);
+    }
+  }
+  return parsed;
+}
+} // namespace numbers_internal
+
+template <typename I> bool SimpleAtoi(std::string_view s, I *out) {
+  return numbers_internal::safe_strtoi_base(s, out, 10);
+}
+bool SimpleAtof(std::string_view str, float *out);
+bool SimpleAtod(std::string_view str, double *out);
+// ParseNumbers delimited column of ASCII/UTF-8 text, see bela::ParseNumbers
+ParseNumbersResult ParseNumbers(std::string_view text, char delimiter, bela::Span<int64_t> out);
+ParseNumbersResult ParseNumbers(std::string_view text, char delimiter, bela::Span<double> out);
+} // namespace bela::narrow
+
+#endif
@@ -57,6 +57,7 @@
 #include <array>
 #include <string_view>
 #include <charconv> // C++17
+#include "../details/itoa.hpp"
 
 namespace bela::narrow {
 namespace strings_internal {
@@ -177,39 +178,15 @@ constexpr size_t kFastToBufferSize = 32;
 class AlphaNum {
 public:
   AlphaNum(bool v) : piece_(v ? "true" : "false") {} // TRUE FALSE
-  AlphaNum(short x) {
-    auto ret = std::to_chars(digits_, digits_ + sizeof(digits_), x);
-    piece_ = std::string_view(digits_, ret.ptr - digits_);
-  }
-  AlphaNum(unsigned short x) {
-    auto ret = std::to_chars(digits_, digits_ + sizeof(digits_), x);
-    piece_ = std::string_view(digits_, ret.ptr - digits_);
-  }
-  AlphaNum(int x) {
-    auto ret = std::to_chars(digits_, digits_ + sizeof(digits_), x);
-    piece_ = std::string_view(digits_, ret.ptr - digits_);
-  }
-  AlphaNum(unsigned int x) {
-    auto ret = std::to_chars(digits_, digits_ + sizeof(digits_), x);
-    piece_ = std::string_view(digits_, ret.ptr - digits_);
-  }
-  AlphaNum(long x) {
-    auto ret = std::to_chars(digits_, digits_ + sizeof(digits_), x);
-    piece_ = std::string_view(digits_, ret.ptr - digits_);
-  }
+  AlphaNum(short x) : piece_(digits_, bela::numbers_internal::WriteInteger(x, digits_) - digits_) {}
+  AlphaNum(unsigned short x) : piece_(digits_, bela::numbers_internal::WriteInteger(x, digits_) - digits_) {}
+  AlphaNum(int x) : piece_(digits_, bela::numbers_internal::WriteInteger(x, digits_) - digits_) {}
+  AlphaNum(unsigned int x) : piece_(digits_, bela::numbers_internal::WriteInteger(x, digits_) - digits_) {}
+  AlphaNum(long x) : piece_(digits_, bela::numbers_internal::WriteInteger(x, digits_) - digits_) {}
 
-  AlphaNum(unsigned long x) {
-    auto ret = std::to_chars(digits_, digits_ + sizeof(digits_), x);
-    piece_ = std::string_view(digits_, ret.ptr - digits_);
-  }
-  AlphaNum(long long x) {
-    auto ret = std::to_chars(digits_, digits_ + sizeof(digits_), x);
-    piece_ = std::string_view(digits_, ret.ptr - digits_);
-  }
-  AlphaNum(unsigned long long x) {
-    auto ret = std::to_chars(digits_, digits_ + sizeof(digits_), x);
-    piece_ = std::string_view(digits_, ret.ptr - digits_);
-  }
+  AlphaNum(unsigned long x) : piece_(digits_, bela::numbers_internal::WriteInteger(x, digits_) - digits_) {}
+  AlphaNum(long long x) : piece_(digits_, bela::numbers_internal::WriteInteger(x, digits_) - digits_) {}
+  AlphaNum(unsigned long long x) : piece_(digits_, bela::numbers_internal::WriteInteger(x, digits_) - digits_) {}
 
   AlphaNum(float f) // NOLINT(runtime/explicit)
   {
@@ -41,6 +41,8 @@
 #include <string>
 #include <type_traits>
 #include <string_view>
+#include <system_error>
+#include "span.hpp"
 
 namespace bela {
 namespace numbers_internal {
@@ -129,10 +131,31 @@ template <typename int_type> bool safe_strtoi_base(std::wstring_view s, int_type
 template <typename I> bool SimpleAtoi(std::wstring_view s, I *out) {
   return numbers_internal::safe_strtoi_base(s, out, 10);
 }
-// bool SimpleAtof(std::wstring_view str, float *out);
-// bool SimpleAtod(std::wstring_view str, double *out);
+// SimpleAtof/SimpleAtod surrounding whitespace and a leading '+' are allowed, values out of range become
+// +/-infinity or zero and still return true. Not locale dependent, results are correctly rounded.
+bool SimpleAtof(std::wstring_view str, float *out);
+bool SimpleAtod(std::wstring_view str, double *out);
 bool SimpleAtob(std::wstring_view str, bool *out);
 
+// ParseNumbersResult count values were stored. ec is std::errc{} when the whole text was converted, otherwise the
+// field out[count] would have come from starts at offset: std::errc::invalid_argument for a malformed field,
+// std::errc::result_out_of_range for an integer that does not fit int64_t, std::errc::value_too_large when out is full.
+struct ParseNumbersResult {
+  size_t count{0};
+  size_t offset{0};
+  std::errc ec{};
+};
+
+// ParseNumbers converts a delimited column (L"12,7,-3" or one value per line with L'\n') straight into out, no view
+// or string is made per field. Fields follow SimpleAtoi/SimpleAtod rules, whitespace around a field (so the '\r' of
+// CRLF lines) is ignored and blank text after the last delimiter ends the column. An empty field is malformed.
+//
+//   std::vector<int64_t> sizes(rows);
+//   auto r = bela::ParseNumbers(text, L'\n', bela::MakeSpan(sizes));
+//   if (r.ec != std::errc{}) { /* text.substr(r.offset) is the field that failed */ }
+ParseNumbersResult ParseNumbers(std::wstring_view text, wchar_t delimiter, bela::Span<int64_t> out);
+ParseNumbersResult ParseNumbers(std::wstring_view text, wchar_t delimiter, bela::Span<double> out);
+
 } // namespace bela
 
 #endif
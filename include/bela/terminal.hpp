@@ -3,6 +3,7 @@
 #define BELA_TERMINAL_HPP
 #include "base.hpp"
 #include "fmt.hpp"
+#include "narrow/fmt.hpp"
 
 namespace bela {
 namespace terminal {
@@ -39,10 +40,14 @@ bela::ssize_t WriteAutoFallback(FILE *fd, std::wstring_view data);
 // UTF-8 version direct write
 bela::ssize_t WriteAutoFallback(FILE *fd, std::string_view data);
 } // namespace terminal
+// FPrintF formats on the stack, only messages longer than 256 characters allocate
 template <typename... Args> ssize_t FPrintF(FILE *out, const wchar_t *fmt, Args... args) {
   const format_internal::FormatArg arg_array[] = {args...};
-  auto str = format_internal::StrFormatInternal(fmt, arg_array, sizeof...(args));
-  return bela::terminal::WriteAuto(out, str);
+  FormatBuffer<256> buf;
+  if (format_internal::StrAppendFormatInternal(&buf, fmt, arg_array, sizeof...(args)) == 0) {
+    return 0;
+  }
+  return bela::terminal::WriteAuto(out, buf.view());
 }
 
 inline ssize_t FPrintF(FILE *out, const wchar_t *fmt) {
@@ -52,8 +57,11 @@ inline ssize_t FPrintF(FILE *out, const wchar_t *fmt) {
 
 template <typename... Args> ssize_t FPrintFallbackF(FILE *out, const wchar_t *fmt, Args... args) {
   const format_internal::FormatArg arg_array[] = {args...};
-  auto str = format_internal::StrFormatInternal(fmt, arg_array, sizeof...(args));
-  return bela::terminal::WriteAutoFallback(out, str);
+  FormatBuffer<256> buf;
+  if (format_internal::StrAppendFormatInternal(&buf, fmt, arg_array, sizeof...(args)) == 0) {
+    return 0;
+  }
+  return bela::terminal::WriteAutoFallback(out, buf.view());
 }
 
 inline ssize_t FPrintFallbackF(FILE *out, const wchar_t *fmt) {
@@ -61,5 +69,31 @@ inline ssize_t FPrintFallbackF(FILE *out, const wchar_t *fmt) {
   return bela::terminal::WriteAutoFallback(out, str);
 }
 
+namespace narrow {
+// FPrintF UTF-8 format string, the text is written without a UTF-16 round trip when possible
+template <typename... Args> ssize_t FPrintF(FILE *out, const char *fmt, Args... args) {
+  const format_internal::FormatArg arg_array[] = {args...};
+  FormatBuffer<256> buf;
+  if (format_internal::StrAppendFormatInternal(&buf, fmt, arg_array, sizeof...(args)) == 0) {
+    return 0;
+  }
+  return bela::terminal::WriteAuto(out, buf.view());
+}
+
+inline ssize_t FPrintF(FILE *out, const char *fmt) {
+  auto str = StrFormat(fmt);
+  return bela::terminal::WriteAuto(out, str);
+}
+} // namespace narrow
+
+#if defined(BELA_HAVE_COMPILED_FORMAT)
+template <format_internal::FormatLiteral S, typename... Args>
+ssize_t FPrintF(FILE *out, FormatString<S> f, Args... args) {
+  FormatBuffer<256> buf;
+  StrAppendFormat(&buf, f, args...);
+  return bela::terminal::WriteAuto(out, buf.view());
+}
+#endif
+
 } // namespace bela
 #endif
\ No newline at end of file
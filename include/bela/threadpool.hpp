@@ -0,0 +1,74 @@
+// bela::ThreadPool work-stealing thread pool
+#ifndef BELA_THREADPOOL_HPP
+#define BELA_THREADPOOL_HPP
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace bela {
+// ThreadPool every worker owns a deque. A worker pops its newest task (LIFO, cache warm) and
+// when it runs dry steals the oldest task of a sibling (FIFO, the largest piece of a
+// divide-and-conquer job). Tasks submitted from outside the pool are spread round-robin.
+class ThreadPool {
+public:
+  using Task = std::function<void()>;
+  // threads == 0 use std::thread::hardware_concurrency()
+  explicit ThreadPool(size_t threads = 0);
+  ThreadPool(const ThreadPool &) = delete;
+  ThreadPool &operator=(const ThreadPool &) = delete;
+  // ~ThreadPool drain queued tasks then join workers
+  ~ThreadPool();
+  void Submit(Task task);
+  // RunPending run one queued task on the calling thread, return false when none is available
+  bool RunPending();
+  size_t Size() const { return queues.size(); }
+  // Default process wide pool sized to hardware concurrency
+  static ThreadPool &Default();
+
+private:
+  struct Queue {
+    std::mutex mu;
+    std::deque<Task> tasks;
+  };
+  bool Pop(size_t index, Task &task);
+  bool Steal(size_t index, Task &task);
+  void Work(size_t index);
+  std::vector<std::unique_ptr<Queue>> queues;
+  std::vector<std::thread> workers;
+  std::mutex mu;
+  std::condition_variable cv;
+  std::atomic<size_t> queued{0};
+  std::atomic<size_t> next{0};
+  bool stopped{false};
+};
+
+// TaskGroup fork-join on a ThreadPool. Wait runs pending tasks while waiting, so groups nested
+// inside pool tasks never starve the pool.
+//
+//   bela::TaskGroup g(bela::ThreadPool::Default());
+//   g.Run([&] { left(); });
+//   right();
+//   g.Wait();
+class TaskGroup {
+public:
+  explicit TaskGroup(ThreadPool &pool_) : pool(pool_) {}
+  TaskGroup(const TaskGroup &) = delete;
+  TaskGroup &operator=(const TaskGroup &) = delete;
+  ~TaskGroup() { Wait(); }
+  void Run(ThreadPool::Task task);
+  void Wait();
+
+private:
+  ThreadPool &pool;
+  std::mutex mu;
+  std::condition_variable cv;
+  std::atomic<size_t> pending{0};
+};
+} // namespace bela
+
+#endif
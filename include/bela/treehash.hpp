@@ -0,0 +1,56 @@
+// bela::hash::TreeHasher digest a whole directory tree into a sorted manifest and a Merkle root
+#ifndef BELA_TREEHASH_HPP
+#define BELA_TREEHASH_HPP
+#include "hashfile.hpp"
+
+namespace bela::hash {
+struct TreeEntry {
+  std::wstring path; // relative to the tree root, '/' separated
+  uint64_t size{0};
+  int64_t mtime{0}; // last write time, FILETIME ticks (POSIX mtime is converted)
+  FileDigest digest;
+};
+
+// TreeManifest entries are sorted by path (ordinal), so the same tree always yields the same manifest.
+// Root is the RFC 6962 style Merkle tree hash over the entries, using the same algorithm:
+//   leaf = H(0x00 || u64le(len(path)) || path UTF-8 || u64le(size) || digest)
+//   node = H(0x01 || left || right), left covers the largest power of two entries < n
+// mtime is not part of the root, touching a file doesn't change it.
+struct TreeManifest {
+  Algorithm algorithm{Algorithm::BLAKE3};
+  std::vector<TreeEntry> entries;
+  FileDigest root;
+  const TreeEntry *Find(std::wstring_view path) const;
+  // Encode text manifest, first line 'bela-tree v1 <algorithm> <root>' then '<digest> <size> <mtime> <path>',
+  // '\\', '\n' and '\r' in path are escaped with a backslash
+  std::wstring Encode() const;
+  static std::optional<TreeManifest> Decode(std::wstring_view text, bela::error_code &ec);
+};
+
+// TreeHasher walks directories concurrently and hashes files on a ThreadPool. With a previous
+// manifest of the same algorithm, files whose size and mtime match are not read again.
+//
+//   bela::hash::TreeHasher th(bela::hash::Algorithm::SHA256);
+//   auto m = th.Hash(L"C:\\deploy", ec, previous ? &*previous : nullptr);
+//   bela::io::WriteText(m->Encode(), L"C:\\deploy.manifest", ec);
+class TreeHasher {
+public:
+  explicit TreeHasher(Algorithm algorithm_ = Algorithm::BLAKE3, bela::ThreadPool *pool_ = nullptr)
+      : algorithm(algorithm_), pool(pool_) {}
+  std::optional<TreeManifest> Hash(std::wstring_view root, bela::error_code &ec, const TreeManifest *previous = nullptr);
+  // statistics of the last Hash
+  size_t Hashed() const { return hashed; }
+  size_t Reused() const { return reused; }
+
+private:
+  Algorithm algorithm;
+  bela::ThreadPool *pool{nullptr};
+  size_t hashed{0};
+  size_t reused{0};
+};
+
+// MerkleRoot compute TreeManifest::root over sorted entries
+FileDigest MerkleRoot(Algorithm algorithm, bela::Span<const TreeEntry> entries);
+} // namespace bela::hash
+
+#endif
@@ -2,7 +2,15 @@
 // see:
 // https://github.com/llvm-mirror/llvm/blob/master/lib/Support/ConvertUTF.cpp
 //
+#include <atomic>
 #include <bela/codecvt.hpp>
+#include "codecvt_impl.hpp"
+#if !defined(BELA_CODECVT_NEON) && (defined(__aarch64__) || defined(_M_ARM64))
+#define BELA_CODECVT_NEON 1
+#endif
+#if defined(BELA_CODECVT_NEON)
+#include <arm_neon.h>
+#endif
 
 namespace bela {
 
@@ -168,11 +176,199 @@ inline char32_t AnnexU8(const uint8_t *it, int nb) {
   return ch;
 }
 
+namespace codecvt_internal {
+size_t utf16_length_portable(const uint8_t *p, size_t len) { return utf16_length_scalar(p, p + len, 0); }
+char16_t *utf8_to_utf16_portable(const uint8_t *p, size_t len, char16_t *out, char16_t * /*out_end*/) {
+  return utf8_to_utf16_scalar(p, p + len, out);
+}
+
+#if defined(BELA_CODECVT_NEON)
+// NEON backend: the same validation and windows as the x86 kernels, vqtbl1q_u8 is pshufb
+namespace {
+// movemask_neon 16 byte masks (0x00 or 0xFF) to 16 bits
+inline uint32_t movemask_neon(uint8x16_t m) {
+  static constexpr uint8_t bits[16] = {1, 2, 4, 8, 16, 32, 64, 128, 1, 2, 4, 8, 16, 32, 64, 128};
+  auto v = vandq_u8(m, vld1q_u8(bits));
+  v = vpaddq_u8(v, v);
+  v = vpaddq_u8(v, v);
+  v = vpaddq_u8(v, v);
+  return vgetq_lane_u16(vreinterpretq_u16_u8(v), 0);
+}
+
+struct Utf8CheckerNeon {
+  uint8x16_t error{vdupq_n_u8(0)};
+  uint8x16_t prev_input{vdupq_n_u8(0)};
+  uint8x16_t prev_incomplete{vdupq_n_u8(0)};
+
+  void Check(uint8x16_t input) {
+    if (vmaxvq_u8(input) < 0x80) {
+      error = vorrq_u8(error, prev_incomplete);
+      prev_incomplete = vdupq_n_u8(0);
+      prev_input = input;
+      return;
+    }
+    const auto prev1 = vextq_u8(prev_input, input, 15);
+    const auto b1h = vqtbl1q_u8(vld1q_u8(byte_1_high), vshrq_n_u8(prev1, 4));
+    const auto b1l = vqtbl1q_u8(vld1q_u8(byte_1_low), vandq_u8(prev1, vdupq_n_u8(0x0F)));
+    const auto b2h = vqtbl1q_u8(vld1q_u8(byte_2_high), vshrq_n_u8(input, 4));
+    const auto special = vandq_u8(vandq_u8(b1h, b1l), b2h);
+    const auto prev2 = vextq_u8(prev_input, input, 14);
+    const auto prev3 = vextq_u8(prev_input, input, 13);
+    const auto must23 = vorrq_u8(vqsubq_u8(prev2, vdupq_n_u8(0xE0 - 0x80)), vqsubq_u8(prev3, vdupq_n_u8(0xF0 - 0x80)));
+    error = vorrq_u8(error, veorq_u8(vandq_u8(must23, vdupq_n_u8(0x80)), special));
+    static constexpr uint8_t max_value[16] = {0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,     0xFF,
+                                              0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xF0 - 1, 0xE0 - 1, 0xC0 - 1};
+    prev_incomplete = vqsubq_u8(input, vld1q_u8(max_value));
+    prev_input = input;
+  }
+  bool Failed() const { return vmaxvq_u8(vorrq_u8(error, prev_incomplete)) != 0; }
+};
+
+inline uint32_t utf16_units_neon(uint8x16_t input) {
+  const auto counted = vcgtq_s8(vreinterpretq_s8_u8(input), vdupq_n_s8(-65));
+  const auto lead4 = vcgeq_u8(input, vdupq_n_u8(0xF0));
+  return vaddvq_u8(vsubq_u8(vdupq_n_u8(0), vaddq_u8(counted, lead4)));
+}
+} // namespace
+
+size_t utf16_length_neon(const uint8_t *p, size_t len) {
+  Utf8CheckerNeon checker;
+  size_t units = 0;
+  size_t i = 0;
+  for (; i + 16 <= len; i += 16) {
+    const auto input = vld1q_u8(p + i);
+    checker.Check(input);
+    units += utf16_units_neon(input);
+  }
+  if (i < len) {
+    uint8_t tail[16] = {0};
+    std::memcpy(tail, p + i, len - i);
+    const auto input = vld1q_u8(tail);
+    checker.Check(input);
+    units += utf16_units_neon(input) - (16 - (len - i));
+  }
+  return checker.Failed() ? utf8_invalid : units;
+}
+
+char16_t *utf8_to_utf16_neon(const uint8_t *p, size_t len, char16_t *out, char16_t *out_end) {
+  const auto end = p + len;
+  const auto &t = GetWindowTables();
+  while (end - p >= 16 && out_end - out >= 16) {
+    const auto in = vld1q_u8(p);
+    auto *o = reinterpret_cast<uint16_t *>(out);
+    if (vmaxvq_u8(in) < 0x80) {
+      vst1q_u16(o, vmovl_u8(vget_low_u8(in)));
+      vst1q_u16(o + 8, vmovl_high_u8(in));
+      p += 16;
+      out += 16;
+      continue;
+    }
+    const auto cont = movemask_neon(vcltq_s8(vreinterpretq_s8_u8(in), vdupq_n_s8(-64)));
+    const auto &shape = t.shapes[(~cont >> 1) & 0xFFF];
+    if (shape.kind == window_six) {
+      const auto v = vreinterpretq_u16_u8(vqtbl1q_u8(in, vld1q_u8(t.shuffles[shape.shuffle])));
+      const auto ascii = vandq_u16(v, vdupq_n_u16(0x7F));
+      const auto high = vshrq_n_u16(vandq_u16(v, vdupq_n_u16(0x1F00)), 2);
+      vst1q_u16(o, vorrq_u16(ascii, high));
+      p += shape.consumed;
+      out += 6;
+      continue;
+    }
+    if (shape.kind == window_four) {
+      const auto v = vreinterpretq_u32_u8(vqtbl1q_u8(in, vld1q_u8(t.shuffles[shape.shuffle])));
+      const auto ascii = vandq_u32(v, vdupq_n_u32(0x7F));
+      const auto middle = vshrq_n_u32(vandq_u32(v, vdupq_n_u32(0x3F00)), 2);
+      const auto high = vshrq_n_u32(vandq_u32(v, vdupq_n_u32(0x0F0000)), 4);
+      vst1_u16(o, vmovn_u32(vorrq_u32(vorrq_u32(ascii, middle), high)));
+      p += shape.consumed;
+      out += 4;
+      continue;
+    }
+    p = utf8_to_utf16_scalar(p, out);
+  }
+  return utf8_to_utf16_scalar(p, end, out);
+}
+#endif
+
+struct Kernels {
+  size_t (*length)(const uint8_t *p, size_t len);
+  char16_t *(*transcode)(const uint8_t *p, size_t len, char16_t *out, char16_t *out_end);
+  Backend backend;
+};
+constexpr Kernels portable_kernels{utf16_length_portable, utf8_to_utf16_portable, Backend::Portable};
+#if defined(BELA_CPU_X86)
+constexpr Kernels sse41_kernels{utf16_length_sse41, utf8_to_utf16_sse41, Backend::SSE41};
+constexpr Kernels avx2_kernels{utf16_length_avx2, utf8_to_utf16_avx2, Backend::AVX2};
+#endif
+#if defined(BELA_CODECVT_NEON)
+constexpr Kernels neon_kernels{utf16_length_neon, utf8_to_utf16_neon, Backend::NEON};
+#endif
+
+static const Kernels *resolve_kernels(Backend b) {
+#if defined(BELA_CPU_X86)
+  const auto &features = bela::cpu_internal::GetCpuFeatures();
+  if (b == Backend::AVX2 || (b == Backend::Auto && features.avx2)) {
+    return features.avx2 ? &avx2_kernels : nullptr;
+  }
+  if (b == Backend::SSE41 || (b == Backend::Auto && features.sse41)) {
+    return features.sse41 ? &sse41_kernels : nullptr;
+  }
+#endif
+#if defined(BELA_CODECVT_NEON)
+  if (b == Backend::NEON || b == Backend::Auto) {
+    return &neon_kernels;
+  }
+#endif
+  if (b == Backend::Portable || b == Backend::Auto) {
+    return &portable_kernels;
+  }
+  return nullptr;
+}
+
+static std::atomic<const Kernels *> &active_kernels() {
+  static std::atomic<const Kernels *> kernels{resolve_kernels(Backend::Auto)};
+  return kernels;
+}
+
+bool SetBackend(Backend b) {
+  auto k = resolve_kernels(b);
+  if (k == nullptr) {
+    return false;
+  }
+  active_kernels().store(k, std::memory_order_relaxed);
+  return true;
+}
+
+Backend ActiveBackend() { return active_kernels().load(std::memory_order_relaxed)->backend; }
+
+// Utf8ToUtf16 transcode strictly valid UTF-8 with one allocation of the exact size, false (container untouched) when
+// the input isn't valid
+template <typename T, typename Allocator>
+bool Utf8ToUtf16(const uint8_t *s, size_t len, std::basic_string<T, std::char_traits<T>, Allocator> &container) {
+  static_assert(sizeof(T) == sizeof(char16_t), "UTF-16 code units only");
+  const auto k = active_kernels().load(std::memory_order_relaxed);
+  const auto n = k->length(s, len);
+  if (n == utf8_invalid) {
+    return false;
+  }
+  container.resize(n);
+  auto out = reinterpret_cast<char16_t *>(container.data());
+  k->transcode(s, len, out, out + n);
+  return true;
+}
+} // namespace codecvt_internal
+
 template <typename T, typename Allocator>
 bool mbrtoc16(const unsigned char *s, size_t len, std::basic_string<T, std::char_traits<T>, Allocator> &container) {
   if (s == nullptr || len == 0) {
     return false;
   }
+  if constexpr (sizeof(T) == sizeof(char16_t)) {
+    if (codecvt_internal::Utf8ToUtf16(s, len, container)) {
+      return true;
+    }
+  }
+  // invalid UTF-8 (or a 32-bit wchar_t) keeps the lenient rune at a time decoder
   container.reserve(len);
   auto it = reinterpret_cast<const unsigned char *>(s);
   auto end = it + len;
@@ -0,0 +1,115 @@
+/// UTF-8 to UTF-16 AVX2 backend: 32-byte validation and ASCII, windows of multibyte text share the SSE4.1 code
+// GCC/Clang: compile with -mavx2
+#include "codecvt_x86.hpp"
+
+namespace bela::codecvt_internal {
+namespace {
+inline __m256i load_table256(const uint8_t (&table)[16]) { return _mm256_broadcastsi128_si256(load_table(table)); }
+
+// Utf8Checker256 Keiser-Lemire validation 32 bytes at a time
+struct Utf8Checker256 {
+  __m256i error{_mm256_setzero_si256()};
+  __m256i prev_input{_mm256_setzero_si256()};
+  __m256i prev_incomplete{_mm256_setzero_si256()};
+
+  void Check(__m256i input) {
+    if (_mm256_movemask_epi8(input) == 0) {
+      error = _mm256_or_si256(error, prev_incomplete);
+      prev_incomplete = _mm256_setzero_si256();
+      prev_input = input;
+      return;
+    }
+    const auto nibble = _mm256_set1_epi8(0x0F);
+    // the last 16 bytes of the previous block and the first 16 of this one, alignr works per 128-bit lane
+    const auto carried = _mm256_permute2x128_si256(prev_input, input, 0x21);
+    const auto prev1 = _mm256_alignr_epi8(input, carried, 15);
+    const auto b1h =
+        _mm256_shuffle_epi8(load_table256(byte_1_high), _mm256_and_si256(_mm256_srli_epi16(prev1, 4), nibble));
+    const auto b1l = _mm256_shuffle_epi8(load_table256(byte_1_low), _mm256_and_si256(prev1, nibble));
+    const auto b2h =
+        _mm256_shuffle_epi8(load_table256(byte_2_high), _mm256_and_si256(_mm256_srli_epi16(input, 4), nibble));
+    const auto special = _mm256_and_si256(_mm256_and_si256(b1h, b1l), b2h);
+    const auto prev2 = _mm256_alignr_epi8(input, carried, 14);
+    const auto prev3 = _mm256_alignr_epi8(input, carried, 13);
+    const auto must23 = _mm256_or_si256(_mm256_subs_epu8(prev2, _mm256_set1_epi8(static_cast<char>(0xE0 - 0x80))),
+                                        _mm256_subs_epu8(prev3, _mm256_set1_epi8(static_cast<char>(0xF0 - 0x80))));
+    const auto must23_80 = _mm256_and_si256(must23, _mm256_set1_epi8(static_cast<char>(0x80)));
+    error = _mm256_or_si256(error, _mm256_xor_si256(must23_80, special));
+    const auto max_value = _mm256_setr_epi8(
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+        -1, static_cast<char>(0xF0 - 1), static_cast<char>(0xE0 - 1), static_cast<char>(0xC0 - 1));
+    prev_incomplete = _mm256_subs_epu8(input, max_value);
+    prev_input = input;
+  }
+  bool Failed() const { return _mm256_testz_si256(_mm256_or_si256(error, prev_incomplete), _mm256_set1_epi8(-1)) == 0; }
+};
+
+inline void store_widened32(char16_t *out, __m256i in) {
+  _mm256_storeu_si256(reinterpret_cast<__m256i *>(out), _mm256_cvtepu8_epi16(_mm256_castsi256_si128(in)));
+  _mm256_storeu_si256(reinterpret_cast<__m256i *>(out + 16), _mm256_cvtepu8_epi16(_mm256_extracti128_si256(in, 1)));
+}
+
+inline __m256i utf16_units256(__m256i input) {
+  const auto counted = _mm256_cmpgt_epi8(input, _mm256_set1_epi8(-65));
+  const auto lead4 = _mm256_cmpeq_epi8(_mm256_max_epu8(input, _mm256_set1_epi8(static_cast<char>(0xF0))), input);
+  const auto zero = _mm256_setzero_si256();
+  return _mm256_sad_epu8(_mm256_sub_epi8(zero, _mm256_add_epi8(counted, lead4)), zero);
+}
+} // namespace
+
+size_t utf16_length_avx2(const uint8_t *p, size_t len) {
+  Utf8Checker256 checker;
+  auto units = _mm256_setzero_si256();
+  size_t ascii = 0;
+  size_t padding = 0;
+  size_t i = 0;
+  for (; i + 32 <= len; i += 32) {
+    const auto input = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p + i));
+    checker.Check(input);
+    if (_mm256_movemask_epi8(input) == 0) {
+      ascii += 32;
+      continue;
+    }
+    units = _mm256_add_epi64(units, utf16_units256(input));
+  }
+  if (i < len) {
+    alignas(32) uint8_t tail[32] = {0};
+    std::memcpy(tail, p + i, len - i);
+    const auto input = _mm256_load_si256(reinterpret_cast<const __m256i *>(tail));
+    checker.Check(input);
+    units = _mm256_add_epi64(units, utf16_units256(input));
+    padding = 32 - (len - i);
+  }
+  if (checker.Failed()) {
+    return utf8_invalid;
+  }
+  uint64_t lanes[4];
+  _mm256_storeu_si256(reinterpret_cast<__m256i *>(lanes), units);
+  return ascii + static_cast<size_t>(lanes[0] + lanes[1] + lanes[2] + lanes[3]) - padding;
+}
+
+char16_t *utf8_to_utf16_avx2(const uint8_t *p, size_t len, char16_t *out, char16_t *out_end) {
+  const auto end = p + len;
+  const auto &t = GetWindowTables();
+  while (end - p >= 64 && out_end - out >= 64) {
+    const auto in0 = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p));
+    const auto in1 = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p + 32));
+    const auto ascii = static_cast<uint64_t>(static_cast<uint32_t>(_mm256_movemask_epi8(in0))) |
+                       static_cast<uint64_t>(static_cast<uint32_t>(_mm256_movemask_epi8(in1))) << 32;
+    if (ascii == 0) {
+      store_widened32(out, in0);
+      store_widened32(out + 32, in1);
+      p += 64;
+      out += 64;
+      continue;
+    }
+    // continuation bytes 0x80..0xBF are the signed bytes below -64
+    const auto limit = _mm256_set1_epi8(-64);
+    const auto cont0 = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpgt_epi8(limit, in0)));
+    const auto cont1 = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpgt_epi8(limit, in1)));
+    const auto cont = static_cast<uint64_t>(cont0) | static_cast<uint64_t>(cont1) << 32;
+    transcode_chunk(p, out, ascii, ~cont >> 1, 48, t);
+  }
+  return transcode_tail(p, end, out, out_end, t);
+}
+} // namespace bela::codecvt_internal
@@ -0,0 +1,259 @@
+/// UTF-8 to UTF-16 transcoding kernels shared by codecvt.cc and its SIMD translation units
+#ifndef BELA_CODECVT_IMPL_HPP
+#define BELA_CODECVT_IMPL_HPP
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <bela/details/cpufeatures.hpp>
+
+namespace bela::codecvt_internal {
+constexpr size_t utf8_invalid = static_cast<size_t>(-1);
+
+// utf16_length_scalar validate [p, end) as strict UTF-8 (no overlong forms, surrogates or runes above U+10FFFF) and
+// add its UTF-16 length to n, utf8_invalid on error. p must be at the start of a sequence.
+inline size_t utf16_length_scalar(const uint8_t *p, const uint8_t *end, size_t n) {
+  while (p < end) {
+    // eight ASCII bytes at a time
+    if (end - p >= 8) {
+      uint64_t v;
+      std::memcpy(&v, p, 8);
+      if ((v & 0x8080808080808080ULL) == 0) {
+        p += 8;
+        n += 8;
+        continue;
+      }
+    }
+    const auto c = *p;
+    if (c < 0x80) {
+      p++;
+      n++;
+      continue;
+    }
+    const auto left = end - p;
+    if (c >= 0xC2 && c <= 0xDF) {
+      if (left < 2 || (p[1] & 0xC0) != 0x80) {
+        return utf8_invalid;
+      }
+      p += 2;
+      n++;
+      continue;
+    }
+    if (c >= 0xE0 && c <= 0xEF) {
+      if (left < 3 || (p[1] & 0xC0) != 0x80 || (p[2] & 0xC0) != 0x80) {
+        return utf8_invalid;
+      }
+      // E0 A0..BF: no overlong, ED 80..9F: no surrogate
+      if ((c == 0xE0 && p[1] < 0xA0) || (c == 0xED && p[1] > 0x9F)) {
+        return utf8_invalid;
+      }
+      p += 3;
+      n++;
+      continue;
+    }
+    if (c >= 0xF0 && c <= 0xF4) {
+      if (left < 4 || (p[1] & 0xC0) != 0x80 || (p[2] & 0xC0) != 0x80 || (p[3] & 0xC0) != 0x80) {
+        return utf8_invalid;
+      }
+      // F0 90..BF: no overlong, F4 80..8F: at most U+10FFFF
+      if ((c == 0xF0 && p[1] < 0x90) || (c == 0xF4 && p[1] > 0x8F)) {
+        return utf8_invalid;
+      }
+      p += 4;
+      n += 2;
+      continue;
+    }
+    return utf8_invalid;
+  }
+  return n;
+}
+
+// utf8_to_utf16_scalar decode one valid sequence, returns the next input byte
+inline const uint8_t *utf8_to_utf16_scalar(const uint8_t *p, char16_t *&out) {
+  const auto c = *p;
+  if (c < 0x80) {
+    *out++ = c;
+    return p + 1;
+  }
+  if (c < 0xE0) {
+    *out++ = static_cast<char16_t>(((c & 0x1F) << 6) | (p[1] & 0x3F));
+    return p + 2;
+  }
+  if (c < 0xF0) {
+    *out++ = static_cast<char16_t>(((c & 0x0F) << 12) | ((p[1] & 0x3F) << 6) | (p[2] & 0x3F));
+    return p + 3;
+  }
+  const auto rune = ((c & 0x07U) << 18) | ((p[1] & 0x3FU) << 12) | ((p[2] & 0x3FU) << 6) | (p[3] & 0x3FU);
+  out[0] = static_cast<char16_t>(0xD7C0 + (rune >> 10));
+  out[1] = static_cast<char16_t>(0xDC00 + (rune & 0x3FF));
+  out += 2;
+  return p + 4;
+}
+
+// utf8_to_utf16_scalar transcode valid UTF-8 [p, end), returns one past the last unit written
+inline char16_t *utf8_to_utf16_scalar(const uint8_t *p, const uint8_t *end, char16_t *out) {
+  while (p < end) {
+    if (end - p >= 8) {
+      uint64_t v;
+      std::memcpy(&v, p, 8);
+      if ((v & 0x8080808080808080ULL) == 0) {
+        for (int i = 0; i < 8; i++) {
+          out[i] = p[i];
+        }
+        p += 8;
+        out += 8;
+        continue;
+      }
+    }
+    p = utf8_to_utf16_scalar(p, out);
+  }
+  return out;
+}
+
+// Multibyte windows, after simdutf (https://github.com/simdutf/simdutf, Apache-2.0/MIT):
+// bit i of a 12-bit mask is set when byte i of a 16-byte window ends a code point. The mask picks a shape, either six
+// code points of one or two bytes (16-bit lanes) or four code points of one to three bytes (32-bit lanes), and the
+// shape's shuffle moves every code point into its own lane with the last byte lowest. Windows starting with a four
+// byte sequence, or with a longer one among the first four, have no shape and are decoded one code point at a time.
+enum WindowKind : uint8_t {
+  window_scalar = 0,
+  window_six = 1,  // 6 x (1..2 bytes) -> 6 units
+  window_four = 2, // 4 x (1..3 bytes) -> 4 units
+};
+struct WindowShape {
+  uint8_t kind;
+  uint8_t consumed; // input bytes of the code points in the window
+  uint8_t shuffle;  // index into WindowTables::shuffles
+};
+struct WindowTables {
+  static constexpr size_t six_shapes = 64;  // 2^6
+  static constexpr size_t four_shapes = 81; // 3^4
+  constexpr WindowTables() {
+    for (uint32_t i = 0; i < six_shapes; i++) {
+      uint8_t pos = 0;
+      for (uint32_t j = 0; j < 6; j++) {
+        const bool two = ((i >> j) & 1) != 0;
+        shuffles[i][j * 2] = static_cast<uint8_t>(two ? pos + 1 : pos);
+        shuffles[i][j * 2 + 1] = static_cast<uint8_t>(two ? pos : 0x80);
+        pos = static_cast<uint8_t>(pos + (two ? 2 : 1));
+      }
+      shuffles[i][12] = shuffles[i][13] = shuffles[i][14] = shuffles[i][15] = 0x80;
+    }
+    for (uint32_t i = 0; i < four_shapes; i++) {
+      uint8_t pos = 0;
+      uint32_t rest = i;
+      for (uint32_t j = 0; j < 4; j++) {
+        const auto len = static_cast<uint8_t>(rest % 3 + 1);
+        rest /= 3;
+        auto *lane = shuffles[six_shapes + i] + j * 4;
+        for (uint8_t k = 0; k < 4; k++) {
+          lane[k] = k < len ? static_cast<uint8_t>(pos + len - 1 - k) : 0x80;
+        }
+        pos = static_cast<uint8_t>(pos + len);
+      }
+    }
+    for (uint32_t mask = 0; mask < 4096; mask++) {
+      uint8_t lens[12]{};
+      uint32_t count = 0;
+      uint32_t start = 0;
+      for (uint32_t b = 0; b < 12; b++) {
+        if (((mask >> b) & 1) != 0) {
+          lens[count++] = static_cast<uint8_t>(b + 1 - start);
+          start = b + 1;
+        }
+      }
+      auto &shape = shapes[mask];
+      if (count >= 6 && lens[0] <= 2 && lens[1] <= 2 && lens[2] <= 2 && lens[3] <= 2 && lens[4] <= 2 && lens[5] <= 2) {
+        uint32_t id = 0;
+        uint32_t consumed = 0;
+        for (uint32_t j = 0; j < 6; j++) {
+          id |= static_cast<uint32_t>(lens[j] == 2) << j;
+          consumed += lens[j];
+        }
+        shape = {window_six, static_cast<uint8_t>(consumed), static_cast<uint8_t>(id)};
+        continue;
+      }
+      if (count >= 4 && lens[0] <= 3 && lens[1] <= 3 && lens[2] <= 3 && lens[3] <= 3) {
+        uint32_t id = 0;
+        uint32_t consumed = 0;
+        for (uint32_t j = 4; j-- > 0;) {
+          id = id * 3 + (lens[j] - 1);
+          consumed += lens[j];
+        }
+        shape = {window_four, static_cast<uint8_t>(consumed), static_cast<uint8_t>(six_shapes + id)};
+        continue;
+      }
+      shape = {window_scalar, 0, 0};
+    }
+  }
+  WindowShape shapes[4096]{};
+  uint8_t shuffles[six_shapes + four_shapes][16]{};
+};
+// constant initialized where the compiler's constexpr budget allows, a guarded dynamic initialization otherwise
+inline const WindowTables &GetWindowTables() {
+  static const WindowTables tables;
+  return tables;
+}
+
+// Validation after Keiser and Lemire, "Validating UTF-8 In Less Than One Instruction Per Byte" (2021): three 16-entry
+// lookups keyed by the high and low nibble of the previous byte and the high nibble of the current byte flag every
+// malformed two byte pattern, the third and fourth bytes of long sequences are checked against the leads 2 and 3 back.
+constexpr uint8_t too_short = 1 << 0;
+constexpr uint8_t too_long = 1 << 1;
+constexpr uint8_t overlong_3 = 1 << 2;
+constexpr uint8_t too_large = 1 << 3;
+constexpr uint8_t surrogate = 1 << 4;
+constexpr uint8_t overlong_2 = 1 << 5;
+constexpr uint8_t too_large_1000 = 1 << 6;
+constexpr uint8_t overlong_4 = 1 << 6;
+constexpr uint8_t two_conts = 1 << 7;
+constexpr uint8_t carry = too_short | too_long | two_conts;
+
+// clang-format off
+inline constexpr uint8_t byte_1_high[16] = {
+    // 0_______ ________ ASCII in byte 1
+    too_long, too_long, too_long, too_long, too_long, too_long, too_long, too_long,
+    // 10______ ________ continuation in byte 1
+    two_conts, two_conts, two_conts, two_conts,
+    // 1100____ ________ two byte lead
+    too_short | overlong_2,
+    // 1101____ ________ two byte lead
+    too_short,
+    // 1110____ ________ three byte lead
+    too_short | overlong_3 | surrogate,
+    // 1111____ ________ four byte lead
+    too_short | too_large | too_large_1000 | overlong_4};
+inline constexpr uint8_t byte_1_low[16] = {
+    carry | overlong_3 | overlong_2 | overlong_4, // ____0000
+    carry | overlong_2,                           // ____0001
+    carry, carry,                                 // ____001_
+    carry | too_large,                            // ____0100
+    carry | too_large | too_large_1000,           // ____0101
+    carry | too_large | too_large_1000, carry | too_large | too_large_1000,
+    carry | too_large | too_large_1000, carry | too_large | too_large_1000,
+    carry | too_large | too_large_1000, carry | too_large | too_large_1000,
+    carry | too_large | too_large_1000,
+    carry | too_large | too_large_1000 | surrogate, // ____1101
+    carry | too_large | too_large_1000, carry | too_large | too_large_1000};
+inline constexpr uint8_t byte_2_high[16] = {
+    // ________ 0_______ ASCII in byte 2
+    too_short, too_short, too_short, too_short, too_short, too_short, too_short, too_short,
+    // ________ 1000____
+    too_long | overlong_2 | two_conts | overlong_3 | too_large_1000 | overlong_4,
+    // ________ 1001____
+    too_long | overlong_2 | two_conts | overlong_3 | too_large,
+    // ________ 101_____
+    too_long | overlong_2 | two_conts | surrogate | too_large,
+    too_long | overlong_2 | two_conts | surrogate | too_large,
+    // ________ 11______ lead in byte 2
+    too_short, too_short, too_short, too_short};
+// clang-format on
+
+#if defined(BELA_CPU_X86)
+size_t utf16_length_sse41(const uint8_t *p, size_t len);
+char16_t *utf8_to_utf16_sse41(const uint8_t *p, size_t len, char16_t *out, char16_t *out_end);
+size_t utf16_length_avx2(const uint8_t *p, size_t len);
+char16_t *utf8_to_utf16_avx2(const uint8_t *p, size_t len, char16_t *out, char16_t *out_end);
+#endif
+} // namespace bela::codecvt_internal
+
+#endif
@@ -0,0 +1,59 @@
+/// UTF-8 to UTF-16 SSE4.1 backend
+// GCC/Clang: compile with -msse4.1
+#include "codecvt_x86.hpp"
+
+namespace bela::codecvt_internal {
+size_t utf16_length_sse41(const uint8_t *p, size_t len) {
+  Utf8Checker128 checker;
+  auto units = _mm_setzero_si128();
+  size_t ascii = 0;
+  size_t padding = 0;
+  size_t i = 0;
+  for (; i + 16 <= len; i += 16) {
+    const auto input = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p + i));
+    checker.Check(input);
+    if (_mm_movemask_epi8(input) == 0) {
+      ascii += 16;
+      continue;
+    }
+    units = _mm_add_epi64(units, utf16_units(input));
+  }
+  if (i < len) {
+    // zero padding is ASCII, a sequence cut by the end of input fails as too short
+    alignas(16) uint8_t tail[16] = {0};
+    std::memcpy(tail, p + i, len - i);
+    const auto input = _mm_load_si128(reinterpret_cast<const __m128i *>(tail));
+    checker.Check(input);
+    units = _mm_add_epi64(units, utf16_units(input));
+    padding = 16 - (len - i);
+  }
+  if (checker.Failed()) {
+    return utf8_invalid;
+  }
+  uint64_t lanes[2];
+  _mm_storeu_si128(reinterpret_cast<__m128i *>(lanes), units);
+  return ascii + static_cast<size_t>(lanes[0] + lanes[1]) - padding;
+}
+
+char16_t *utf8_to_utf16_sse41(const uint8_t *p, size_t len, char16_t *out, char16_t *out_end) {
+  const auto end = p + len;
+  const auto &t = GetWindowTables();
+  while (end - p >= 64 && out_end - out >= 64) {
+    uint64_t ascii = 0;
+    uint64_t noncont = 0;
+    for (uint32_t i = 0; i < 4; i++) {
+      chunk_masks(_mm_loadu_si128(reinterpret_cast<const __m128i *>(p + i * 16)), ascii, noncont, i * 16);
+    }
+    if (ascii == 0) {
+      for (uint32_t i = 0; i < 4; i++) {
+        store_widened(out + i * 16, _mm_loadu_si128(reinterpret_cast<const __m128i *>(p + i * 16)));
+      }
+      p += 64;
+      out += 64;
+      continue;
+    }
+    transcode_chunk(p, out, ascii, noncont >> 1, 48, t);
+  }
+  return transcode_tail(p, end, out, out_end, t);
+}
+} // namespace bela::codecvt_internal
@@ -0,0 +1,150 @@
+///
+#ifndef BELA_CODECVT_X86_HPP
+#define BELA_CODECVT_X86_HPP
+// only included by translation units compiled with SSE4.1 (or newer) enabled, everything here has internal linkage
+// so the SSE4.1 and AVX2 builds of the same function never merge
+#include <immintrin.h>
+#include <bela/bits.hpp>
+#include "codecvt_impl.hpp"
+
+namespace bela::codecvt_internal {
+namespace {
+inline __m128i load_table(const uint8_t (&table)[16]) {
+  return _mm_loadu_si128(reinterpret_cast<const __m128i *>(table));
+}
+
+// store_widened zero extend 16 bytes to 16 UTF-16 units
+inline void store_widened(char16_t *out, __m128i in) {
+  _mm_storeu_si128(reinterpret_cast<__m128i *>(out), _mm_cvtepu8_epi16(in));
+  _mm_storeu_si128(reinterpret_cast<__m128i *>(out + 8), _mm_cvtepu8_epi16(_mm_srli_si128(in, 8)));
+}
+
+// transcode_chunk transcode a chunk of 16-byte blocks of p, windows start at offsets up to limit (chunk size - 16).
+// ascii has bit i set when byte i is not ASCII, ends when byte i + 1 is not a continuation (byte i ends a code point).
+// Both masks are computed up front for the whole chunk, so the only dependency from one window to the next is the
+// table lookup that tells how far it went. Writes up to limit + 16 units.
+inline void transcode_chunk(const uint8_t *&p, char16_t *&out, uint64_t ascii, uint64_t ends, size_t limit,
+                            const WindowTables &t) {
+  size_t pos = 0;
+  while (pos <= limit) {
+    const auto in = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p + pos));
+    if (static_cast<uint16_t>(ascii >> pos) == 0) {
+      store_widened(out, in);
+      pos += 16;
+      out += 16;
+      continue;
+    }
+    const auto &shape = t.shapes[(ends >> pos) & 0xFFF];
+    if (shape.kind == window_six) {
+      const auto v = _mm_shuffle_epi8(in, load_table(t.shuffles[shape.shuffle]));
+      const auto low = _mm_and_si128(v, _mm_set1_epi16(0x7F));
+      const auto high = _mm_srli_epi16(_mm_and_si128(v, _mm_set1_epi16(0x1F00)), 2);
+      _mm_storeu_si128(reinterpret_cast<__m128i *>(out), _mm_or_si128(low, high));
+      pos += shape.consumed;
+      out += 6;
+      continue;
+    }
+    if (shape.kind == window_four) {
+      const auto v = _mm_shuffle_epi8(in, load_table(t.shuffles[shape.shuffle]));
+      const auto low = _mm_and_si128(v, _mm_set1_epi32(0x7F));
+      const auto middle = _mm_srli_epi32(_mm_and_si128(v, _mm_set1_epi32(0x3F00)), 2);
+      const auto high = _mm_srli_epi32(_mm_and_si128(v, _mm_set1_epi32(0x0F0000)), 4);
+      const auto units = _mm_or_si128(_mm_or_si128(low, middle), high);
+      _mm_storel_epi64(reinterpret_cast<__m128i *>(out), _mm_packus_epi32(units, units));
+      pos += shape.consumed;
+      out += 4;
+      continue;
+    }
+    pos = static_cast<size_t>(utf8_to_utf16_scalar(p + pos, out) - p);
+  }
+  p += pos;
+}
+
+// chunk_masks non-ASCII and code point end masks of one 16-byte block, to be shifted into place
+inline void chunk_masks(__m128i in, uint64_t &ascii, uint64_t &noncont, uint32_t shift) {
+  ascii |= static_cast<uint64_t>(static_cast<uint32_t>(_mm_movemask_epi8(in))) << shift;
+  // continuation bytes 0x80..0xBF are the signed bytes below -64
+  const auto cont = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmplt_epi8(in, _mm_set1_epi8(-64))));
+  noncont |= static_cast<uint64_t>(~cont & 0xFFFF) << shift;
+}
+
+// transcode_tail the input a 64-byte chunk loop leaves, through stack buffers so short strings take the SIMD path too.
+// out_end - out is the exact UTF-16 length of [p, end).
+inline char16_t *transcode_tail(const uint8_t *p, const uint8_t *end, char16_t *out, char16_t *out_end,
+                                const WindowTables &t) {
+  // the loop stops early when the output has less than 64 units of room, valid UTF-8 is at most 3 bytes per unit
+  while (end - p >= 64) {
+    p = utf8_to_utf16_scalar(p, out);
+  }
+  const auto len = static_cast<size_t>(end - p);
+  if (len == 0) {
+    return out;
+  }
+  // zero padding is ASCII, whatever it decodes to lands after the units that are copied out
+  alignas(16) uint8_t in[64 + 16] = {0};
+  char16_t units[64];
+  std::memcpy(in, p, len);
+  uint64_t ascii = 0;
+  uint64_t noncont = 0;
+  for (uint32_t i = 0; i < 4; i++) {
+    chunk_masks(_mm_load_si128(reinterpret_cast<const __m128i *>(in + i * 16)), ascii, noncont, i * 16);
+  }
+  const uint8_t *q = in;
+  char16_t *o = units;
+  transcode_chunk(q, o, ascii, noncont >> 1, 48, t);
+  if (q < in + len) {
+    utf8_to_utf16_scalar(q, in + len, o);
+  }
+  std::memcpy(out, units, static_cast<size_t>(out_end - out) * sizeof(char16_t));
+  return out_end;
+}
+
+// Utf8Checker128 Keiser-Lemire validation 16 bytes at a time
+struct Utf8Checker128 {
+  __m128i error{_mm_setzero_si128()};
+  __m128i prev_input{_mm_setzero_si128()};
+  __m128i prev_incomplete{_mm_setzero_si128()};
+
+  void Check(__m128i input) {
+    if (_mm_movemask_epi8(input) == 0) {
+      // a sequence cut at the end of the previous block can't continue with ASCII
+      error = _mm_or_si128(error, prev_incomplete);
+      prev_incomplete = _mm_setzero_si128();
+      prev_input = input;
+      return;
+    }
+    const auto nibble = _mm_set1_epi8(0x0F);
+    const auto prev1 = _mm_alignr_epi8(input, prev_input, 15);
+    const auto b1h = _mm_shuffle_epi8(load_table(byte_1_high), _mm_and_si128(_mm_srli_epi16(prev1, 4), nibble));
+    const auto b1l = _mm_shuffle_epi8(load_table(byte_1_low), _mm_and_si128(prev1, nibble));
+    const auto b2h = _mm_shuffle_epi8(load_table(byte_2_high), _mm_and_si128(_mm_srli_epi16(input, 4), nibble));
+    const auto special = _mm_and_si128(_mm_and_si128(b1h, b1l), b2h);
+    // third and fourth bytes: a three (four) byte lead two (three) bytes back
+    const auto prev2 = _mm_alignr_epi8(input, prev_input, 14);
+    const auto prev3 = _mm_alignr_epi8(input, prev_input, 13);
+    const auto must23 = _mm_or_si128(_mm_subs_epu8(prev2, _mm_set1_epi8(static_cast<char>(0xE0 - 0x80))),
+                                     _mm_subs_epu8(prev3, _mm_set1_epi8(static_cast<char>(0xF0 - 0x80))));
+    const auto must23_80 = _mm_and_si128(must23, _mm_set1_epi8(static_cast<char>(0x80)));
+    error = _mm_or_si128(error, _mm_xor_si128(must23_80, special));
+    // a lead in the last three bytes that needs more bytes than the block has left
+    const auto max_value = _mm_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+                                         static_cast<char>(0xF0 - 1), static_cast<char>(0xE0 - 1),
+                                         static_cast<char>(0xC0 - 1));
+    prev_incomplete = _mm_subs_epu8(input, max_value);
+    prev_input = input;
+  }
+  bool Failed() const { return _mm_testz_si128(_mm_or_si128(error, prev_incomplete), _mm_set1_epi8(-1)) == 0; }
+};
+
+// utf16_units UTF-16 length of a valid 16-byte block in the two 64-bit lanes: every byte but continuations, four
+// byte leads count twice
+inline __m128i utf16_units(__m128i input) {
+  const auto counted = _mm_cmpgt_epi8(input, _mm_set1_epi8(-65));
+  const auto lead4 = _mm_cmpeq_epi8(_mm_max_epu8(input, _mm_set1_epi8(static_cast<char>(0xF0))), input);
+  const auto zero = _mm_setzero_si128();
+  return _mm_sad_epu8(_mm_sub_epi8(zero, _mm_add_epi8(counted, lead4)), zero);
+}
+} // namespace
+} // namespace bela::codecvt_internal
+
+#endif
@@ -0,0 +1,85 @@
+///
+#include <algorithm>
+#include <bela/cord.hpp>
+
+namespace bela {
+Cord &Cord::AppendPieces(std::initializer_list<std::wstring_view> pieces) {
+  size_t n = 0;
+  for (const auto p : pieces) {
+    n += p.size();
+  }
+  if (n == 0) {
+    return *this;
+  }
+  // pieces of one call stay in one chunk, the tail never reallocates
+  if (chunks.empty() || chunks.back().capacity() - chunks.back().size() < n) {
+    auto &c = chunks.emplace_back();
+    c.reserve((std::max)(next_chunk, n));
+    next_chunk = (std::min)(next_chunk * 2, max_chunk);
+  }
+  auto &tail = chunks.back();
+  for (const auto p : pieces) {
+    tail.append(p);
+  }
+  size_ += n;
+  return *this;
+}
+
+Cord &Cord::AppendOwned(std::wstring &&s) {
+  if (s.size() < min_owned) {
+    return AppendPieces({s});
+  }
+  size_ += s.size();
+  chunks.emplace_back(std::move(s));
+  return *this;
+}
+
+Cord &Cord::Append(const Cord &other) {
+  if (this == &other) {
+    // the chunks vector may reallocate while it is being read
+    Cord copy(other);
+    return Append(std::move(copy));
+  }
+  for (const auto &c : other.chunks) {
+    if (c.size() < min_owned) {
+      AppendPieces({c});
+      continue;
+    }
+    size_ += c.size();
+    chunks.emplace_back(c);
+  }
+  return *this;
+}
+
+Cord &Cord::Append(Cord &&other) {
+  if (this == &other) {
+    return Append(static_cast<const Cord &>(other));
+  }
+  if (empty()) {
+    MoveFrom(other);
+    return *this;
+  }
+  for (auto &c : other.chunks) {
+    AppendOwned(std::move(c));
+  }
+  other.clear();
+  return *this;
+}
+
+std::wstring_view Cord::Flatten() {
+  if (chunks.size() > 1) {
+    chunks.front() = str();
+    chunks.resize(1);
+  }
+  return chunks.empty() ? std::wstring_view() : std::wstring_view(chunks.front());
+}
+
+std::wstring Cord::str() const {
+  std::wstring s;
+  s.reserve(size_);
+  for (const auto &c : chunks) {
+    s.append(c);
+  }
+  return s;
+}
+} // namespace bela
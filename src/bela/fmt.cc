@@ -11,7 +11,7 @@
 namespace bela {
 namespace format_internal {
 constexpr const size_t npos = static_cast<size_t>(-1);
-size_t memsearch(const wchar_t *begin, const wchar_t *end, int ch) {
+template <typename CharT> size_t memsearch(const CharT *begin, const CharT *end, int ch) {
   for (auto it = begin; it != end; it++) {
     if (*it == ch) {
       return it - begin;
@@ -20,80 +20,164 @@ size_t memsearch(const wchar_t *begin, const wchar_t *end, int ch) {
   return npos;
 }
 
-const wchar_t *Decimal(uint64_t value, wchar_t *digits, bool sign) {
-  wchar_t *const end = digits + kFastToBufferSize;
-  wchar_t *writer = end;
-  constexpr const wchar_t dec[] = L"0123456789";
-  do {
-    *--writer = dec[value % 10];
-    value = value / 10;
-  } while (value != 0);
+// Decimal right-aligned at digits + kFastToBufferSize, the caller takes [result, digits + kFastToBufferSize)
+template <typename CharT> const CharT *Decimal(uint64_t value, CharT *digits, bool sign) {
+  CharT *writer = digits + kFastToBufferSize - numbers_internal::DigitCount(value);
+  numbers_internal::WriteDecimal(value, writer);
   if (sign) {
-    *--writer = L'-';
+    *--writer = '-';
   }
   return writer;
 }
 
-const wchar_t *AlphaNum(uint64_t value, wchar_t *digits, size_t width, int base, wchar_t fill, bool u) {
-  wchar_t *const end = digits + kFastToBufferSize;
-  wchar_t *writer = end;
-  constexpr const wchar_t hex[] = L"0123456789abcdef";
-  constexpr const wchar_t uhex[] = L"0123456789ABCDEF";
-  auto w = (std::min)(width, kFastToBufferSize);
-  switch (base) {
-  case 8:
-    do {
-      *--writer = static_cast<wchar_t>('0' + (value & 0x7));
-      value >>= 3;
-    } while (value != 0);
+using StringWriter = Writer<std::wstring>;
+using BufferWriter = Writer<buffer>;
+using NarrowStringWriter = Writer<std::string>;
+using NarrowBufferWriter = Writer<basic_buffer<char>>;
+
+// FormatOne write one argument directive
+template <typename T>
+void FormatOne(Writer<T> &w, const FormatOp &op, const FormatArg &arg, typename Writer<T>::char_type *digits) {
+  using char_type = typename Writer<T>::char_type;
+  const auto dend = digits + kFastToBufferSize;
+  auto width = op.width;
+  auto pc = op.pc;
+  auto left = op.left;
+  switch (op.verb) {
+  case 'b':
+    switch (arg.at) {
+    case ArgType::BOOLEAN:
+    case ArgType::CHARACTER:
+      w.AddBoolean(arg.character.c != 0);
+      break;
+    case ArgType::INTEGER:
+    case ArgType::UINTEGER:
+      w.AddBoolean(arg.integer.i != 0);
+      break;
+    default:
+      break;
+    }
     break;
-  case 16:
-    if (u) {
-      do {
-        *--writer = uhex[value & 0xF];
-        value >>= 4;
-      } while (value != 0);
+  case 'c':
+    switch (arg.at) {
+    case ArgType::CHARACTER:
+      w.AddUnicode(arg.character.c, width, arg.character.width);
+      break;
+    case ArgType::UINTEGER:
+    case ArgType::INTEGER:
+      w.AddUnicode(static_cast<char32_t>(arg.integer.i), width, arg.integer.width > 2 ? 4 : arg.integer.width);
+      break;
+    default:
+      break;
+    }
+    break;
+  case 's':
+    if constexpr (sizeof(char_type) == 1) {
+      // UTF-8 output, only wide strings need converting
+      if (arg.at == ArgType::USTRING) {
+        w.Append(arg.ustring.data, arg.ustring.len, width, pc, left);
+      } else if (arg.at == ArgType::STRING) {
+        auto us = bela::ToNarrow(arg.strings.data, arg.strings.len);
+        w.Append(us.data(), us.size(), width, pc, left);
+      }
     } else {
-      do {
-        *--writer = hex[value & 0xF];
-        value >>= 4;
-      } while (value != 0);
+      if (arg.at == ArgType::STRING) {
+        w.Append(arg.strings.data, arg.strings.len, width, pc, left);
+      } else if (arg.at == ArgType::USTRING) {
+        auto ws = bela::ToWide(arg.ustring.data, arg.ustring.len);
+        w.Append(ws.data(), ws.size(), width, pc, left);
+      }
+    }
+    break;
+  case 'd':
+    if (arg.at != ArgType::STRING) {
+      bool sign = false;
+      auto val = arg.ToInteger(&sign);
+      if (sign) {
+        pc = ' '; /// when sign ignore '0
+      }
+      auto p = Decimal(val, digits, sign);
+      w.Append(p, dend - p, width, pc, left);
+    }
+    break;
+  case 'o':
+    if (arg.at != ArgType::STRING) {
+      auto val = arg.ToInteger();
+      auto p = AlphaNum<char_type>(val, digits, 0, 8);
+      w.Append(p, dend - p, width, pc, left);
+    }
+    break;
+  case 'x':
+    if (arg.at != ArgType::STRING) {
+      auto val = arg.ToInteger();
+      auto p = AlphaNum<char_type>(val, digits, 0, 16);
+      w.Append(p, dend - p, width, pc, left);
+    }
+    break;
+  case 'X':
+    if (arg.at != ArgType::STRING) {
+      auto val = arg.ToInteger();
+      auto p = AlphaNum<char_type>(val, digits, 0, 16, ' ', true);
+      w.Append(p, dend - p, width, pc, left);
+    }
+    break;
+  case 'U':
+    switch (arg.at) {
+    case ArgType::CHARACTER:
+      w.AddUnicodePoint(arg.character.c);
+      break;
+    case ArgType::INTEGER:
+    case ArgType::UINTEGER:
+      w.AddUnicodePoint(static_cast<char32_t>(arg.integer.i));
+      break;
+    default:
+      break;
+    }
+    break;
+  case 'f':
+  case 'e':
+  case 'g':
+  case 'v':
+    if (arg.at == ArgType::FLOAT) {
+      w.Floating(arg.floating.d, op);
+    }
+    break;
+  case 'a':
+    if (arg.at == ArgType::FLOAT) {
+      union {
+        double d;
+        uint64_t i;
+      } x;
+      x.d = arg.floating.d;
+      auto p = AlphaNum<char_type>(x.i, digits, 0, 16);
+      w.Append(p, dend - p, width, pc, left);
+    }
+    break;
+  case 'p':
+    if (arg.at == ArgType::POINTER) {
+      auto ptr = reinterpret_cast<ptrdiff_t>(arg.ptr);
+      constexpr auto plen = sizeof(intptr_t) * 2;
+      auto p = AlphaNum<char_type>(ptr, digits, plen, 16, '0', true);
+      w.AddASCII("0x");      /// Force append 0x to pointer
+      w.Append(p, dend - p); // 0xffff00000;
     }
     break;
   default:
-    do {
-      *--writer = hex[value % 10];
-      value = value / 10;
-    } while (value != 0);
     break;
   }
-  wchar_t *beg;
-  if ((size_t)(end - writer) < w) {
-    beg = end - w;
-    std::fill_n(beg, writer - beg, fill);
-  } else {
-    beg = writer;
-  }
-  return beg;
 }
 
-using StringWriter = Writer<std::wstring>;
-using BufferWriter = Writer<buffer>;
-
 /// because format string is Null-terminated_string
-template <typename T> bool StrFormatInternal(Writer<T> &w, const wchar_t *fmt, const FormatArg *args, size_t max_args) {
+template <typename T>
+bool StrFormatInternal(Writer<T> &w, const typename Writer<T>::char_type *fmt, const FormatArg *args, size_t max_args) {
+  using char_type = typename Writer<T>::char_type;
   if (args == nullptr || max_args == 0) {
     return false;
   }
-  wchar_t digits[kFastToBufferSize];
-  const auto dend = digits + kFastToBufferSize;
+  char_type digits[kFastToBufferSize];
   auto it = fmt;
-  auto end = it + wcslen(fmt);
+  auto end = it + std::char_traits<char_type>::length(fmt);
   size_t ca = 0;
-  wchar_t pc;
-  uint32_t width;
-  uint32_t frac_width;
-  bool left = false;
   while (it < end) {
     ///  Fast search %,
     auto pos = memsearch(it, end, '%');
@@ -107,183 +191,51 @@ template <typename T> bool StrFormatInternal(Writer<T> &w, const wchar_t *fmt, c
     if (it >= end) {
       break;
     }
-    left = (*it == '-');
-    if (left) {
+    FormatOp op;
+    op.left = (*it == '-');
+    if (op.left) {
       it++;
-      pc = ' ';
     } else {
-      pc = (*it == '0') ? '0' : ' ';
+      op.pc = (*it == '0') ? '0' : ' ';
     }
     // Parse ---
-    width = 0;
-    frac_width = 0;
     while (*it >= '0' && *it <= '9') {
-      width = width * 10 + (*it++ - '0');
+      op.width = op.width * 10 + (*it++ - '0');
     }
     if (*it == '.') {
+      op.has_frac = true;
       it++;
       while (*it >= '0' && *it <= '9') {
-        frac_width = frac_width * 10 + (*it++ - '0');
+        op.frac_width = op.frac_width * 10 + (*it++ - '0');
       }
     }
-    switch (*it) {
-    case 'b':
-      if (ca >= max_args) {
-        return false;
-      }
-      switch (args[ca].at) {
-      case ArgType::BOOLEAN:
-      case ArgType::CHARACTER:
-        w.AddBoolean(args[ca].character.c != 0);
-        break;
-      case ArgType::INTEGER:
-      case ArgType::UINTEGER:
-        w.AddBoolean(args[ca].integer.i != 0);
-        break;
-      default:
-        break;
-      }
-      ca++;
-      break;
-    case 'c':
-      if (ca >= max_args) {
-        return false;
-      }
-      switch (args[ca].at) {
-      case ArgType::CHARACTER:
-        w.AddUnicode(args[ca].character.c, width, args[ca].character.width);
-        break;
-      case ArgType::UINTEGER:
-      case ArgType::INTEGER:
-        w.AddUnicode(static_cast<char32_t>(args[ca].integer.i), width,
-                     args[ca].integer.width > 2 ? 4 : args[ca].integer.width);
-        break;
-      default:
-        break;
-      }
-      ca++;
-      break;
-    case 's':
-      if (ca >= max_args) {
-        return false;
-      }
-      if (args[ca].at == ArgType::STRING) {
-        w.Append(args[ca].strings.data, args[ca].strings.len, width, pc, left);
-      } else if (args[ca].at == ArgType::USTRING) {
-        auto ws = bela::ToWide(args[ca].ustring.data, args[ca].ustring.len);
-        w.Append(ws.data(), ws.size(), width, pc, left);
-      }
-      ca++;
-      break;
-    case 'd':
-      if (ca >= max_args) {
-        return false;
-      }
-      if (args[ca].at != ArgType::STRING) {
-        bool sign = false;
-        size_t off = 0;
-        auto val = args[ca].ToInteger(&sign);
-        if (sign) {
-          pc = ' '; /// when sign ignore '0
-        }
-        auto p = Decimal(val, digits + off, sign);
-        w.Append(p, dend - p + off, width, pc, left);
-      }
-      ca++;
-      break;
-    case 'o':
-      if (ca >= max_args) {
-        return false;
-      }
-      if (args[ca].at != ArgType::STRING) {
-        auto val = args[ca].ToInteger();
-        auto p = AlphaNum(val, digits, 0, 8);
-        w.Append(p, dend - p, width, pc, left);
-      }
-      ca++;
-      break;
-    case 'x':
-      if (ca >= max_args) {
-        return false;
-      }
-      if (args[ca].at != ArgType::STRING) {
-        auto val = args[ca].ToInteger();
-        auto p = AlphaNum(val, digits, 0, 16);
-        w.Append(p, dend - p, width, pc, left);
-      }
-      ca++;
-      break;
-    case 'X':
-      if (ca >= max_args) {
-        return false;
-      }
-      if (args[ca].at != ArgType::STRING) {
-        auto val = args[ca].ToInteger();
-        auto p = AlphaNum(val, digits, 0, 16, ' ', true);
-        w.Append(p, dend - p, width, pc, left);
-      }
-      ca++;
-      break;
-    case 'U':
-      if (ca >= max_args) {
-        return false;
-      }
-      switch (args[ca].at) {
-      case ArgType::CHARACTER:
-        w.AddUnicodePoint(args[ca].character.c);
-        break;
-      case ArgType::INTEGER:
-      case ArgType::UINTEGER:
-        w.AddUnicodePoint(static_cast<char32_t>(args[ca].integer.i));
-        break;
-      default:
-        break;
-      }
-      ca++;
-      break;
-    case 'f':
-      if (ca >= max_args) {
-        return false;
-      }
-      if (args[ca].at == ArgType::FLOAT) {
-        w.Floating(args[ca].floating.d, width, frac_width, pc);
-      }
-      ca++;
-      break;
-    case 'a':
-      if (ca >= max_args) {
-        return false;
-      }
-      if (args[ca].at == ArgType::FLOAT) {
-        union {
-          double d;
-          uint64_t i;
-        } x;
-        x.d = args[ca].floating.d;
-        auto p = AlphaNum(x.i, digits, 0, 16);
-        w.Append(p, dend - p, width, pc, left);
-      }
-      ca++;
-      break;
-    case 'p':
-      if (ca >= max_args) {
-        return false;
-      }
-      if (args[ca].at == ArgType::POINTER) {
-        auto ptr = reinterpret_cast<ptrdiff_t>(args[ca].ptr);
-        constexpr auto plen = sizeof(intptr_t) * 2;
-        auto p = AlphaNum(ptr, digits, plen, 16, '0', true);
-        w.Append(L"0x", 2);    /// Force append 0x to pointer
-        w.Append(p, dend - p); // 0xffff00000;
-      }
-      ca++;
-      break;
-    default:
+    if (!IsArgVerb(*it)) {
       // % and other
-      w.Add(*it);
-      break;
+      w.Add(*it++);
+      continue;
+    }
+    if (ca >= max_args) {
+      return false;
     }
-    it++;
+    op.verb = *it++;
+    FormatOne(w, op, args[ca++], digits);
+  }
+  return !w.overflow();
+}
+
+// StrFormatInternal replay ops decoded by bela::Format, no parsing and no argument checks
+template <typename T>
+bool StrFormatInternal(Writer<T> &w, const typename Writer<T>::char_type *fmt, const FormatOp *ops, size_t nops,
+                       const FormatArg *args) {
+  typename Writer<T>::char_type digits[kFastToBufferSize];
+  size_t ca = 0;
+  for (size_t i = 0; i < nops; i++) {
+    const auto &op = ops[i];
+    if (op.verb == 0) {
+      w.Append(fmt + op.offset, op.len);
+      continue;
+    }
+    FormatOne(w, op, args[ca++], digits);
   }
   return !w.overflow();
 }
@@ -313,41 +265,140 @@ ssize_t StrFormatInternal(wchar_t *buf, size_t N, const wchar_t *fmt, const Form
   }
   return static_cast<ssize_t>(buffer_.length());
 }
-} // namespace format_internal
 
-ssize_t StrFormat(wchar_t *buf, size_t N, const wchar_t *fmt) {
-  format_internal::buffer buffer_(buf, N);
+size_t StrAppendFormatInternal(std::wstring *buf, const wchar_t *fmt, const FormatOp *ops, size_t nops,
+                               const FormatArg *args) {
+  StringWriter sw(*buf);
+  StrFormatInternal(sw, fmt, ops, nops, args);
+  return static_cast<size_t>(buf->size());
+}
+
+std::wstring StrFormatInternal(const wchar_t *fmt, const FormatOp *ops, size_t nops, const FormatArg *args) {
   std::wstring s;
-  const wchar_t *src = fmt;
-  for (; *src != 0; ++src) {
-    buffer_.push_back(*src);
+  StringWriter sw(s);
+  StrFormatInternal(sw, fmt, ops, nops, args);
+  return s;
+}
+
+ssize_t StrFormatInternal(wchar_t *buf, size_t N, const wchar_t *fmt, const FormatOp *ops, size_t nops,
+                          const FormatArg *args) {
+  buffer buffer_(buf, N);
+  BufferWriter bw(buffer_);
+  if (!StrFormatInternal(bw, fmt, ops, nops, args)) {
+    return -1;
+  }
+  return static_cast<ssize_t>(buffer_.length());
+}
+
+size_t StrAppendFormatInternal(std::string *buf, const char *fmt, const FormatArg *args, size_t max_args) {
+  NarrowStringWriter sw(*buf);
+  if (!StrFormatInternal(sw, fmt, args, max_args)) {
+    return 0;
+  }
+  return static_cast<size_t>(buf->size());
+}
+
+std::string StrFormatInternal(const char *fmt, const FormatArg *args, size_t max_args) {
+  std::string s;
+  NarrowStringWriter sw(s);
+  if (!StrFormatInternal(sw, fmt, args, max_args)) {
+    return "";
+  }
+  return s;
+}
+
+ssize_t StrFormatInternal(char *buf, size_t N, const char *fmt, const FormatArg *args, size_t max_args) {
+  basic_buffer<char> buffer_(buf, N);
+  NarrowBufferWriter bw(buffer_);
+  if (!StrFormatInternal(bw, fmt, args, max_args)) {
+    return -1;
+  }
+  return static_cast<ssize_t>(buffer_.length());
+}
+
+bool AppendFormatChecked(basic_format_buffer<wchar_t> *buf, const wchar_t *fmt, const FormatArg *args, size_t max_args) {
+  Writer<basic_format_buffer<wchar_t>> w(*buf);
+  return StrFormatInternal(w, fmt, args, max_args);
+}
+
+size_t StrAppendFormatInternal(basic_format_buffer<wchar_t> *buf, const wchar_t *fmt, const FormatArg *args,
+                               size_t max_args) {
+  if (!AppendFormatChecked(buf, fmt, args, max_args)) {
+    return 0;
+  }
+  return buf->size();
+}
+
+size_t StrAppendFormatInternal(basic_format_buffer<wchar_t> *buf, const wchar_t *fmt, const FormatOp *ops, size_t nops,
+                               const FormatArg *args) {
+  Writer<basic_format_buffer<wchar_t>> w(*buf);
+  StrFormatInternal(w, fmt, ops, nops, args);
+  return buf->size();
+}
+
+size_t StrAppendFormatInternal(basic_format_buffer<char> *buf, const char *fmt, const FormatArg *args,
+                               size_t max_args) {
+  Writer<basic_format_buffer<char>> w(*buf);
+  if (!StrFormatInternal(w, fmt, args, max_args)) {
+    return 0;
+  }
+  return buf->size();
+}
+
+// without arguments only '%%' needs rewriting
+template <typename C, typename CharT> void UnescapePercent(C &c, const CharT *fmt) {
+  for (const CharT *src = fmt; *src != 0; ++src) {
+    c.push_back(*src);
     if (src[0] == '%' && src[1] == '%') {
       ++src;
     }
   }
+}
+} // namespace format_internal
+
+namespace narrow {
+ssize_t StrFormat(char *buf, size_t N, const char *fmt) {
+  format_internal::basic_buffer<char> buffer_(buf, N);
+  format_internal::UnescapePercent(buffer_, fmt);
+  return buffer_.overflow() ? -1 : static_cast<ssize_t>(buffer_.length());
+}
+
+size_t StrAppendFormat(std::string *buf, const char *fmt) {
+  format_internal::UnescapePercent(*buf, fmt);
+  return buf->size();
+}
+
+size_t StrAppendFormat(basic_format_buffer<char> *buf, const char *fmt) {
+  format_internal::UnescapePercent(*buf, fmt);
+  return buf->size();
+}
+
+std::string StrFormat(const char *fmt) {
+  std::string s;
+  format_internal::UnescapePercent(s, fmt);
+  return s;
+}
+} // namespace narrow
+
+ssize_t StrFormat(wchar_t *buf, size_t N, const wchar_t *fmt) {
+  format_internal::buffer buffer_(buf, N);
+  format_internal::UnescapePercent(buffer_, fmt);
   return buffer_.overflow() ? -1 : static_cast<ssize_t>(buffer_.length());
 }
 
 size_t StrAppendFormat(std::wstring *buf, const wchar_t *fmt) {
-  const wchar_t *src = fmt;
-  for (; *src != 0; ++src) {
-    buf->push_back(*src);
-    if (src[0] == '%' && src[1] == '%') {
-      ++src;
-    }
-  }
+  format_internal::UnescapePercent(*buf, fmt);
+  return buf->size();
+}
+
+size_t StrAppendFormat(basic_format_buffer<wchar_t> *buf, const wchar_t *fmt) {
+  format_internal::UnescapePercent(*buf, fmt);
   return buf->size();
 }
 
 std::wstring StrFormat(const wchar_t *fmt) {
   std::wstring s;
-  const wchar_t *src = fmt;
-  for (; *src != 0; ++src) {
-    s.push_back(*src);
-    if (src[0] == '%' && src[1] == '%') {
-      ++src;
-    }
-  }
+  format_internal::UnescapePercent(s, fmt);
   return s;
 }
 } // namespace bela
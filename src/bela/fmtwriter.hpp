@@ -8,36 +8,31 @@
 #include <cmath>
 #include <bela/fmt.hpp>
 #include <bela/codecvt.hpp>
+#include <bela/charconv.hpp>
+#include <bela/details/itoa.hpp>
 
 namespace bela::format_internal {
-class buffer {
+template <typename CharT> class basic_buffer {
 public:
-  buffer(wchar_t *data_, size_t cap_) : data(data_), cap(cap_) {}
-  buffer(const buffer &) = delete;
-  ~buffer() {
+  using value_type = CharT;
+  basic_buffer(CharT *data_, size_t cap_) : data(data_), cap(cap_) {}
+  basic_buffer(const basic_buffer &) = delete;
+  ~basic_buffer() {
     if (len < cap) {
       data[len] = 0;
     }
   }
-  void push_back(wchar_t ch) {
+  void push_back(CharT ch) {
     if (len < cap) {
       data[len++] = ch;
       return;
     }
     ow = true;
   }
-  buffer &append(std::wstring_view s) {
-    if (len + s.size() < cap) {
-      memcpy(data + len, s.data(), s.size() * sizeof(wchar_t));
-      len += s.size();
-      return *this;
-    }
-    ow = true;
-    return *this;
-  }
-  buffer &append(const wchar_t *str, size_t dl) {
+  basic_buffer &append(std::basic_string_view<CharT> s) { return append(s.data(), s.size()); }
+  basic_buffer &append(const CharT *str, size_t dl) {
     if (len + dl < cap) {
-      memcpy(data + len, str, dl * sizeof(wchar_t));
+      memcpy(data + len, str, dl * sizeof(CharT));
       len += dl;
       return *this;
     }
@@ -48,28 +43,155 @@ public:
   size_t length() const { return len; }
 
 private:
-  wchar_t *data{nullptr};
+  CharT *data{nullptr};
   size_t len{0};
   size_t cap{0};
   bool ow{false};
 };
+using buffer = basic_buffer<wchar_t>;
 
 constexpr const size_t kFastToBufferSize = 32;
-const wchar_t *AlphaNum(uint64_t value, wchar_t *digits, size_t width, int base, wchar_t fill = ' ', bool u = false);
+template <typename CharT>
+const CharT *AlphaNum(uint64_t value, CharT *digits, size_t width, int base, CharT fill = ' ', bool u = false) {
+  CharT *const end = digits + kFastToBufferSize;
+  CharT *writer = end;
+  constexpr const char hex[] = "0123456789abcdef";
+  constexpr const char uhex[] = "0123456789ABCDEF";
+  auto w = (std::min)(width, kFastToBufferSize);
+  switch (base) {
+  case 8:
+    do {
+      *--writer = static_cast<CharT>('0' + (value & 0x7));
+      value >>= 3;
+    } while (value != 0);
+    break;
+  case 16:
+    if (u) {
+      do {
+        *--writer = uhex[value & 0xF];
+        value >>= 4;
+      } while (value != 0);
+    } else {
+      do {
+        *--writer = hex[value & 0xF];
+        value >>= 4;
+      } while (value != 0);
+    }
+    break;
+  default:
+    writer -= numbers_internal::DigitCount(value);
+    numbers_internal::WriteDecimal(value, writer);
+    break;
+  }
+  CharT *beg;
+  if ((size_t)(end - writer) < w) {
+    beg = end - w;
+    std::fill_n(beg, writer - beg, fill);
+  } else {
+    beg = writer;
+  }
+  return beg;
+}
+
+// Mul64 full 128-bit product, false when the target has no cheap 64x64 multiply
+inline bool Mul64(uint64_t a, uint64_t b, uint64_t &hi, uint64_t &lo) {
+#if defined(__SIZEOF_INT128__)
+  auto p = static_cast<unsigned __int128>(a) * b;
+  hi = static_cast<uint64_t>(p >> 64);
+  lo = static_cast<uint64_t>(p);
+  return true;
+#elif defined(_M_X64)
+  lo = _umul128(a, b, &hi);
+  return true;
+#else
+  (void)a, (void)b, (void)hi, (void)lo;
+  return false;
+#endif
+}
+
+// FixedDecimal exact %.Nf when |d| * 10^N fits 64 bits: d = m * 2^-k so the digits are m * 10^N >> k rounded half to
+// even, the same result printf computes, with one multiply. Returns nullptr for other values (use to_chars).
+inline wchar_t *FixedDecimal(double d, uint32_t precision, wchar_t *first, wchar_t *last) {
+  constexpr uint64_t pow10[] = {1,           10,           100,           1000,           10000,
+                                100000,      1000000,      10000000,      100000000,      1000000000,
+                                10000000000, 100000000000, 1000000000000, 10000000000000, 100000000000000};
+  if (precision >= std::size(pow10) || !(std::fabs(d) < 1e18 / static_cast<double>(pow10[precision]))) {
+    return nullptr;
+  }
+  uint64_t bits;
+  memcpy(&bits, &d, sizeof(bits));
+  const auto biased = static_cast<int>((bits >> 52) & 0x7FF);
+  const auto k = 1075 - biased; // d = m * 2^-k
+  if (d != 0 && (biased == 0 || k > 127)) {
+    return nullptr; // subnormal or tiny
+  }
+  uint64_t q = 0;
+  if (d != 0) {
+    const auto m = (bits & ((uint64_t(1) << 52) - 1)) | (uint64_t(1) << 52);
+    uint64_t hi = 0;
+    uint64_t lo = 0;
+    if (!Mul64(m, pow10[precision], hi, lo)) {
+      return nullptr;
+    }
+    if (k <= 0) {
+      q = lo << -k; // integral value, range check keeps it in 64 bits
+    } else if (k < 64) {
+      q = (hi << (64 - k)) | (lo >> k);
+      const auto rem = lo & ((uint64_t(1) << k) - 1);
+      const auto half = uint64_t(1) << (k - 1);
+      q += (rem > half || (rem == half && (q & 1) != 0)) ? 1 : 0;
+    } else {
+      const auto s = k - 64;
+      q = s == 0 ? hi : (s < 64 ? hi >> s : 0);
+      // remainder hi' : lo against half = 2^(k-1)
+      const auto remhi = s == 0 ? 0 : (s < 64 ? hi & ((uint64_t(1) << s) - 1) : hi);
+      const auto halfhi = s == 0 ? 0 : uint64_t(1) << (s - 1);
+      const auto halflo = s == 0 ? uint64_t(1) << 63 : 0;
+      const auto above = remhi > halfhi || (remhi == halfhi && lo > halflo);
+      const auto tie = remhi == halfhi && lo == halflo;
+      q += (above || (tie && (q & 1) != 0)) ? 1 : 0;
+    }
+  }
+  // digits right aligned in a scratch buffer, at least precision + 1 of them
+  wchar_t digits[32];
+  auto end = digits + std::size(digits);
+  auto p = end - numbers_internal::DigitCount(q);
+  numbers_internal::WriteDecimal(q, p);
+  while (static_cast<uint32_t>(end - p) < precision + 1) {
+    *--p = '0';
+  }
+  const auto n = static_cast<size_t>(end - p);
+  if (static_cast<size_t>(last - first) < n + 2) {
+    return nullptr;
+  }
+  if (std::signbit(d)) {
+    *first++ = '-';
+  }
+  const auto intlen = n - precision;
+  memcpy(first, p, intlen * sizeof(wchar_t));
+  first += intlen;
+  if (precision != 0) {
+    *first++ = '.';
+    memcpy(first, p + intlen, precision * sizeof(wchar_t));
+    first += precision;
+  }
+  return first;
+}
 
 template <typename C = std::wstring> class Writer {
 public:
+  using char_type = typename C::value_type;
   Writer(C &c_) : c(c_) {}
   Writer(const Writer &) = delete;
   Writer &operator=(const Writer &) = delete;
   // fill_n
-  void fill_n(wchar_t ch, size_t n) {
+  void fill_n(char_type ch, size_t n) {
     for (size_t i = 0; i < n; i++) {
       c.push_back(ch);
     }
   }
   // append string
-  Writer &Append(const wchar_t *data, size_t len, size_t width = 0, wchar_t kc = ' ', bool la = false) {
+  Writer &Append(const char_type *data, size_t len, size_t width = 0, char_type kc = ' ', bool la = false) {
     if (width < len) {
       c.append(data, len);
       return *this;
@@ -83,89 +205,123 @@ public:
     c.append(data, len);
     return *this;
   }
-  Writer &Add(wchar_t ch) {
+  Writer &Add(char_type ch) {
     c.push_back(ch);
     return *this;
   }
-  // Add unicode
-  Writer &AddUnicode(char32_t ch, size_t width, wchar_t kc = ' ', bool la = false) {
-    constexpr size_t kMaxEncodedUTF16Size = 2;
-    wchar_t digits[kMaxEncodedUTF16Size + 2];
-    if (ch < 0xFFFF) {
-      digits[0] = static_cast<wchar_t>(ch);
-      return Append(digits, 1, width, kc, la);
-    }
-    auto n = char32tochar16(ch, reinterpret_cast<char16_t *>(digits), kMaxEncodedUTF16Size + 2);
+  // Add unicode, UTF-16 or UTF-8 encoded
+  Writer &AddUnicode(char32_t ch, size_t width, char_type kc = ' ', bool la = false) {
+    if constexpr (sizeof(char_type) == 1) {
+      char digits[8];
+      auto n = char32tochar8(ch, digits, sizeof(digits));
+      return Append(digits, n, width, kc, la);
+    } else {
+      constexpr size_t kMaxEncodedUTF16Size = 2;
+      wchar_t digits[kMaxEncodedUTF16Size + 2];
+      if (ch < 0xFFFF) {
+        digits[0] = static_cast<wchar_t>(ch);
+        return Append(digits, 1, width, kc, la);
+      }
+      auto n = char32tochar16(ch, reinterpret_cast<char16_t *>(digits), kMaxEncodedUTF16Size + 2);
 
-    return Append(digits, n, width, kc, la);
+      return Append(digits, n, width, kc, la);
+    }
   }
   // Add unicode point
   Writer &AddUnicodePoint(char32_t ch) {
-    wchar_t digits[kFastToBufferSize + 1];
+    char_type digits[kFastToBufferSize + 1];
     const auto dend = digits + kFastToBufferSize;
     auto val = static_cast<uint32_t>(ch);
     if (val > 0xFFFF) {
-      Append(L"U+", 2);
-      auto p = AlphaNum(val, digits, 8, 16, '0', true);
+      AddASCII("U+");
+      auto p = AlphaNum<char_type>(val, digits, 8, 16, '0', true);
       Append(p, dend - p);
       return *this;
     }
-    Append(L"u+", 2);
-    auto p = AlphaNum(val, digits, 4, 16, '0', true);
+    AddASCII("u+");
+    auto p = AlphaNum<char_type>(val, digits, 4, 16, '0', true);
     Append(p, dend - p);
     return *this;
   }
   // Add boolean
-  Writer &AddBoolean(bool b) {
-    if (b) {
-      Append(L"true", sizeof("true") - 1);
-    } else {
-      Append(L"false", sizeof("false") - 1);
+  Writer &AddBoolean(bool b) { return AddASCII(b ? "true" : "false"); }
+  // Add ASCII text to any char type
+  Writer &AddASCII(const char *s) {
+    for (; *s != 0; s++) {
+      c.push_back(static_cast<char_type>(*s));
     }
     return *this;
   }
 
-  Writer &Floating(double d, uint32_t width, uint32_t frac_width, wchar_t pc) {
-    if (std::signbit(d)) {
-      Add('-');
-      d = -d;
+  // Floating %f %e %g with printf precision (default 6), %v shortest round-trip. Digits come from the Ryu based
+  // bela::to_chars, width pads the whole number, zero padding goes after the sign.
+  Writer &Floating(double d, const FormatOp &op) {
+    constexpr int kDefaultPrecision = 6;
+    wchar_t digits[512];
+    std::wstring large;
+    auto precision = op.has_frac ? static_cast<int>(op.frac_width) : kDefaultPrecision;
+    auto format = [&](wchar_t *first, wchar_t *last) {
+      switch (op.verb) {
+      case 'e':
+        return bela::to_chars(first, last, d, bela::chars_format::scientific, precision);
+      case 'g':
+        return bela::to_chars(first, last, d, bela::chars_format::general, precision);
+      case 'v':
+        return bela::to_chars(first, last, d);
+      default:
+        break;
+      }
+      return bela::to_chars(first, last, d, bela::chars_format::fixed, precision);
+    };
+    auto first = digits;
+    bela::to_chars_result r{nullptr, std::errc{}};
+    if (op.verb == 'f') {
+      r.ptr = FixedDecimal(d, static_cast<uint32_t>(precision), digits, digits + std::size(digits));
     }
-    if (std::isnan(d)) {
-      Append(L"nan", 3);
-      return *this;
+    if (r.ptr == nullptr) {
+      r = format(digits, digits + std::size(digits));
     }
-    if (std::isinf(d)) {
-      Append(L"inf", 3);
-      return *this;
+    if (r.ec != std::errc{}) {
+      // %f of a huge value or a huge precision, 309 integer digits at most
+      large.resize(static_cast<size_t>(precision) + 400);
+      first = large.data();
+      r = format(first, first + large.size());
     }
-    wchar_t digits[kFastToBufferSize];
-    const auto dend = digits + kFastToBufferSize;
-    auto ui64 = static_cast<int64_t>(d);
-    uint64_t frac = 0;
-    uint32_t scale = 0;
-    if (frac_width > 0) {
-      scale = 1;
-      for (int n = frac_width; n != 0; n--) {
-        scale *= 10;
-      }
-      frac = (uint64_t)(std::round((d - (double)ui64) * scale));
-      if (frac == scale) {
-        ui64++;
-        frac = 0;
+    auto len = static_cast<size_t>(r.ptr - first);
+    auto sign = len != 0 && first[0] == '-';
+    auto finite = std::isfinite(d);
+    if (op.width > len && op.pc == '0' && !op.left && finite) {
+      if (sign) {
+        Add('-');
       }
+      fill_n('0', op.width - len);
+      return AppendWide(first + (sign ? 1 : 0), len - (sign ? 1 : 0));
     }
-    auto p = AlphaNum(ui64, digits, width, 10, pc);
-    Append(p, dend - p);
-    if (frac_width != 0) {
-      Add('.');
-      p = AlphaNum(frac, digits, frac_width, 10, pc);
-      Append(p, dend - p);
+    if (op.width <= len || op.left) {
+      AppendWide(first, len);
+      if (op.width > len) {
+        fill_n(' ', op.width - len);
+      }
+      return *this;
     }
-    return *this;
+    fill_n(' ', op.width - len);
+    return AppendWide(first, len);
   }
   bool overflow() const;
 
 private:
+  // to_chars output is ASCII
+  Writer &AppendWide(const wchar_t *data, size_t len) {
+    if constexpr (sizeof(char_type) == sizeof(wchar_t)) {
+      c.append(reinterpret_cast<const char_type *>(data), len);
+    } else {
+      for (size_t i = 0; i < len; i++) {
+        c.push_back(static_cast<char_type>(data[i]));
+      }
+    }
+    return *this;
+  }
+
   C &c;
 };
 
@@ -173,10 +329,17 @@ template <> inline bool Writer<std::wstring>::overflow() const {
   // std::wstring can resize. so always return false
   return false;
 }
+template <> inline bool Writer<std::string>::overflow() const { return false; }
 template <> inline bool Writer<buffer>::overflow() const {
   // no allocated buffer need check overflow
   return c.overflow();
 }
+template <> inline bool Writer<basic_buffer<char>>::overflow() const { return c.overflow(); }
+template <> inline bool Writer<basic_format_buffer<wchar_t>>::overflow() const {
+  // FormatBuffer spills to the heap, never overflow
+  return false;
+}
+template <> inline bool Writer<basic_format_buffer<char>>::overflow() const { return false; }
 } // namespace bela::format_internal
 
 #endif
@@ -0,0 +1,155 @@
+///
+#include <chrono>
+#include <bela/logger.hpp>
+
+namespace bela {
+namespace {
+// the writer hands a batch to WriteAuto once it reaches this many characters
+constexpr size_t batch_limit = 64 * 1024;
+} // namespace
+
+AsyncLogger::AsyncLogger(const AsyncLoggerOptions &options) : overflow(options.overflow) {
+  size_t capacity = 2;
+  while (capacity < options.capacity) {
+    capacity <<= 1;
+  }
+  slots = std::make_unique<Slot[]>(capacity);
+  for (size_t i = 0; i < capacity; i++) {
+    slots[i].seq.store(i, std::memory_order_relaxed);
+  }
+  mask = capacity - 1;
+  writer = std::thread([this] { Work(); });
+}
+
+AsyncLogger::~AsyncLogger() {
+  {
+    std::lock_guard<std::mutex> lock(mu);
+    stopped = true;
+  }
+  cv.notify_one();
+  writer.join();
+}
+
+AsyncLogger &AsyncLogger::Default() {
+  static AsyncLogger logger;
+  return logger;
+}
+
+// bounded MPMC ring (Vyukov): slot seq == pos free for the producer claiming pos, pos + 1 published
+bool AsyncLogger::Write(FILE *out, std::wstring_view msg) {
+  auto pos = enqueued.load(std::memory_order_relaxed);
+  Slot *slot = nullptr;
+  for (;;) {
+    slot = &slots[pos & mask];
+    auto seq = slot->seq.load(std::memory_order_acquire);
+    auto diff = static_cast<int64_t>(seq - pos);
+    if (diff == 0) {
+      if (enqueued.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+        break;
+      }
+      continue;
+    }
+    if (diff > 0) {
+      // another producer took pos
+      pos = enqueued.load(std::memory_order_relaxed);
+      continue;
+    }
+    // ring full, the writer still owns this slot
+    if (overflow == LogOverflow::Drop) {
+      dropped.fetch_add(1, std::memory_order_relaxed);
+      return false;
+    }
+    Wake();
+    {
+      std::unique_lock<std::mutex> lock(mu);
+      waiters.fetch_add(1);
+      done_cv.wait_for(lock, std::chrono::milliseconds(1));
+      waiters.fetch_sub(1);
+    }
+    pos = enqueued.load(std::memory_order_relaxed);
+  }
+  slot->out = out;
+  slot->len = msg.size();
+  if (msg.size() <= inline_chars) {
+    memcpy(slot->text, msg.data(), msg.size() * sizeof(wchar_t));
+  } else {
+    slot->large.assign(msg);
+  }
+  slot->seq.store(pos + 1, std::memory_order_release);
+  Wake();
+  return true;
+}
+
+bool AsyncLogger::Ready(uint64_t pos) const {
+  return slots[pos & mask].seq.load(std::memory_order_acquire) == pos + 1;
+}
+
+void AsyncLogger::Wake() {
+  // pairs with the fence in Work: either the writer sees the new slot or we see it sleeping
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  if (sleeping.load(std::memory_order_relaxed)) {
+    std::lock_guard<std::mutex> lock(mu);
+    cv.notify_one();
+  }
+}
+
+void AsyncLogger::Flush() {
+  auto target = enqueued.load(std::memory_order_acquire);
+  std::unique_lock<std::mutex> lock(mu);
+  waiters.fetch_add(1);
+  done_cv.wait(lock, [&] { return written.load() >= target; });
+  waiters.fetch_sub(1);
+}
+
+void AsyncLogger::Work() {
+  std::wstring batch;
+  batch.reserve(batch_limit + inline_chars);
+  FILE *batch_out = nullptr;
+  uint64_t pos = 0;
+  // write the batch, every position before pos is then on its way out
+  auto emit = [&] {
+    if (!batch.empty()) {
+      bela::terminal::WriteAuto(batch_out, batch);
+      batch.clear();
+    }
+    written.store(pos);
+    if (waiters.load() != 0) {
+      std::lock_guard<std::mutex> lock(mu);
+      done_cv.notify_all();
+    }
+  };
+  for (;;) {
+    while (Ready(pos)) {
+      auto &slot = slots[pos & mask];
+      if (slot.out != batch_out || batch.size() >= batch_limit) {
+        emit();
+        batch_out = slot.out;
+      }
+      if (slot.len <= inline_chars) {
+        batch.append(slot.text, slot.len);
+      } else {
+        batch.append(slot.large);
+        // memory stays bounded, don't keep the largest message ever logged
+        std::wstring().swap(slot.large);
+      }
+      slot.seq.store(pos + mask + 1, std::memory_order_release);
+      pos++;
+    }
+    emit();
+    std::unique_lock<std::mutex> lock(mu);
+    sleeping.store(true, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    cv.wait(lock, [&] { return stopped || Ready(pos); });
+    sleeping.store(false, std::memory_order_relaxed);
+    if (stopped && !Ready(pos)) {
+      if (enqueued.load(std::memory_order_acquire) == pos) {
+        return;
+      }
+      // a producer claimed a slot but hasn't filled it yet
+      lock.unlock();
+      std::this_thread::yield();
+    }
+  }
+}
+
+} // namespace bela
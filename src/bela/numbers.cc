@@ -45,6 +45,17 @@
 #include <bela/memutil.hpp>
 #include <bela/match.hpp>
 #include <bela/bits.hpp>
+#include <bela/charconv.hpp>
+#include <bela/endian.hpp>
+#include <bela/narrow/numbers.hpp>
+#include <bela/details/itoa.hpp>
+#if defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2) || defined(__SSE2__)
+#include <emmintrin.h>
+#define BELA_NUMBERS_SSE2 1
+#elif defined(_M_ARM64) || defined(__aarch64__)
+#include <arm_neon.h>
+#define BELA_NUMBERS_NEON 1
+#endif
 
 namespace bela {
 
@@ -80,146 +91,31 @@ bool SimpleAtob(std::wstring_view str, bool *out) {
   return false;
 }
 
-const wchar_t one_ASCII_final_digits[10][2]{
-    {'0', 0}, {'1', 0}, {'2', 0}, {'3', 0}, {'4', 0}, {'5', 0}, {'6', 0}, {'7', 0}, {'8', 0}, {'9', 0},
-};
-
 namespace numbers_internal {
+// The digits come from the shared writer in bela/details/itoa.hpp, the same code produces narrow StringCat and
+// StrFormat %d output.
 wchar_t *FastIntToBuffer(uint32_t i, wchar_t *buffer) {
-  uint32_t digits;
-  // The idea of this implementation is to trim the number of divides to as few
-  // as possible, and also reducing memory stores and branches, by going in
-  // steps of two digits at a time rather than one whenever possible.
-  // The huge-number case is first, in the hopes that the compiler will output
-  // that case in one branch-free block of code, and only output conditional
-  // branches into it from below.
-  if (i >= 1000000000) {    // >= 1,000,000,000
-    digits = i / 100000000; //      100,000,000
-    i -= digits * 100000000;
-    PutTwoDigits(digits, buffer);
-    buffer += 2;
-  lt100_000_000:
-    digits = i / 1000000; // 1,000,000
-    i -= digits * 1000000;
-    PutTwoDigits(digits, buffer);
-    buffer += 2;
-  lt1_000_000:
-    digits = i / 10000; // 10,000
-    i -= digits * 10000;
-    PutTwoDigits(digits, buffer);
-    buffer += 2;
-  lt10_000:
-    digits = i / 100;
-    i -= digits * 100;
-    PutTwoDigits(digits, buffer);
-    buffer += 2;
-  lt100:
-    digits = i;
-    PutTwoDigits(digits, buffer);
-    buffer += 2;
-    *buffer = 0;
-    return buffer;
-  }
-
-  if (i < 100) {
-    digits = i;
-    if (i >= 10)
-      goto lt100;
-    strings_internal::memcopy(buffer, one_ASCII_final_digits[i], 2);
-    return buffer + 1;
-  }
-  if (i < 10000) { //    10,000
-    if (i >= 1000)
-      goto lt10_000;
-    digits = i / 100;
-    i -= digits * 100;
-    *buffer++ = static_cast<wchar_t>('0' + digits);
-    goto lt100;
-  }
-  if (i < 1000000) { //    1,000,000
-    if (i >= 100000)
-      goto lt1_000_000;
-    digits = i / 10000; //    10,000
-    i -= digits * 10000;
-    *buffer++ = static_cast<wchar_t>('0' + digits);
-    goto lt10_000;
-  }
-  if (i < 100000000) { //    100,000,000
-    if (i >= 10000000)
-      goto lt100_000_000;
-    digits = i / 1000000; //   1,000,000
-    i -= digits * 1000000;
-    *buffer++ = static_cast<wchar_t>('0' + digits);
-    goto lt1_000_000;
-  }
-  // we already know that i < 1,000,000,000
-  digits = i / 100000000; //   100,000,000
-  i -= digits * 100000000;
-  *buffer++ = static_cast<wchar_t>('0' + digits);
-  goto lt100_000_000;
+  buffer = WriteDecimal(i, buffer);
+  *buffer = 0;
+  return buffer;
 }
 
 wchar_t *FastIntToBuffer(int32_t i, wchar_t *buffer) {
-  uint32_t u = i;
-  if (i < 0) {
-    *buffer++ = '-';
-    // We need to do the negation in modular (i.e., "unsigned")
-    // arithmetic; MSVC++ apprently warns for plain "-u", so
-    // we write the equivalent expression "0 - u" instead.
-    u = 0 - u;
-  }
-  return FastIntToBuffer(u, buffer);
+  buffer = WriteInteger(i, buffer);
+  *buffer = 0;
+  return buffer;
 }
 
 wchar_t *FastIntToBuffer(uint64_t i, wchar_t *buffer) {
-  uint32_t u32 = static_cast<uint32_t>(i);
-  if (u32 == i)
-    return FastIntToBuffer(u32, buffer);
-
-  // Here we know i has at least 10 decimal digits.
-  uint64_t top_1to11 = i / 1000000000;
-  u32 = static_cast<uint32_t>(i - top_1to11 * 1000000000);
-  uint32_t top_1to11_32 = static_cast<uint32_t>(top_1to11);
-
-  if (top_1to11_32 == top_1to11) {
-    buffer = FastIntToBuffer(top_1to11_32, buffer);
-  } else {
-    // top_1to11 has more than 32 bits too; print it in two steps.
-    uint32_t top_8to9 = static_cast<uint32_t>(top_1to11 / 100);
-    uint32_t mid_2 = static_cast<uint32_t>(top_1to11 - top_8to9 * 100);
-    buffer = FastIntToBuffer(top_8to9, buffer);
-    PutTwoDigits(mid_2, buffer);
-    buffer += 2;
-  }
-
-  // We have only 9 digits now, again the maximum uint32_t can handle fully.
-  uint32_t digits = u32 / 10000000; // 10,000,000
-  u32 -= digits * 10000000;
-  PutTwoDigits(digits, buffer);
-  buffer += 2;
-  digits = u32 / 100000; // 100,000
-  u32 -= digits * 100000;
-  PutTwoDigits(digits, buffer);
-  buffer += 2;
-  digits = u32 / 1000; // 1,000
-  u32 -= digits * 1000;
-  PutTwoDigits(digits, buffer);
-  buffer += 2;
-  digits = u32 / 10;
-  u32 -= digits * 10;
-  PutTwoDigits(digits, buffer);
-  buffer += 2;
-  strings_internal::memcopy(buffer, one_ASCII_final_digits[u32], 2);
-  return buffer + 1;
+  buffer = WriteDecimal(i, buffer);
+  *buffer = 0;
+  return buffer;
 }
 
 wchar_t *FastIntToBuffer(int64_t i, wchar_t *buffer) {
-  uint64_t u = i;
-  if (i < 0) {
-    *buffer++ = '-';
-    u = 0 - u;
-  }
-  return FastIntToBuffer(u, buffer);
+  buffer = WriteInteger(i, buffer);
+  *buffer = 0;
+  return buffer;
 }
 
 // Given a 128-bit number expressed as a pair of uint64_t, high half first,
@@ -627,22 +523,31 @@ static const int8_t kAsciiToInt[256] = {
     36, 36, 36, 36, 36, 36, 36, 36, 36, 36, 36, 36, 36, 36, 36, 36, 36, 36, 36, 36, 36, 36, 36, 36, 36, 36, 36,
     36, 36, 36, 36, 36, 36, 36, 36, 36, 36, 36, 36, 36, 36, 36, 36, 36, 36, 36, 36, 36, 36, 36, 36};
 
+// ascii_isspace walks the whole Unicode space list, digits and signs are ruled out first
+template <typename CharT> inline bool IsSpaceFast(CharT c) {
+  if (c > ' ' && c < 0x85) {
+    return false;
+  }
+  return ascii_isspace(static_cast<wchar_t>(c));
+}
+
 // Parse the sign and optional hex or oct prefix in text.
-inline bool safe_parse_sign_and_base(std::wstring_view *text /*inout*/, int *base_ptr /*inout*/,
+template <typename CharT>
+inline bool safe_parse_sign_and_base(std::basic_string_view<CharT> *text /*inout*/, int *base_ptr /*inout*/,
                                      bool *negative_ptr /*output*/) {
   if (text->data() == nullptr) {
     return false;
   }
 
-  const wchar_t *start = text->data();
-  const wchar_t *end = start + text->size();
+  const CharT *start = text->data();
+  const CharT *end = start + text->size();
   int base = *base_ptr;
 
   // Consume whitespace.
-  while (start < end && ascii_isspace(start[0])) {
+  while (start < end && IsSpaceFast(start[0])) {
     ++start;
   }
-  while (start < end && ascii_isspace(end[-1])) {
+  while (start < end && IsSpaceFast(end[-1])) {
     --end;
   }
   if (start >= end) {
@@ -689,7 +594,7 @@ inline bool safe_parse_sign_and_base(std::wstring_view *text /*inout*/, int *bas
   } else {
     return false;
   }
-  *text = std::wstring_view(start, end - start);
+  *text = std::basic_string_view<CharT>(start, end - start);
   *base_ptr = base;
   return true;
 }
@@ -746,15 +651,194 @@ const IntType LookupTables<IntType>::kVminOverBase[] = X_OVER_BASE_INITIALIZER(s
 
 #undef X_OVER_BASE_INITIALIZER
 
-template <typename IntType> inline bool safe_parse_positive_int(std::wstring_view text, int base, IntType *value_p) {
+// Decimal fast path, eight digits per step. LoadEightDigits succeeds only when all eight characters are ASCII
+// digits and stores their values one per byte, first digit in the lowest byte. Blocks are consumed while the value
+// cannot overflow and the digit loop takes over at the first block that fails, so results (including the partial
+// value stored on error) are exactly those of the digit loop.
+
+// CombineEightDigits decimal value of the eight digit bytes
+inline uint32_t CombineEightDigits(uint64_t v) {
+  constexpr uint64_t mask = 0x000000FF000000FF;
+  constexpr uint64_t mul1 = 100 + (1000000ULL << 32);
+  constexpr uint64_t mul2 = 1 + (10000ULL << 32);
+  v = (v * 10) + (v >> 8);
+  return static_cast<uint32_t>(((v & mask) * mul1 + ((v >> 16) & mask) * mul2) >> 32);
+}
+
+// SWAR: every byte of '0'..'9' has high nibble 3 and stays below 0x3A after adding 6
+inline bool LoadEightDigits(const char *p, uint64_t *out) {
+  uint64_t v;
+  memcpy(&v, p, sizeof(v));
+  if ((((v & 0xF0F0F0F0F0F0F0F0) | (((v + 0x0606060606060606) & 0xF0F0F0F0F0F0F0F0) >> 4))) !=
+      0x3333333333333333) {
+    return false;
+  }
+  *out = v - 0x3030303030303030;
+  return true;
+}
+
+template <typename CharT> inline bool LoadEightDigitsPortable(const CharT *p, uint64_t *out) {
+  uint64_t v = 0;
+  for (int i = 0; i < 8; i++) {
+    auto d = static_cast<uint32_t>(p[i]) - static_cast<uint32_t>('0');
+    if (d > 9) {
+      return false;
+    }
+    v |= static_cast<uint64_t>(d) << (i * 8);
+  }
+  *out = v;
+  return true;
+}
+
+// UTF-16 digits: subtract '0', any lane above 9 survives a saturating subtract of 9, then narrow the lanes to bytes
+template <typename CharT> inline bool LoadEightDigits(const CharT *p, uint64_t *out) {
+  if constexpr (sizeof(CharT) == 2) {
+#if defined(BELA_NUMBERS_SSE2)
+    const auto d = _mm_sub_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i *>(p)), _mm_set1_epi16('0'));
+    const auto over = _mm_subs_epu16(d, _mm_set1_epi16(9));
+    if (_mm_movemask_epi8(_mm_cmpeq_epi16(over, _mm_setzero_si128())) != 0xFFFF) {
+      return false;
+    }
+    _mm_storel_epi64(reinterpret_cast<__m128i *>(out), _mm_packus_epi16(d, d));
+    return true;
+#elif defined(BELA_NUMBERS_NEON)
+    const auto d = vsubq_u16(vld1q_u16(reinterpret_cast<const uint16_t *>(p)), vdupq_n_u16('0'));
+    if (vmaxvq_u16(d) > 9) {
+      return false;
+    }
+    *out = vget_lane_u64(vreinterpret_u64_u8(vmovn_u16(d)), 0);
+    return true;
+#else
+    return LoadEightDigitsPortable(p, out);
+#endif
+  } else {
+    return LoadEightDigitsPortable(p, out);
+  }
+}
+
+// LoadLeadingDigits how many of the eight characters at p are digits before the first non-digit. Those digits are
+// stored so that CombineEightDigits returns their value: the first one moves up to byte 8 - n and the low bytes act
+// as leading zeros.
+inline size_t LoadLeadingDigits(const char *p, uint64_t *out) {
+  uint64_t v;
+  memcpy(&v, p, sizeof(v));
+  // a byte is non-zero unless it is a digit, carries only reach bytes after the first non-digit
+  const uint64_t bad = ((v & 0xF0F0F0F0F0F0F0F0) | (((v + 0x0606060606060606) & 0xF0F0F0F0F0F0F0F0) >> 4)) ^
+                       0x3333333333333333;
+  const auto n = bad == 0 ? 8 : static_cast<size_t>(bela::base_internal::CountTrailingZerosNonZero64(bad) / 8);
+  *out = n == 0 ? 0 : (v - 0x3030303030303030) << ((8 - n) * 8);
+  return n;
+}
+
+template <typename CharT> inline size_t LoadLeadingDigits(const CharT *p, uint64_t *out) {
+#if defined(BELA_NUMBERS_SSE2)
+  if constexpr (sizeof(CharT) == 2) {
+    const auto d = _mm_sub_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i *>(p)), _mm_set1_epi16('0'));
+    const auto digit = _mm_cmpeq_epi16(_mm_subs_epu16(d, _mm_set1_epi16(9)), _mm_setzero_si128());
+    // two mask bits per character, bit 16 stops the count at eight
+    const auto bad = ~static_cast<uint32_t>(_mm_movemask_epi8(digit)) | 0x10000;
+    const auto n = static_cast<size_t>(bela::base_internal::CountTrailingZerosNonZero32(bad) / 2);
+    uint64_t v = 0;
+    _mm_storel_epi64(reinterpret_cast<__m128i *>(&v), _mm_packus_epi16(d, d));
+    *out = n == 0 ? 0 : v << ((8 - n) * 8);
+    return n;
+  }
+#elif defined(BELA_NUMBERS_NEON)
+  if constexpr (sizeof(CharT) == 2) {
+    const auto d = vsubq_u16(vld1q_u16(reinterpret_cast<const uint16_t *>(p)), vdupq_n_u16('0'));
+    const auto bad = ~vget_lane_u64(vreinterpret_u64_u8(vmovn_u16(vcleq_u16(d, vdupq_n_u16(9)))), 0);
+    const auto n = bad == 0 ? 8 : static_cast<size_t>(bela::base_internal::CountTrailingZerosNonZero64(bad) / 8);
+    const auto v = vget_lane_u64(vreinterpret_u64_u8(vmovn_u16(d)), 0);
+    *out = n == 0 ? 0 : v << ((8 - n) * 8);
+    return n;
+  }
+#endif
+  uint64_t v = 0;
+  size_t n = 0;
+  for (; n < 8; n++) {
+    auto c = static_cast<uint32_t>(p[n]) - static_cast<uint32_t>('0');
+    if (c > 9) {
+      break;
+    }
+    v |= static_cast<uint64_t>(c) << (n * 8);
+  }
+  *out = n == 0 ? 0 : v << ((8 - n) * 8);
+  return n;
+}
+
+// AccumulateDigits value * 10^n + digits (value * 10^n - digits when Negative), false if the result would leave the
+// range of IntType; the checks only use precomputed limits, there is no division on the hot path
+template <bool Negative, typename IntType> inline bool AccumulateDigits(IntType &value, uint32_t digits, size_t n) {
+  constexpr IntType pow10[] = {1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000};
+  // limit / 10^n truncates toward zero, a value within it times 10^n always fits
+  constexpr IntType limit = Negative ? std::numeric_limits<IntType>::min() : std::numeric_limits<IntType>::max();
+  constexpr IntType limits[] = {limit,           limit / 10,        limit / 100,        limit / 1000,     limit / 10000,
+                                limit / 100000, limit / 1000000, limit / 10000000, limit / 100000000};
+  const auto d = static_cast<IntType>(digits);
+  if constexpr (Negative) {
+    if (value < limits[n]) {
+      return false;
+    }
+    const IntType v = value * pow10[n];
+    if (v < limit + d) {
+      return false;
+    }
+    value = v - d;
+  } else {
+    if (value > limits[n]) {
+      return false;
+    }
+    const IntType v = value * pow10[n];
+    if (v > limit - d) {
+      return false;
+    }
+    value = v + d;
+  }
+  return true;
+}
+
+// ConsumeDecimalBlocks returns where the digit loop has to continue. Once a block has been consumed, fewer than eight
+// remaining digits are read as the last eight characters with the already consumed ones masked to leading zeros.
+template <bool Negative, typename IntType, typename CharT>
+inline const CharT *ConsumeDecimalBlocks(const CharT *start, const CharT *end, IntType &value) {
+  if constexpr (!bela::IsLittleEndianHost) {
+    return start;
+  }
+  const CharT *begin = start;
+  uint64_t block = 0;
+  for (; end - start >= 8; start += 8) {
+    if (!LoadEightDigits(start, &block) || !AccumulateDigits<Negative>(value, CombineEightDigits(block), 8)) {
+      return start;
+    }
+  }
+  const auto n = static_cast<size_t>(end - start);
+  if (n == 0 || start == begin) {
+    return start;
+  }
+  // the masked characters are digits that were consumed above
+  if (!LoadEightDigits(end - 8, &block)) {
+    return start;
+  }
+  const auto tail = CombineEightDigits(block & (~uint64_t{0} << ((8 - n) * 8)));
+  if (!AccumulateDigits<Negative>(value, tail, n)) {
+    return start;
+  }
+  return end;
+}
+
+template <typename IntType, typename CharT>
+inline bool safe_parse_positive_int(std::basic_string_view<CharT> text, int base, IntType *value_p) {
   IntType value = 0;
   const IntType vmax = std::numeric_limits<IntType>::max();
   assert(vmax > 0);
   assert(base >= 0);
   assert(vmax >= static_cast<IntType>(base));
   const IntType vmax_over_base = LookupTables<IntType>::kVmaxOverBase[base];
-  const wchar_t *start = text.data();
-  const wchar_t *end = start + text.size();
+  const CharT *start = text.data();
+  const CharT *end = start + text.size();
+  if (base == 10) {
+    start = ConsumeDecimalBlocks<false>(start, end, value);
+  }
   // loop over digits
   for (; start < end; ++start) {
     unsigned char c = static_cast<unsigned char>(start[0]);
@@ -778,7 +862,8 @@ template <typename IntType> inline bool safe_parse_positive_int(std::wstring_vie
   return true;
 }
 
-template <typename IntType> inline bool safe_parse_negative_int(std::wstring_view text, int base, IntType *value_p) {
+template <typename IntType, typename CharT>
+inline bool safe_parse_negative_int(std::basic_string_view<CharT> text, int base, IntType *value_p) {
   IntType value = 0;
   const IntType vmin = std::numeric_limits<IntType>::min();
   assert(vmin < 0);
@@ -792,8 +877,11 @@ template <typename IntType> inline bool safe_parse_negative_int(std::wstring_vie
   if (vmin % base > 0) {
     vmin_over_base += 1;
   }
-  const wchar_t *start = text.data();
-  const wchar_t *end = start + text.size();
+  const CharT *start = text.data();
+  const CharT *end = start + text.size();
+  if (base == 10) {
+    start = ConsumeDecimalBlocks<true>(start, end, value);
+  }
   // loop over digits
   for (; start < end; ++start) {
     unsigned char c = static_cast<unsigned char>(start[0]);
@@ -819,7 +907,8 @@ template <typename IntType> inline bool safe_parse_negative_int(std::wstring_vie
 
 // Input format based on POSIX.1-2008 strtol
 // http://pubs.opengroup.org/onlinepubs/9699919799/functions/strtol.html
-template <typename IntType> inline bool safe_int_internal(std::wstring_view text, IntType *value_p, int base) {
+template <typename IntType, typename CharT>
+inline bool safe_int_internal(std::basic_string_view<CharT> text, IntType *value_p, int base) {
   *value_p = 0;
   bool negative;
   if (!safe_parse_sign_and_base(&text, &base, &negative)) {
@@ -832,7 +921,8 @@ template <typename IntType> inline bool safe_int_internal(std::wstring_view text
   }
 }
 
-template <typename IntType> inline bool safe_uint_internal(std::wstring_view text, IntType *value_p, int base) {
+template <typename IntType, typename CharT>
+inline bool safe_uint_internal(std::basic_string_view<CharT> text, IntType *value_p, int base) {
   *value_p = 0;
   bool negative;
   if (!safe_parse_sign_and_base(&text, &base, &negative) || negative) {
@@ -840,6 +930,377 @@ template <typename IntType> inline bool safe_uint_internal(std::wstring_view tex
   }
   return safe_parse_positive_int(text, base, value_p);
 }
+// Decimal to binary floating point. Plain decimals with at most 19 significant digits are converted by Clinger's
+// exact fast path or by Eisel-Lemire (Lemire, "Number Parsing at a Gigabyte per Second"), everything else (more
+// digits, subnormal results, inf/nan, rounding too close to call) goes to the exact big integer from_chars.
+// The 128-bit powers of five are the Ryu tables of charconv_ryu: __DOUBLE_POW5_SPLIT holds 5^q truncated to 121
+// bits and __DOUBLE_POW5_INV_SPLIT holds 2^k/5^q rounded up to 122 bits.
+template <typename Float> struct FloatTraits;
+template <> struct FloatTraits<double> {
+  using bits_type = uint64_t;
+  static constexpr int mantissa_bits = 52;
+  static constexpr int exponent_bias = 1023;
+  static constexpr int infinite_exponent = 2047;
+  static constexpr uint64_t max_exact_integer = uint64_t{1} << 53;
+  static constexpr int max_exact_pow10 = 22;
+  static constexpr int64_t min_decimal_exponent = -342; // w * 10^q rounds to zero below
+  static constexpr int64_t max_decimal_exponent = 308;  // w * 10^q is infinite above
+  static double ExactPow10(int64_t e) {
+    constexpr double pow10[] = {1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+                                1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+    return pow10[e];
+  }
+};
+template <> struct FloatTraits<float> {
+  using bits_type = uint32_t;
+  static constexpr int mantissa_bits = 23;
+  static constexpr int exponent_bias = 127;
+  static constexpr int infinite_exponent = 255;
+  static constexpr uint64_t max_exact_integer = uint64_t{1} << 24;
+  static constexpr int max_exact_pow10 = 10;
+  static constexpr int64_t min_decimal_exponent = -64;
+  static constexpr int64_t max_decimal_exponent = 38;
+  static float ExactPow10(int64_t e) {
+    constexpr float pow10[] = {1e0f, 1e1f, 1e2f, 1e3f, 1e4f, 1e5f, 1e6f, 1e7f, 1e8f, 1e9f, 1e10f};
+    return pow10[e];
+  }
+};
+
+// value = w * 10^q
+struct DecimalNumber {
+  uint64_t w{0};
+  int64_t q{0};
+  bool negative{false};
+};
+
+inline bool IsDecimalDigit(uint32_t c) { return c - '0' <= 9; }
+
+// ParseDecimalPrefix [-]digits[.digits][(e|E)[+-]digits] at the start of the text, returns where the number ends
+// or nullptr when there is none or it has more than 19 significant digits
+template <typename CharT> const CharT *ParseDecimalPrefix(const CharT *p, const CharT *end, DecimalNumber &d) {
+  constexpr int max_digits = 19;
+  if (p < end && *p == '-') {
+    d.negative = true;
+    ++p;
+  }
+  int digits = 0; // significant digits in w, leading zeros are not counted
+  bool any = false;
+  int64_t q = 0;
+  auto take = [&](bool fraction) -> bool {
+    uint64_t block = 0;
+    for (; p < end && IsDecimalDigit(static_cast<uint32_t>(*p)); ++p) {
+      any = true;
+      q -= fraction ? 1 : 0;
+      if (digits == 0 && *p == '0') {
+        continue;
+      }
+      if (++digits > max_digits) {
+        return false;
+      }
+      d.w = d.w * 10 + (static_cast<uint32_t>(*p) - '0');
+      // long runs go eight digits at a time
+      while (digits + 8 <= max_digits && end - p > 8 && LoadEightDigits(p + 1, &block)) {
+        d.w = d.w * 100000000 + CombineEightDigits(block);
+        digits += 8;
+        q -= fraction ? 8 : 0;
+        p += 8;
+      }
+    }
+    return true;
+  };
+  if (!take(false)) {
+    return nullptr;
+  }
+  if (p < end && *p == '.') {
+    ++p;
+    if (!take(true)) {
+      return nullptr;
+    }
+  }
+  if (!any) {
+    return nullptr;
+  }
+  if (p < end && (*p == 'e' || *p == 'E')) {
+    ++p;
+    bool negative_exponent = false;
+    if (p < end && (*p == '+' || *p == '-')) {
+      negative_exponent = *p == '-';
+      ++p;
+    }
+    if (p == end || !IsDecimalDigit(static_cast<uint32_t>(*p))) {
+      return nullptr;
+    }
+    int64_t e = 0;
+    for (; p < end && IsDecimalDigit(static_cast<uint32_t>(*p)); ++p) {
+      // saturate, anything this large is zero or infinity
+      if (e < 100000) {
+        e = e * 10 + (static_cast<uint32_t>(*p) - '0');
+      }
+    }
+    q += negative_exponent ? -e : e;
+  }
+  d.q = q;
+  return p;
+}
+
+template <typename CharT> bool ParseDecimalNumber(const CharT *p, const CharT *end, DecimalNumber &d) {
+  return ParseDecimalPrefix(p, end, d) == end;
+}
+
+template <typename Float> Float MakeFloat(bool negative, uint64_t biased_exponent, uint64_t mantissa) {
+  using traits = FloatTraits<Float>;
+  using bits_type = typename traits::bits_type;
+  auto bits = static_cast<bits_type>((biased_exponent << traits::mantissa_bits) | mantissa);
+  if (negative) {
+    bits |= static_cast<bits_type>(bits_type{1} << (sizeof(bits_type) * 8 - 1));
+  }
+  Float f;
+  memcpy(&f, &bits, sizeof(f));
+  return f;
+}
+
+// EiselLemire false when the result is subnormal or the approximation can't decide the rounding
+template <typename Float> bool EiselLemire(const DecimalNumber &d, Float *out) {
+  using traits = FloatTraits<Float>;
+  const auto q = d.q;
+  const auto i = static_cast<int32_t>(q < 0 ? -q : q);
+  uint64_t p_hi = 0;
+  uint64_t p_lo = 0;
+  int64_t s = 0; // value = X * 2^s, X = floor(w * P / 2^64)
+  const auto lz = static_cast<int>(bela::base_internal::CountLeadingZeros64(d.w));
+  const auto pb = bela::__pow5bits(i);
+  if (q >= 0) {
+    // 5^q * 2^(128 - pb), at most 2^7 too small
+    const auto *p = bela::__DOUBLE_POW5_SPLIT[i];
+    p_hi = (p[1] << 7) | (p[0] >> 57);
+    p_lo = p[0] << 7;
+    s = q + pb - lz - 64;
+  } else {
+    if (i >= static_cast<int32_t>(std::size(bela::__DOUBLE_POW5_INV_SPLIT))) {
+      return false;
+    }
+    // 2^(pb + 127) / 5^-q, at most 2^6 too large
+    const auto *p = bela::__DOUBLE_POW5_INV_SPLIT[i];
+    p_hi = (p[1] << 6) | (p[0] >> 58);
+    p_lo = p[0] << 6;
+    s = q - lz - pb - 63;
+  }
+  const uint64_t w = d.w << lz;
+  uint64_t lo_hi = 0;
+  (void)bela::__ryu_umul128(w, p_lo, &lo_hi);
+  uint64_t hi = 0;
+  const uint64_t first_lo = bela::__ryu_umul128(w, p_hi, &hi);
+  const uint64_t mid = first_lo + lo_hi;
+  hi += mid < first_lo ? 1 : 0;
+  // X has its top bit at 127 or 126, keep mantissa_bits + 2 bits: the implicit one, the mantissa and a round bit
+  const auto upperbit = static_cast<int>(hi >> 63);
+  const auto shift = upperbit + 62 - traits::mantissa_bits - 1;
+  uint64_t mantissa = hi >> shift;
+  const uint64_t dropped_mask = (uint64_t{1} << shift) - 1;
+  const uint64_t dropped = hi & dropped_mask;
+  const auto round_bit = mantissa & 1;
+  // 5^q with q <= 27 fits in p_hi, X is then exact, otherwise X is within 2^8 of the true product
+  if (q < 0 || q > 27) {
+    constexpr uint64_t error = 256;
+    if (round_bit == 1 ? (dropped == 0 && mid < error) : (dropped == dropped_mask && mid > ~uint64_t{0} - error)) {
+      return false;
+    }
+    mantissa = (mantissa + round_bit) >> 1;
+  } else if (round_bit == 1 && dropped == 0 && mid == 0) {
+    // halfway, round to even
+    mantissa >>= 1;
+    mantissa += mantissa & 1;
+  } else {
+    mantissa = (mantissa + round_bit) >> 1;
+  }
+  auto e2 = s + 64 + shift + 1;
+  if (mantissa == (uint64_t{1} << (traits::mantissa_bits + 1))) {
+    mantissa >>= 1;
+    e2++;
+  }
+  const auto biased = e2 + traits::mantissa_bits + traits::exponent_bias;
+  if (biased <= 0) {
+    return false;
+  }
+  if (biased >= traits::infinite_exponent) {
+    *out = MakeFloat<Float>(d.negative, traits::infinite_exponent, 0);
+    return true;
+  }
+  *out = MakeFloat<Float>(d.negative, static_cast<uint64_t>(biased),
+                          mantissa & ((uint64_t{1} << traits::mantissa_bits) - 1));
+  return true;
+}
+
+template <typename Float> bool DecimalToFloat(const DecimalNumber &d, Float *out) {
+  using traits = FloatTraits<Float>;
+  if (d.w == 0 || d.q < traits::min_decimal_exponent) {
+    *out = d.negative ? -Float(0) : Float(0);
+    return true;
+  }
+  if (d.q > traits::max_decimal_exponent) {
+    *out = MakeFloat<Float>(d.negative, traits::infinite_exponent, 0);
+    return true;
+  }
+  // Clinger: both operands are exact, IEEE multiply/divide rounds once
+  if (d.w <= traits::max_exact_integer && d.q >= -traits::max_exact_pow10 && d.q <= traits::max_exact_pow10) {
+    auto v = static_cast<Float>(d.w);
+    v = d.q < 0 ? v / traits::ExactPow10(-d.q) : v * traits::ExactPow10(d.q);
+    *out = d.negative ? -v : v;
+    return true;
+  }
+  return EiselLemire(d, out);
+}
+
+template <typename Float, typename CharT> bool FromCharsExact(const CharT *first, const CharT *last, Float *out) {
+  if constexpr (std::is_same_v<CharT, wchar_t>) {
+    auto result = bela::from_chars(first, last, *out);
+    return result.ec != std::errc::invalid_argument && result.ptr == last;
+  } else {
+    std::wstring w;
+    w.reserve(static_cast<size_t>(last - first));
+    for (auto p = first; p != last; p++) {
+      w.push_back(static_cast<wchar_t>(static_cast<std::make_unsigned_t<CharT>>(*p)));
+    }
+    return FromCharsExact(w.data(), w.data() + w.size(), out);
+  }
+}
+
+// SimpleAtofInternal absl::SimpleAtod semantics: surrounding whitespace and a leading '+' are accepted, out of
+// range values become infinity or zero and still succeed
+template <typename Float, typename CharT> bool SimpleAtofInternal(std::basic_string_view<CharT> str, Float *out) {
+  *out = 0;
+  const CharT *first = str.data();
+  const CharT *last = first + str.size();
+  while (first < last && IsSpaceFast(first[0])) {
+    ++first;
+  }
+  while (first < last && IsSpaceFast(last[-1])) {
+    --last;
+  }
+  if (first < last && *first == '+') {
+    ++first;
+    if (first < last && *first == '-') {
+      return false;
+    }
+  }
+  if (first == last) {
+    return false;
+  }
+  DecimalNumber d;
+  if (ParseDecimalNumber(first, last, d) && DecimalToFloat(d, out)) {
+    return true;
+  }
+  return FromCharsExact(first, last, out);
+}
+
+// ParseNumbers scans the text once. An integer field is read eight characters per load, the load that contains the
+// delimiter also ends the digits. A float field goes through ParseDecimalPrefix and only fields it cannot take
+// (inf, nan, more than 19 digits, close rounding) are converted again by SimpleAtofInternal.
+template <bool Negative, typename CharT> inline bool ParseFieldDigits(const CharT *&p, const CharT *end, int64_t &value) {
+  uint64_t block = 0;
+  while (end - p >= 8) {
+    const auto n = LoadLeadingDigits(p, &block);
+    if (n != 0 && !AccumulateDigits<Negative>(value, CombineEightDigits(block), n)) {
+      return false;
+    }
+    p += n;
+    if (n != 8) {
+      return true;
+    }
+  }
+  for (; p < end && IsDecimalDigit(static_cast<uint32_t>(*p)); ++p) {
+    if (!AccumulateDigits<Negative>(value, static_cast<uint32_t>(*p) - '0', 1)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// ParseField returns where the number ends, nullptr with ec set when the field does not start with one
+template <typename CharT>
+inline const CharT *ParseField(const CharT *p, const CharT *end, CharT /*delimiter*/, int64_t &value, std::errc &ec) {
+  bool negative = false;
+  if (p < end && (*p == '+' || *p == '-')) {
+    negative = *p == '-';
+    ++p;
+  }
+  const auto digits = p;
+  value = 0;
+  if (!(negative ? ParseFieldDigits<true>(p, end, value) : ParseFieldDigits<false>(p, end, value))) {
+    ec = std::errc::result_out_of_range;
+    return nullptr;
+  }
+  if (p == digits) {
+    ec = std::errc::invalid_argument;
+    return nullptr;
+  }
+  return p;
+}
+
+template <typename CharT>
+inline const CharT *ParseField(const CharT *p, const CharT *end, CharT delimiter, double &value, std::errc &ec) {
+  auto first = p;
+  if (p < end && *p == '+') {
+    ++p;
+  }
+  DecimalNumber d;
+  if (auto q = ParseDecimalPrefix(p, end, d); q != nullptr && (q == end || *q == delimiter || IsSpaceFast(*q)) &&
+                                              (*first != '+' || !d.negative) && DecimalToFloat(d, &value)) {
+    return q;
+  }
+  auto last = first;
+  while (last < end && *last != delimiter) {
+    ++last;
+  }
+  if (!SimpleAtofInternal(std::basic_string_view<CharT>(first, static_cast<size_t>(last - first)), &value)) {
+    ec = std::errc::invalid_argument;
+    return nullptr;
+  }
+  return last;
+}
+
+template <typename T, typename CharT>
+ParseNumbersResult ParseNumbersInternal(std::basic_string_view<CharT> text, CharT delimiter, bela::Span<T> out) {
+  ParseNumbersResult result;
+  const CharT *begin = text.data();
+  const CharT *end = begin + text.size();
+  for (const CharT *p = begin; p < end;) {
+    const CharT *field = p;
+    while (p < end && *p != delimiter && IsSpaceFast(*p)) {
+      ++p;
+    }
+    if (p == end) {
+      break; // blank text after the last delimiter
+    }
+    auto fail = [&](std::errc ec) {
+      result.offset = static_cast<size_t>(field - begin);
+      result.ec = ec;
+      return result;
+    };
+    if (result.count == out.size()) {
+      return fail(std::errc::value_too_large);
+    }
+    std::errc ec{};
+    T value{};
+    p = ParseField(p, end, delimiter, value, ec);
+    if (p == nullptr) {
+      return fail(ec);
+    }
+    while (p < end && *p != delimiter && IsSpaceFast(*p)) {
+      ++p;
+    }
+    if (p < end && *p != delimiter) {
+      return fail(std::errc::invalid_argument);
+    }
+    out[result.count++] = value;
+    if (p < end) {
+      ++p;
+    }
+  }
+  result.offset = text.size();
+  return result;
+}
+
 bool safe_strto32_base(std::wstring_view text, int32_t *value, int base) {
   return safe_int_internal<int32_t>(text, value, base);
 }
@@ -857,4 +1318,47 @@ bool safe_strtou64_base(std::wstring_view text, uint64_t *value, int base) {
 }
 } // namespace numbers_internal
 
+bool SimpleAtof(std::wstring_view str, float *out) { return numbers_internal::SimpleAtofInternal(str, out); }
+
+bool SimpleAtod(std::wstring_view str, double *out) { return numbers_internal::SimpleAtofInternal(str, out); }
+
+ParseNumbersResult ParseNumbers(std::wstring_view text, wchar_t delimiter, bela::Span<int64_t> out) {
+  return numbers_internal::ParseNumbersInternal(text, delimiter, out);
+}
+
+ParseNumbersResult ParseNumbers(std::wstring_view text, wchar_t delimiter, bela::Span<double> out) {
+  return numbers_internal::ParseNumbersInternal(text, delimiter, out);
+}
 } // namespace bela
+
+namespace bela::narrow::numbers_internal {
+bool safe_strto32_base(std::string_view text, int32_t *value, int base) {
+  return bela::numbers_internal::safe_int_internal<int32_t>(text, value, base);
+}
+
+bool safe_strto64_base(std::string_view text, int64_t *value, int base) {
+  return bela::numbers_internal::safe_int_internal<int64_t>(text, value, base);
+}
+
+bool safe_strtou32_base(std::string_view text, uint32_t *value, int base) {
+  return bela::numbers_internal::safe_uint_internal<uint32_t>(text, value, base);
+}
+
+bool safe_strtou64_base(std::string_view text, uint64_t *value, int base) {
+  return bela::numbers_internal::safe_uint_internal<uint64_t>(text, value, base);
+}
+} // namespace bela::narrow::numbers_internal
+
+namespace bela::narrow {
+bool SimpleAtof(std::string_view str, float *out) { return bela::numbers_internal::SimpleAtofInternal(str, out); }
+
+bool SimpleAtod(std::string_view str, double *out) { return bela::numbers_internal::SimpleAtofInternal(str, out); }
+
+ParseNumbersResult ParseNumbers(std::string_view text, char delimiter, bela::Span<int64_t> out) {
+  return bela::numbers_internal::ParseNumbersInternal(text, delimiter, out);
+}
+
+ParseNumbersResult ParseNumbers(std::string_view text, char delimiter, bela::Span<double> out) {
+  return bela::numbers_internal::ParseNumbersInternal(text, delimiter, out);
+}
+} // namespace bela::narrow
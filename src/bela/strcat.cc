@@ -33,6 +33,7 @@
 #include <cassert>
 #include <bela/memutil.hpp>
 #include <bela/strcat.hpp>
+#include <bela/details/itoa.hpp>
 
 namespace bela {
 AlphaNum::AlphaNum(Hex hex) {
@@ -63,11 +64,8 @@ AlphaNum::AlphaNum(Dec dec) {
   wchar_t *writer = end;
   uint64_t value = dec.value;
   bool neg = dec.neg;
-  while (value > 9) {
-    *--writer = '0' + (value % 10);
-    value /= 10;
-  }
-  *--writer = static_cast<wchar_t>('0' + value);
+  writer -= numbers_internal::DigitCount(value);
+  numbers_internal::WriteDecimal(value, writer);
   if (neg)
     *--writer = '-';
 
@@ -15,6 +15,7 @@
 #include <cassert>
 #include <cstring>
 #include <bela/narrow/strcat.hpp>
+#include <bela/details/itoa.hpp>
 #include <bela/endian.hpp>
 #include <bela/bits.hpp>
 #ifdef __SSE4_2__
@@ -96,11 +97,8 @@ AlphaNum::AlphaNum(Dec dec) {
   char *writer = end;
   uint64_t value = dec.value;
   bool neg = dec.neg;
-  while (value > 9) {
-    *--writer = static_cast<char>(L'0' + (value % 10));
-    value /= 10;
-  }
-  *--writer = static_cast<char>(L'0' + value);
+  writer -= bela::numbers_internal::DigitCount(value);
+  bela::numbers_internal::WriteDecimal(value, writer);
   if (neg) {
     *--writer = '-';
   }
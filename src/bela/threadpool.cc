@@ -0,0 +1,144 @@
+///
+#include <algorithm>
+#include <chrono>
+#include <bela/threadpool.hpp>
+
+namespace bela {
+namespace {
+// pool and queue index of the current worker thread
+struct WorkerContext {
+  const ThreadPool *pool{nullptr};
+  size_t index{0};
+};
+thread_local WorkerContext current;
+} // namespace
+
+ThreadPool::ThreadPool(size_t threads) {
+  if (threads == 0) {
+    threads = (std::max)(std::thread::hardware_concurrency(), 1U);
+  }
+  queues.reserve(threads);
+  for (size_t i = 0; i < threads; i++) {
+    queues.emplace_back(std::make_unique<Queue>());
+  }
+  workers.reserve(threads);
+  for (size_t i = 0; i < threads; i++) {
+    workers.emplace_back([this, i] { Work(i); });
+  }
+}
+
+ThreadPool::~ThreadPool() {
+  {
+    std::lock_guard<std::mutex> lock(mu);
+    stopped = true;
+  }
+  cv.notify_all();
+  for (auto &w : workers) {
+    w.join();
+  }
+}
+
+ThreadPool &ThreadPool::Default() {
+  static ThreadPool pool;
+  return pool;
+}
+
+void ThreadPool::Submit(Task task) {
+  // workers push to their own deque, external callers round-robin
+  auto index = current.pool == this ? current.index : next.fetch_add(1, std::memory_order_relaxed) % queues.size();
+  {
+    auto &q = *queues[index];
+    std::lock_guard<std::mutex> lock(q.mu);
+    q.tasks.emplace_back(std::move(task));
+  }
+  queued.fetch_add(1, std::memory_order_release);
+  // pairs with the predicate check in Work: a worker about to sleep holds mu
+  { std::lock_guard<std::mutex> lock(mu); }
+  cv.notify_one();
+}
+
+bool ThreadPool::Pop(size_t index, Task &task) {
+  auto &q = *queues[index];
+  std::lock_guard<std::mutex> lock(q.mu);
+  if (q.tasks.empty()) {
+    return false;
+  }
+  task = std::move(q.tasks.back());
+  q.tasks.pop_back();
+  queued.fetch_sub(1, std::memory_order_relaxed);
+  return true;
+}
+
+bool ThreadPool::Steal(size_t index, Task &task) {
+  for (size_t i = 1; i <= queues.size(); i++) {
+    auto &q = *queues[(index + i) % queues.size()];
+    std::lock_guard<std::mutex> lock(q.mu);
+    if (q.tasks.empty()) {
+      continue;
+    }
+    task = std::move(q.tasks.front());
+    q.tasks.pop_front();
+    queued.fetch_sub(1, std::memory_order_relaxed);
+    return true;
+  }
+  return false;
+}
+
+bool ThreadPool::RunPending() {
+  if (queued.load(std::memory_order_acquire) == 0) {
+    return false;
+  }
+  Task task;
+  if (current.pool == this) {
+    if (!Pop(current.index, task) && !Steal(current.index, task)) {
+      return false;
+    }
+  } else if (!Steal(next.load(std::memory_order_relaxed) % queues.size(), task)) {
+    return false;
+  }
+  task();
+  return true;
+}
+
+void ThreadPool::Work(size_t index) {
+  current.pool = this;
+  current.index = index;
+  for (;;) {
+    Task task;
+    if (Pop(index, task) || Steal(index, task)) {
+      task();
+      continue;
+    }
+    std::unique_lock<std::mutex> lock(mu);
+    cv.wait(lock, [this] { return stopped || queued.load(std::memory_order_acquire) != 0; });
+    if (stopped && queued.load(std::memory_order_acquire) == 0) {
+      return;
+    }
+  }
+}
+
+void TaskGroup::Run(ThreadPool::Task task) {
+  pending.fetch_add(1, std::memory_order_relaxed);
+  pool.Submit([this, task = std::move(task)] {
+    task();
+    // decrement under mu: Wait can't return and destroy the group while we still touch it
+    std::lock_guard<std::mutex> lock(mu);
+    if (pending.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+      cv.notify_all();
+    }
+  });
+}
+
+void TaskGroup::Wait() {
+  while (pending.load(std::memory_order_acquire) != 0) {
+    if (pool.RunPending()) {
+      continue;
+    }
+    // our tasks are running on other threads
+    std::unique_lock<std::mutex> lock(mu);
+    cv.wait_for(lock, std::chrono::milliseconds(1), [this] { return pending.load(std::memory_order_acquire) == 0; });
+  }
+  std::lock_guard<std::mutex> lock(mu);
+}
+
+} // namespace bela
@@ -46,6 +46,28 @@ void blake3_hasher_init_derive_key_raw(blake3_hasher *self, const void *context,
                                        size_t context_len);
 void blake3_hasher_update(blake3_hasher *self, const void *input,
                           size_t input_len);
+// SIMD kernel selection, BLAKE3_BACKEND_AUTO picks the best the CPU supports.
+enum blake3_backend {
+  BLAKE3_BACKEND_AUTO = 0,
+  BLAKE3_BACKEND_PORTABLE,
+  BLAKE3_BACKEND_SSE2,
+  BLAKE3_BACKEND_SSE41,
+  BLAKE3_BACKEND_AVX2,
+  BLAKE3_BACKEND_AVX512,
+  BLAKE3_BACKEND_NEON,
+};
+// Returns 0 if the backend is not compiled in or the CPU can't run it.
+int blake3_set_backend(int backend);
+int blake3_active_backend(void);
+
+// Fork-join hook: run fn(left) and fn(right), possibly concurrently, and
+// return once both have completed.
+typedef void (*blake3_join_fn)(void *ctx, void (*fn)(void *), void *left,
+                               void *right);
+// Same output as blake3_hasher_update(), large subtrees are split with join.
+void blake3_hasher_update_join(blake3_hasher *self, const void *input,
+                               size_t input_len, blake3_join_fn join,
+                               void *join_ctx);
 void blake3_hasher_finalize(const blake3_hasher *self, uint8_t *out,
                             size_t out_len);
 void blake3_hasher_finalize_seek(const blake3_hasher *self, uint64_t seek,
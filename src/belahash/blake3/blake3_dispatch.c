@@ -16,6 +16,22 @@
 
 #define MAYBE_UNUSED(x) (void)((x))
 
+// g_cpu_features and g_backend are read by every hasher while blake3_set_backend
+// may run on another thread: single words, loaded and stored relaxed, no torn or
+// half-updated state is ever visible
+#if defined(__GNUC__) || defined(__clang__)
+#define ATOMIC_LOAD(p) __atomic_load_n((p), __ATOMIC_RELAXED)
+#define ATOMIC_STORE(p, v) __atomic_store_n((p), (v), __ATOMIC_RELAXED)
+#elif defined(_MSC_VER)
+#if !defined(IS_X86)
+#include <intrin.h>
+#endif
+#define ATOMIC_LOAD(p) __iso_volatile_load32((const volatile __int32 *)(p))
+#define ATOMIC_STORE(p, v) __iso_volatile_store32((volatile __int32 *)(p), (__int32)(v))
+#else
+#error "Unimplemented!"
+#endif
+
 #if defined(IS_X86)
 static uint64_t xgetbv() {
 #if defined(_MSC_VER)
@@ -78,59 +94,168 @@ static /* Allow the variable to be controlled manually for testing */
 #endif
     enum cpu_feature g_cpu_features = UNDEFINED;
 
-#if !defined(BLAKE3_TESTING)
-static
-#endif
-    enum cpu_feature
-    get_cpu_features() {
-
-  if (g_cpu_features != UNDEFINED) {
-    return g_cpu_features;
-  } else {
+static enum cpu_feature detect_cpu_features(void) {
 #if defined(IS_X86)
-    uint32_t regs[4] = {0};
-    uint32_t *eax = &regs[0], *ebx = &regs[1], *ecx = &regs[2], *edx = &regs[3];
-    (void)edx;
-    enum cpu_feature features = 0;
-    cpuid(regs, 0);
-    const int max_id = *eax;
-    cpuid(regs, 1);
+  uint32_t regs[4] = {0};
+  uint32_t *eax = &regs[0], *ebx = &regs[1], *ecx = &regs[2], *edx = &regs[3];
+  (void)edx;
+  enum cpu_feature features = 0;
+  cpuid(regs, 0);
+  const int max_id = *eax;
+  cpuid(regs, 1);
 #if defined(__amd64__) || defined(_M_X64)
-    features |= SSE2;
+  features |= SSE2;
 #else
-    if (*edx & (1UL << 26))
-      features |= SSE2;
+  if (*edx & (1UL << 26))
+    features |= SSE2;
 #endif
-    if (*ecx & (1UL << 0))
-      features |= SSSE3;
-    if (*ecx & (1UL << 19))
-      features |= SSE41;
+  if (*ecx & (1UL << 0))
+    features |= SSSE3;
+  if (*ecx & (1UL << 19))
+    features |= SSE41;
 
-    if (*ecx & (1UL << 27)) { // OSXSAVE
-      const uint64_t mask = xgetbv();
-      if ((mask & 6) == 6) { // SSE and AVX states
-        if (*ecx & (1UL << 28))
-          features |= AVX;
-        if (max_id >= 7) {
-          cpuidex(regs, 7, 0);
-          if (*ebx & (1UL << 5))
-            features |= AVX2;
-          if ((mask & 224) == 224) { // Opmask, ZMM_Hi256, Hi16_Zmm
-            if (*ebx & (1UL << 31))
-              features |= AVX512VL;
-            if (*ebx & (1UL << 16))
-              features |= AVX512F;
-          }
+  if (*ecx & (1UL << 27)) { // OSXSAVE
+    const uint64_t mask = xgetbv();
+    if ((mask & 6) == 6) { // SSE and AVX states
+      if (*ecx & (1UL << 28))
+        features |= AVX;
+      if (max_id >= 7) {
+        cpuidex(regs, 7, 0);
+        if (*ebx & (1UL << 5))
+          features |= AVX2;
+        if ((mask & 224) == 224) { // Opmask, ZMM_Hi256, Hi16_Zmm
+          if (*ebx & (1UL << 31))
+            features |= AVX512VL;
+          if (*ebx & (1UL << 16))
+            features |= AVX512F;
         }
       }
     }
-    g_cpu_features = features;
+  }
+  return features;
+#else
+  /* How to detect NEON? */
+  return 0;
+#endif
+}
+
+#if !defined(BLAKE3_TESTING)
+static
+#endif
+    enum cpu_feature
+    get_cpu_features() {
+  enum cpu_feature features = ATOMIC_LOAD(&g_cpu_features);
+  if (features != UNDEFINED) {
     return features;
+  }
+  // racing first callers detect the same value, a blake3_set_backend that got
+  // there first wins
+  features = detect_cpu_features();
+#if defined(__GNUC__) || defined(__clang__)
+  enum cpu_feature expected = UNDEFINED;
+  if (!__atomic_compare_exchange_n(&g_cpu_features, &expected, features, false,
+                                   __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+    return expected;
+  }
 #else
-    /* How to detect NEON? */
+  const long previous = _InterlockedCompareExchange(
+      (volatile long *)&g_cpu_features, (long)features, (long)UNDEFINED);
+  if (previous != (long)UNDEFINED) {
+    return (enum cpu_feature)previous;
+  }
+#endif
+  return features;
+}
+
+// Backend override for benchmarks and tests: cap the features seen by the
+// dispatchers below. Kernels compiled out with BLAKE3_NO_* are refused.
+static bool backend_supported(int backend, enum cpu_feature features) {
+  MAYBE_UNUSED(features);
+  switch (backend) {
+  case BLAKE3_BACKEND_AUTO:
+  case BLAKE3_BACKEND_PORTABLE:
+    return true;
+#if defined(IS_X86)
+#if !defined(BLAKE3_NO_SSE2)
+  case BLAKE3_BACKEND_SSE2:
+    return (features & SSE2) != 0;
+#endif
+#if !defined(BLAKE3_NO_SSE41)
+  case BLAKE3_BACKEND_SSE41:
+    return (features & SSE41) != 0;
+#endif
+#if !defined(BLAKE3_NO_AVX2)
+  case BLAKE3_BACKEND_AVX2:
+    return (features & AVX2) != 0;
+#endif
+#if !defined(BLAKE3_NO_AVX512)
+  case BLAKE3_BACKEND_AVX512:
+    return (features & (AVX512F | AVX512VL)) == (AVX512F | AVX512VL);
+#endif
+#endif
+#if defined(BLAKE3_USE_NEON)
+  case BLAKE3_BACKEND_NEON:
+    return true;
+#endif
+  default:
+    break;
+  }
+  return false;
+}
+
+static int g_backend = BLAKE3_BACKEND_AUTO;
+
+int blake3_set_backend(int backend) {
+  // detect with the full feature set, then narrow it down. Hashers keep using
+  // the previous kernels until the single store below
+  const enum cpu_feature detected = detect_cpu_features();
+  if (!backend_supported(backend, detected)) {
     return 0;
+  }
+  enum cpu_feature allowed = detected;
+  switch (backend) {
+  case BLAKE3_BACKEND_PORTABLE:
+    allowed = 0;
+    break;
+  case BLAKE3_BACKEND_SSE2:
+    allowed = SSE2;
+    break;
+  case BLAKE3_BACKEND_SSE41:
+    allowed = SSE2 | SSSE3 | SSE41;
+    break;
+  case BLAKE3_BACKEND_AVX2:
+    allowed = SSE2 | SSSE3 | SSE41 | AVX | AVX2;
+    break;
+  default:
+    break;
+  }
+  ATOMIC_STORE(&g_cpu_features, detected & allowed);
+  ATOMIC_STORE(&g_backend, backend);
+  return 1;
+}
+
+int blake3_active_backend(void) {
+#if defined(BLAKE3_USE_NEON)
+  return ATOMIC_LOAD(&g_backend) == BLAKE3_BACKEND_PORTABLE ? BLAKE3_BACKEND_PORTABLE
+                                              : BLAKE3_BACKEND_NEON;
+#else
+  switch (blake3_simd_degree()) {
+  case 16:
+    return BLAKE3_BACKEND_AVX512;
+  case 8:
+    return BLAKE3_BACKEND_AVX2;
+  case 4:
+#if defined(IS_X86) && !defined(BLAKE3_NO_SSE41)
+    if (get_cpu_features() & SSE41) {
+      return BLAKE3_BACKEND_SSE41;
+    }
 #endif
+    return BLAKE3_BACKEND_SSE2;
+  default:
+    break;
   }
+  return BLAKE3_BACKEND_PORTABLE;
+#endif
 }
 
 void blake3_compress_in_place(uint32_t cv[8],
@@ -233,9 +358,12 @@ void blake3_hash_many(const uint8_t *const *inputs, size_t num_inputs,
 #endif
 
 #if defined(BLAKE3_USE_NEON)
-  blake3_hash_many_neon(inputs, num_inputs, blocks, key, counter,
-                        increment_counter, flags, flags_start, flags_end, out);
-  return;
+  if (ATOMIC_LOAD(&g_backend) != BLAKE3_BACKEND_PORTABLE) {
+    blake3_hash_many_neon(inputs, num_inputs, blocks, key, counter,
+                          increment_counter, flags, flags_start, flags_end,
+                          out);
+    return;
+  }
 #endif
 
   blake3_hash_many_portable(inputs, num_inputs, blocks, key, counter,
@@ -270,7 +398,9 @@ size_t blake3_simd_degree(void) {
 #endif
 #endif
 #if defined(BLAKE3_USE_NEON)
-  return 4;
+  if (ATOMIC_LOAD(&g_backend) != BLAKE3_BACKEND_PORTABLE) {
+    return 4;
+  }
 #endif
   return 1;
 }
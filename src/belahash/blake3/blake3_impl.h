@@ -53,6 +53,10 @@ enum blake3_flags {
 #define MAX_SIMD_DEGREE 1
 #endif
 
+// blake3_hasher_update_join() only splits subtrees whose right half is at
+// least this long, smaller ones are left to SIMD on the current thread.
+#define BLAKE3_JOIN_MIN_LEN (128 * BLAKE3_CHUNK_LEN)
+
 // There are some places where we want a static size that's equal to the
 // MAX_SIMD_DEGREE, but also at least 2.
 #define MAX_SIMD_DEGREE_OR_2 (MAX_SIMD_DEGREE > 2 ? MAX_SIMD_DEGREE : 2)
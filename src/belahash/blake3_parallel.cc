@@ -0,0 +1,43 @@
+/// BLAKE3 multithreaded tree hashing
+// blake3_compress_subtree_wide splits input into power-of-2 subtrees, with a join hook the two
+// halves of a large subtree run as a fork-join pair on the pool and their chaining values are
+// merged by the parent compression exactly as on a single thread.
+#include <bela/hash.hpp>
+#include <bela/threadpool.hpp>
+#if defined(_WIN32)
+// the file entry point is Windows only, the tree hashing itself builds everywhere
+#include <bela/mapview.hpp>
+#endif
+
+namespace bela::hash::blake3 {
+namespace {
+void pool_join(void *ctx, void (*fn)(void *), void *left, void *right) {
+  bela::TaskGroup g(*reinterpret_cast<bela::ThreadPool *>(ctx));
+  g.Run([fn, right] { fn(right); });
+  fn(left);
+  g.Wait();
+}
+} // namespace
+
+void Hasher::UpdateParallel(const void *input, size_t input_len, bela::ThreadPool &pool) {
+  blake3_hasher_update_join(&h, input, input_len, pool_join, &pool);
+}
+
+#if defined(_WIN32)
+bool Hasher::UpdateFile(std::wstring_view file, bela::ThreadPool &pool, bela::error_code &ec) {
+  bela::MapView mv;
+  if (!mv.MappingView(file, ec)) {
+    if (ec.code == bela::FileSizeTooSmall) {
+      // empty file, nothing to hash
+      ec = bela::error_code{};
+      return true;
+    }
+    return false;
+  }
+  auto mem = mv.subview();
+  UpdateParallel(mem.data(), mem.size(), pool);
+  return true;
+}
+#endif
+
+} // namespace bela::hash::blake3
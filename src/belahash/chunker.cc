@@ -0,0 +1,215 @@
+///
+#include <algorithm>
+#include <array>
+#include <bela/chunker.hpp>
+#include <bela/threadpool.hpp>
+#if defined(_WIN32)
+#include <bela/mapview.hpp>
+#endif
+
+namespace bela::hash {
+namespace {
+// gear table from splitmix64, changing it changes every chunk boundary
+constexpr std::array<uint64_t, 256> make_gear_table() {
+  std::array<uint64_t, 256> table{};
+  uint64_t x = 0x6A09E667F3BCC908ULL;
+  for (size_t i = 0; i < table.size(); i++) {
+    x += 0x9E3779B97F4A7C15ULL;
+    auto z = x;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    table[i] = z ^ (z >> 31);
+  }
+  return table;
+}
+constexpr auto gear = make_gear_table();
+
+// the gear hash shifts left, the high bits depend on the most bytes, so masks take those
+constexpr uint64_t high_mask(size_t bits) { return bits == 0 ? 0 : ~uint64_t{0} << (64 - bits); }
+
+// batch small chunks so a pool task hashes about this many bytes
+constexpr size_t task_bytes = 1024 * 1024;
+
+void HashChunk(Algorithm algorithm, const uint8_t *data, Chunk &c) {
+  AnyHasher h(algorithm);
+  h.Update(data, c.length);
+  c.digest.algorithm = algorithm;
+  c.digest.length = h.DigestLength();
+  h.Finalize(c.digest.digest, c.digest.length);
+}
+
+// HashBatches digests chunks[first...] in place on g, base holds the bytes of chunks[first]
+template <typename Chunks>
+void HashBatches(bela::TaskGroup &g, Algorithm algorithm, const uint8_t *base, Chunks &chunks, size_t first) {
+  if (first == chunks.size()) {
+    return;
+  }
+  const auto origin = chunks[first].offset;
+  for (size_t i = first; i < chunks.size();) {
+    auto begin = i;
+    size_t bytes = 0;
+    for (; i < chunks.size() && bytes < task_bytes; i++) {
+      bytes += chunks[i].length;
+    }
+    g.Run([algorithm, base, origin, &chunks, begin, end = i] {
+      for (auto k = begin; k < end; k++) {
+        HashChunk(algorithm, base + (chunks[k].offset - origin), chunks[k]);
+      }
+    });
+  }
+}
+} // namespace
+
+Chunker::Chunker(const ChunkerOptions &options_)
+    : options(options_), pool(options_.pool != nullptr ? *options_.pool : bela::ThreadPool::Default()) {
+  size_t bits = 6;
+  while (bits < 30 && (size_t{1} << (bits + 1)) <= options.avg_size) {
+    bits++;
+  }
+  options.avg_size = size_t{1} << bits;
+  options.min_size = (std::min)((std::max)(options.min_size, size_t{64}), options.avg_size);
+  options.max_size = (std::max)(options.max_size, options.avg_size);
+  mask_s = high_mask(bits + 2);
+  mask_l = high_mask(bits - 2);
+  group = std::make_unique<bela::TaskGroup>(pool);
+}
+
+Chunker::~Chunker() {
+  // queued tasks write digests into chunks, which is destroyed before group
+  if (group) {
+    group->Wait();
+  }
+}
+
+size_t Chunker::Cut(const uint8_t *data, size_t n) const {
+  if (n <= options.min_size) {
+    return n;
+  }
+  if (n > options.max_size) {
+    n = options.max_size;
+  }
+  const auto barrier = (std::min)(options.avg_size, n);
+  uint64_t fp = 0;
+  size_t i = options.min_size;
+  for (; i < barrier; i++) {
+    fp = (fp << 1) + gear[data[i]];
+    if ((fp & mask_s) == 0) {
+      return i + 1;
+    }
+  }
+  for (; i < n; i++) {
+    fp = (fp << 1) + gear[data[i]];
+    if ((fp & mask_l) == 0) {
+      return i + 1;
+    }
+  }
+  return n;
+}
+
+void Chunker::Emit(const uint8_t *data, size_t n) {
+  auto &c = chunks.emplace_back();
+  c.offset = offset;
+  c.length = n;
+  offset += n;
+  auto buffer = std::make_shared<std::vector<uint8_t>>(data, data + n);
+  group->Run([algorithm = options.algorithm, buffer, &c] { HashChunk(algorithm, buffer->data(), c); });
+  // bound the copies waiting for a worker when the stream outruns hashing
+  inflight += n;
+  if (inflight >= pool.Size() * 4 * options.max_size) {
+    group->Wait();
+    inflight = 0;
+  }
+}
+
+// Update only cuts with max_size bytes at hand, then a boundary doesn't depend on how the stream was split.
+// Less than max_size bytes are carried over between calls, everything else is scanned in place.
+void Chunker::Update(const void *input, size_t input_len) {
+  auto p = reinterpret_cast<const uint8_t *>(input);
+  // join the carry-over with the head of input until a chunk starts inside input
+  for (size_t absorbed = 0; !pending.empty();) {
+    const auto carry = pending.size() - absorbed;
+    const auto take = (std::min)(options.max_size - pending.size(), input_len - absorbed);
+    pending.insert(pending.end(), p + absorbed, p + absorbed + take);
+    absorbed += take;
+    if (pending.size() < options.max_size) {
+      return;
+    }
+    auto n = Cut(pending.data(), options.max_size);
+    Emit(pending.data(), n);
+    if (n >= carry) {
+      p += n - carry;
+      input_len -= n - carry;
+      pending.clear();
+      break;
+    }
+    pending.erase(pending.begin(), pending.begin() + n);
+  }
+  // chunks inside input are views, hashed on the pool before the caller gets its buffer back
+  const auto first = chunks.size();
+  const auto base = p;
+  while (input_len >= options.max_size) {
+    auto &c = chunks.emplace_back();
+    c.offset = offset;
+    c.length = Cut(p, options.max_size);
+    offset += c.length;
+    p += c.length;
+    input_len -= c.length;
+  }
+  if (first != chunks.size()) {
+    HashBatches(*group, options.algorithm, base, chunks, first);
+    group->Wait();
+    inflight = 0;
+  }
+  pending.assign(p, p + input_len);
+}
+
+std::vector<Chunk> Chunker::Finalize() {
+  size_t pos = 0;
+  while (pos < pending.size()) {
+    auto n = Cut(pending.data() + pos, pending.size() - pos);
+    Emit(pending.data() + pos, n);
+    pos += n;
+  }
+  group->Wait();
+  std::vector<Chunk> result(std::make_move_iterator(chunks.begin()), std::make_move_iterator(chunks.end()));
+  chunks.clear();
+  pending.clear();
+  offset = 0;
+  inflight = 0;
+  return result;
+}
+
+std::vector<Chunk> Chunker::Split(const void *data, size_t len) {
+  auto p = reinterpret_cast<const uint8_t *>(data);
+  std::vector<Chunk> result;
+  for (size_t pos = 0; pos < len;) {
+    auto &c = result.emplace_back();
+    c.offset = pos;
+    c.length = Cut(p + pos, len - pos);
+    pos += c.length;
+  }
+  // boundaries are known, the vector no longer grows
+  bela::TaskGroup g(pool);
+  HashBatches(g, options.algorithm, p, result, 0);
+  g.Wait();
+  return result;
+}
+
+#if defined(_WIN32)
+bool Chunker::SplitFile(std::wstring_view path, std::vector<Chunk> &out, bela::error_code &ec) {
+  bela::MapView mv;
+  if (!mv.MappingView(path, ec)) {
+    if (ec.code == bela::FileSizeTooSmall) {
+      ec = bela::error_code{};
+      out.clear();
+      return true;
+    }
+    return false;
+  }
+  auto mem = mv.subview();
+  out = Split(mem.data(), mem.size());
+  return true;
+}
+#endif
+
+} // namespace bela::hash
@@ -0,0 +1,15 @@
+///
+#ifndef BELA_HASH_CPUFEATURES_HPP
+#define BELA_HASH_CPUFEATURES_HPP
+#include <bela/details/cpufeatures.hpp>
+
+#if defined(BELA_CPU_X86)
+#define BELA_HASH_X86 1
+#endif
+
+namespace bela::hash::internal {
+using bela::cpu_internal::CpuFeatures;
+using bela::cpu_internal::GetCpuFeatures;
+} // namespace bela::hash::internal
+
+#endif
@@ -0,0 +1,134 @@
+///
+#include <bela/checksum.hpp>
+#include "cpufeatures.hpp"
+#include "crc32c_impl.hpp"
+#if (defined(__aarch64__) && defined(__ARM_FEATURE_CRC32)) || defined(_M_ARM64)
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <arm_acle.h>
+#endif
+#define BELA_HASH_ARM_CRC32 1
+#endif
+
+namespace bela::hash::crc32c {
+namespace {
+constexpr uint32_t crc32c_poly = 0x82F63B78; // reflected Castagnoli
+
+struct SliceTable {
+  uint32_t t[8][256];
+};
+
+constexpr SliceTable make_slice_table() {
+  SliceTable st{};
+  for (uint32_t n = 0; n < 256; n++) {
+    auto crc = n;
+    for (int k = 0; k < 8; k++) {
+      crc = (crc & 1) != 0 ? (crc >> 1) ^ crc32c_poly : crc >> 1;
+    }
+    st.t[0][n] = crc;
+  }
+  for (uint32_t n = 0; n < 256; n++) {
+    auto crc = st.t[0][n];
+    for (int k = 1; k < 8; k++) {
+      crc = st.t[0][crc & 0xff] ^ (crc >> 8);
+      st.t[k][n] = crc;
+    }
+  }
+  return st;
+}
+constexpr auto slice = make_slice_table();
+
+// zero-bytes operators, after Mark Adler's crc32c.c: a crc over len zero bytes is a linear
+// map over GF(2), kept as a 32x32 bit matrix and built by repeated squaring (len power of two)
+constexpr uint32_t gf2_matrix_times(const uint32_t *mat, uint32_t vec) {
+  uint32_t sum = 0;
+  for (; vec != 0; vec >>= 1, mat++) {
+    if ((vec & 1) != 0) {
+      sum ^= *mat;
+    }
+  }
+  return sum;
+}
+
+constexpr void gf2_matrix_square(uint32_t *square, const uint32_t *mat) {
+  for (int n = 0; n < 32; n++) {
+    square[n] = gf2_matrix_times(mat, mat[n]);
+  }
+}
+
+constexpr ZeroTable make_zero_table(size_t len) {
+  uint32_t even[32]{};
+  uint32_t odd[32]{};
+  odd[0] = crc32c_poly; // one zero bit
+  for (int n = 1; n < 32; n++) {
+    odd[n] = uint32_t{1} << (n - 1);
+  }
+  gf2_matrix_square(even, odd); // two zero bits
+  gf2_matrix_square(odd, even); // four zero bits
+  const uint32_t *op = even;
+  for (;;) {
+    gf2_matrix_square(even, odd); // one zero byte on the first pass
+    len >>= 1;
+    if (len == 0) {
+      op = even;
+      break;
+    }
+    gf2_matrix_square(odd, even);
+    len >>= 1;
+    if (len == 0) {
+      op = odd;
+      break;
+    }
+  }
+  ZeroTable zt{};
+  for (uint32_t n = 0; n < 256; n++) {
+    zt.t[0][n] = gf2_matrix_times(op, n);
+    zt.t[1][n] = gf2_matrix_times(op, n << 8);
+    zt.t[2][n] = gf2_matrix_times(op, n << 16);
+    zt.t[3][n] = gf2_matrix_times(op, n << 24);
+  }
+  return zt;
+}
+
+uint32_t crc32c_portable(uint32_t crc, const uint8_t *p, size_t len) {
+  for (; len != 0 && (reinterpret_cast<uintptr_t>(p) & 7) != 0; len--) {
+    crc = slice.t[0][(crc ^ *p++) & 0xff] ^ (crc >> 8);
+  }
+  for (; len >= 8; len -= 8, p += 8) {
+    const auto lo = crc ^ (static_cast<uint32_t>(p[0]) | static_cast<uint32_t>(p[1]) << 8 |
+                           static_cast<uint32_t>(p[2]) << 16 | static_cast<uint32_t>(p[3]) << 24);
+    crc = slice.t[7][lo & 0xff] ^ slice.t[6][(lo >> 8) & 0xff] ^ slice.t[5][(lo >> 16) & 0xff] ^ slice.t[4][lo >> 24] ^
+          slice.t[3][p[4]] ^ slice.t[2][p[5]] ^ slice.t[1][p[6]] ^ slice.t[0][p[7]];
+  }
+  for (; len != 0; len--) {
+    crc = slice.t[0][(crc ^ *p++) & 0xff] ^ (crc >> 8);
+  }
+  return crc;
+}
+
+#if defined(BELA_HASH_ARM_CRC32)
+// CRC32 instructions are mandatory from ARMv8.1, Windows arm64 requires them
+struct Armv8 {
+  static uint32_t U8(uint32_t crc, uint8_t b) { return __crc32cb(crc, b); }
+  static uint32_t U64(uint32_t crc, uint64_t v) { return __crc32cd(crc, v); }
+};
+#endif
+} // namespace
+
+extern const ZeroTable crc32c_long = make_zero_table(crc32c_long_len);
+extern const ZeroTable crc32c_short = make_zero_table(crc32c_short_len);
+
+uint32_t Extend(uint32_t crc, const void *data, size_t len) {
+  auto p = reinterpret_cast<const uint8_t *>(data);
+#if defined(BELA_HASH_X86)
+  static const bool sse42 = internal::GetCpuFeatures().sse42;
+  if (sse42) {
+    return ~crc32c_sse42(~crc, p, len);
+  }
+#elif defined(BELA_HASH_ARM_CRC32)
+  return ~crc32c_hw<Armv8>(~crc, p, len);
+#endif
+  return ~crc32c_portable(~crc, p, len);
+}
+} // namespace bela::hash::crc32c
@@ -0,0 +1,69 @@
+///
+#ifndef BELA_HASH_CRC32C_IMPL_HPP
+#define BELA_HASH_CRC32C_IMPL_HPP
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace bela::hash::crc32c {
+// three streams of this many bytes are run side by side to hide the crc32 instruction latency,
+// crc32c_long/crc32c_short shift a crc over that many zero bytes
+constexpr size_t crc32c_long_len = 8192;
+constexpr size_t crc32c_short_len = 256;
+struct ZeroTable {
+  uint32_t t[4][256];
+};
+extern const ZeroTable crc32c_long;
+extern const ZeroTable crc32c_short;
+
+inline uint32_t crc32c_shift(const ZeroTable &zeros, uint32_t crc) {
+  return zeros.t[0][crc & 0xff] ^ zeros.t[1][(crc >> 8) & 0xff] ^ zeros.t[2][(crc >> 16) & 0xff] ^
+         zeros.t[3][crc >> 24];
+}
+
+// crc32c_hw Ops::U8/Ops::U64 are the hardware crc32c instructions, crc is pre-inverted
+template <typename Ops> uint32_t crc32c_hw(uint32_t crc, const uint8_t *p, size_t len) {
+  auto load64 = [](const uint8_t *b) {
+    uint64_t v;
+    memcpy(&v, b, sizeof(v));
+    return v;
+  };
+  while (len != 0 && (reinterpret_cast<uintptr_t>(p) & 7) != 0) {
+    crc = Ops::U8(crc, *p++);
+    len--;
+  }
+  auto triple = [&](size_t stride, const ZeroTable &zeros) {
+    while (len >= stride * 3) {
+      uint32_t crc1 = 0;
+      uint32_t crc2 = 0;
+      const auto end = p + stride;
+      do {
+        crc = Ops::U64(crc, load64(p));
+        crc1 = Ops::U64(crc1, load64(p + stride));
+        crc2 = Ops::U64(crc2, load64(p + stride * 2));
+        p += 8;
+      } while (p < end);
+      crc = crc32c_shift(zeros, crc) ^ crc1;
+      crc = crc32c_shift(zeros, crc) ^ crc2;
+      p += stride * 2;
+      len -= stride * 3;
+    }
+  };
+  triple(crc32c_long_len, crc32c_long);
+  triple(crc32c_short_len, crc32c_short);
+  for (; len >= 8; len -= 8, p += 8) {
+    crc = Ops::U64(crc, load64(p));
+  }
+  for (; len != 0; len--) {
+    crc = Ops::U8(crc, *p++);
+  }
+  return crc;
+}
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+// crc32c_sse42.cc
+uint32_t crc32c_sse42(uint32_t crc, const uint8_t *p, size_t len);
+#endif
+} // namespace bela::hash::crc32c
+
+#endif
@@ -0,0 +1,22 @@
+/// CRC-32C SSE4.2 backend
+// GCC/Clang: compile with -msse4.2
+#include <nmmintrin.h>
+#include "crc32c_impl.hpp"
+
+namespace bela::hash::crc32c {
+namespace {
+struct Sse42 {
+  static uint32_t U8(uint32_t crc, uint8_t b) { return _mm_crc32_u8(crc, b); }
+  static uint32_t U64(uint32_t crc, uint64_t v) {
+#if defined(__x86_64__) || defined(_M_X64)
+    return static_cast<uint32_t>(_mm_crc32_u64(crc, v));
+#else
+    crc = _mm_crc32_u32(crc, static_cast<uint32_t>(v));
+    return _mm_crc32_u32(crc, static_cast<uint32_t>(v >> 32));
+#endif
+  }
+};
+} // namespace
+
+uint32_t crc32c_sse42(uint32_t crc, const uint8_t *p, size_t len) { return crc32c_hw<Sse42>(crc, p, len); }
+} // namespace bela::hash::crc32c
@@ -0,0 +1,96 @@
+///
+#include <bela/hash.hpp>
+#include "cpufeatures.hpp"
+#include "encode_impl.hpp"
+#if defined(__aarch64__) || defined(_M_ARM64)
+#include <arm_neon.h>
+#define BELA_HASH_NEON 1
+#endif
+
+namespace bela::hash {
+namespace {
+constexpr char hex_digits[] = "0123456789abcdef";
+constexpr char base64_digits[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+template <typename CharT> void encode_hex_scalar(const uint8_t *b, size_t len, CharT *out) {
+  for (size_t i = 0; i < len; i++) {
+    *out++ = static_cast<CharT>(hex_digits[b[i] >> 4]);
+    *out++ = static_cast<CharT>(hex_digits[b[i] & 0xf]);
+  }
+}
+
+#if defined(BELA_HASH_NEON)
+// NEON is baseline on arm64: tbl does the nibble lookup, st2 interleaves high and low digits
+inline uint8x16x2_t hex16_neon(const uint8_t *b) {
+  const auto lut = vld1q_u8(reinterpret_cast<const uint8_t *>(hex_digits));
+  const auto x = vld1q_u8(b);
+  uint8x16x2_t v;
+  v.val[0] = vqtbl1q_u8(lut, vshrq_n_u8(x, 4));
+  v.val[1] = vqtbl1q_u8(lut, vandq_u8(x, vdupq_n_u8(0x0f)));
+  return v;
+}
+
+size_t encode_hex_neon(const uint8_t *b, size_t len, char *out) {
+  size_t i = 0;
+  for (; i + 16 <= len; i += 16) {
+    vst2q_u8(reinterpret_cast<uint8_t *>(out + i * 2), hex16_neon(b + i));
+  }
+  return i;
+}
+
+size_t encode_hex_neon(const uint8_t *b, size_t len, wchar_t *out) {
+  size_t i = 0;
+  uint8_t buf[32];
+  for (; i + 16 <= len; i += 16) {
+    vst2q_u8(buf, hex16_neon(b + i));
+    for (size_t k = 0; k < 32; k++) {
+      out[i * 2 + k] = static_cast<wchar_t>(buf[k]);
+    }
+  }
+  return i;
+}
+#endif
+
+template <typename CharT> size_t encode_hex(const uint8_t *b, size_t len, CharT *out) {
+  size_t done = 0;
+#if defined(BELA_HASH_X86)
+  if (len >= 16 && internal::GetCpuFeatures().ssse3) {
+    done = internal::encode_hex_ssse3(b, len, out);
+  }
+#elif defined(BELA_HASH_NEON)
+  done = encode_hex_neon(b, len, out);
+#endif
+  encode_hex_scalar(b + done, len - done, out + done * 2);
+  return HexEncodedLength(len);
+}
+
+template <typename CharT> size_t encode_base64(const uint8_t *b, size_t len, CharT *out) {
+  auto p = out;
+  size_t i = 0;
+  for (; i + 3 <= len; i += 3) {
+    const uint32_t v = (static_cast<uint32_t>(b[i]) << 16) | (static_cast<uint32_t>(b[i + 1]) << 8) | b[i + 2];
+    *p++ = static_cast<CharT>(base64_digits[(v >> 18) & 0x3f]);
+    *p++ = static_cast<CharT>(base64_digits[(v >> 12) & 0x3f]);
+    *p++ = static_cast<CharT>(base64_digits[(v >> 6) & 0x3f]);
+    *p++ = static_cast<CharT>(base64_digits[v & 0x3f]);
+  }
+  if (auto rest = len - i; rest != 0) {
+    uint32_t v = static_cast<uint32_t>(b[i]) << 16;
+    if (rest == 2) {
+      v |= static_cast<uint32_t>(b[i + 1]) << 8;
+    }
+    *p++ = static_cast<CharT>(base64_digits[(v >> 18) & 0x3f]);
+    *p++ = static_cast<CharT>(base64_digits[(v >> 12) & 0x3f]);
+    *p++ = rest == 2 ? static_cast<CharT>(base64_digits[(v >> 6) & 0x3f]) : static_cast<CharT>('=');
+    *p++ = static_cast<CharT>('=');
+  }
+  return static_cast<size_t>(p - out);
+}
+} // namespace
+
+size_t EncodeHex(const uint8_t *b, size_t len, char *out) { return encode_hex(b, len, out); }
+size_t EncodeHex(const uint8_t *b, size_t len, wchar_t *out) { return encode_hex(b, len, out); }
+size_t EncodeBase64(const uint8_t *b, size_t len, char *out) { return encode_base64(b, len, out); }
+size_t EncodeBase64(const uint8_t *b, size_t len, wchar_t *out) { return encode_base64(b, len, out); }
+
+} // namespace bela::hash
@@ -0,0 +1,13 @@
+///
+#ifndef BELA_HASH_ENCODE_IMPL_HPP
+#define BELA_HASH_ENCODE_IMPL_HPP
+#include <cstddef>
+#include <cstdint>
+
+namespace bela::hash::internal {
+// SSSE3 hex kernels, consume whole 16 byte blocks only. return input bytes consumed
+size_t encode_hex_ssse3(const uint8_t *b, size_t len, char *out);
+size_t encode_hex_ssse3(const uint8_t *b, size_t len, wchar_t *out);
+} // namespace bela::hash::internal
+
+#endif
@@ -0,0 +1,57 @@
+/// hex encoding SSSE3 backend: nibbles looked up 16 at a time with pshufb
+// GCC/Clang: compile with -mssse3
+#include <tmmintrin.h>
+#include "encode_impl.hpp"
+
+namespace bela::hash::internal {
+namespace {
+// 16 input bytes -> 32 hex digits, lo holds the first 16 digits
+inline void hex16(const uint8_t *b, __m128i &lo, __m128i &hi) {
+  const auto lut = _mm_setr_epi8('0', '1', '2', '3', '4', '5', '6', '7', '8', '9', 'a', 'b', 'c', 'd', 'e', 'f');
+  const auto mask = _mm_set1_epi8(0x0f);
+  const auto x = _mm_loadu_si128(reinterpret_cast<const __m128i *>(b));
+  const auto h = _mm_shuffle_epi8(lut, _mm_and_si128(_mm_srli_epi16(x, 4), mask));
+  const auto l = _mm_shuffle_epi8(lut, _mm_and_si128(x, mask));
+  lo = _mm_unpacklo_epi8(h, l);
+  hi = _mm_unpackhi_epi8(h, l);
+}
+
+inline void store_wide(wchar_t *out, __m128i v) {
+  const auto zero = _mm_setzero_si128();
+  const auto w0 = _mm_unpacklo_epi8(v, zero);
+  const auto w1 = _mm_unpackhi_epi8(v, zero);
+  if constexpr (sizeof(wchar_t) == 2) {
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(out), w0);
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(out + 8), w1);
+  } else {
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(out), _mm_unpacklo_epi16(w0, zero));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(out + 4), _mm_unpackhi_epi16(w0, zero));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(out + 8), _mm_unpacklo_epi16(w1, zero));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(out + 12), _mm_unpackhi_epi16(w1, zero));
+  }
+}
+} // namespace
+
+size_t encode_hex_ssse3(const uint8_t *b, size_t len, char *out) {
+  size_t i = 0;
+  for (; i + 16 <= len; i += 16) {
+    __m128i lo, hi;
+    hex16(b + i, lo, hi);
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(out + i * 2), lo);
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(out + i * 2 + 16), hi);
+  }
+  return i;
+}
+
+size_t encode_hex_ssse3(const uint8_t *b, size_t len, wchar_t *out) {
+  size_t i = 0;
+  for (; i + 16 <= len; i += 16) {
+    __m128i lo, hi;
+    hex16(b + i, lo, hi);
+    store_wide(out + i * 2, lo);
+    store_wide(out + i * 2 + 16, hi);
+  }
+  return i;
+}
+
+} // namespace bela::hash::internal
@@ -0,0 +1,224 @@
+///
+#include <algorithm>
+#include <bela/hashfile.hpp>
+#include <bela/multihash.hpp>
+#if defined(_WIN32)
+#include <bela/base.hpp>
+#include <bela/mapview.hpp>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "posix_error.hpp"
+#endif
+
+namespace bela::hash {
+namespace {
+constexpr size_t buffer_alignment = 64 * 1024;
+constexpr size_t maximum_buffer_size = 256 * 1024 * 1024;
+
+// File one handle serves the size, the positional reads and the read-only mapping
+#if defined(_WIN32)
+class File {
+public:
+  File() = default;
+  File(const File &) = delete;
+  File &operator=(const File &) = delete;
+  ~File() {
+    if (fd != INVALID_HANDLE_VALUE) {
+      CloseHandle(fd);
+    }
+  }
+  bool Open(std::wstring_view path, bela::error_code &ec) {
+    fd = CreateFileW(path.data(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr, OPEN_EXISTING,
+                     FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (fd == INVALID_HANDLE_VALUE) {
+      ec = bela::make_system_error_code();
+      return false;
+    }
+    return true;
+  }
+  bool Size(uint64_t &size, bela::error_code &ec) {
+    LARGE_INTEGER li;
+    if (GetFileSizeEx(fd, &li) != TRUE) {
+      ec = bela::make_system_error_code();
+      return false;
+    }
+    size = static_cast<uint64_t>(li.QuadPart);
+    return true;
+  }
+  // ReadAt positional read (pread), the file pointer is not used so no seek syscalls
+  bool ReadAt(uint8_t *buffer, size_t len, uint64_t offset, size_t &got, bela::error_code &ec) {
+    got = 0;
+    while (got < len) {
+      OVERLAPPED ov{};
+      ov.Offset = static_cast<DWORD>(offset);
+      ov.OffsetHigh = static_cast<DWORD>(offset >> 32);
+      DWORD dwRead = 0;
+      if (::ReadFile(fd, buffer + got, static_cast<DWORD>(len - got), &dwRead, &ov) != TRUE) {
+        if (GetLastError() == ERROR_HANDLE_EOF) {
+          return true;
+        }
+        ec = bela::make_system_error_code(L"ReadFile: ");
+        return false;
+      }
+      if (dwRead == 0) {
+        return true;
+      }
+      got += dwRead;
+      offset += dwRead;
+    }
+    return true;
+  }
+  // Map the whole file, MapView takes the handle over
+  const uint8_t *Map(bela::error_code &ec) {
+    if (!mv.MappingHandle(std::exchange(fd, INVALID_HANDLE_VALUE), ec)) {
+      return nullptr;
+    }
+    return mv.subview().data();
+  }
+
+private:
+  HANDLE fd{INVALID_HANDLE_VALUE};
+  bela::MapView mv;
+};
+#else
+using internal::make_errno_error_code;
+
+class File {
+public:
+  File() = default;
+  File(const File &) = delete;
+  File &operator=(const File &) = delete;
+  ~File() {
+    if (view != MAP_FAILED) {
+      ::munmap(view, viewSize);
+    }
+    if (fd != -1) {
+      ::close(fd);
+    }
+  }
+  bool Open(std::wstring_view path, bela::error_code &ec) {
+    if ((fd = ::open(bela::ToNarrow(path).data(), O_RDONLY | O_CLOEXEC)) == -1) {
+      ec = make_errno_error_code(L"open: ");
+      return false;
+    }
+    return true;
+  }
+  bool Size(uint64_t &size, bela::error_code &ec) {
+    struct stat st;
+    if (::fstat(fd, &st) != 0) {
+      ec = make_errno_error_code(L"fstat: ");
+      return false;
+    }
+    size = static_cast<uint64_t>(st.st_size);
+    return true;
+  }
+  bool ReadAt(uint8_t *buffer, size_t len, uint64_t offset, size_t &got, bela::error_code &ec) {
+    got = 0;
+    while (got < len) {
+      auto n = ::pread(fd, buffer + got, len - got, static_cast<off_t>(offset));
+      if (n < 0) {
+        if (errno == EINTR) {
+          continue;
+        }
+        ec = make_errno_error_code(L"pread: ");
+        return false;
+      }
+      if (n == 0) {
+        return true;
+      }
+      got += static_cast<size_t>(n);
+      offset += static_cast<uint64_t>(n);
+    }
+    return true;
+  }
+  const uint8_t *Map(bela::error_code &ec) {
+    uint64_t size = 0;
+    if (!Size(size, ec)) {
+      return nullptr;
+    }
+    viewSize = static_cast<size_t>(size);
+    if ((view = ::mmap(nullptr, viewSize, PROT_READ, MAP_PRIVATE, fd, 0)) == MAP_FAILED) {
+      ec = make_errno_error_code(L"mmap: ");
+      return nullptr;
+    }
+    ::madvise(view, viewSize, MADV_SEQUENTIAL);
+    return static_cast<const uint8_t *>(view);
+  }
+
+private:
+  int fd{-1};
+  void *view{MAP_FAILED};
+  size_t viewSize{0};
+};
+#endif
+
+// HashStreamed double buffering: the caller reads the next block while the pool hashes the last one
+bool HashStreamed(File &file, MultiHasher &mh, bela::error_code &ec) {
+  for (uint64_t offset = 0;;) {
+    size_t capacity = 0;
+    auto p = mh.Acquire(capacity);
+    size_t got = 0;
+    if (!file.ReadAt(p, capacity, offset, got, ec)) {
+      return false;
+    }
+    mh.Commit(got);
+    if (got < capacity) {
+      return true;
+    }
+    offset += got;
+  }
+}
+} // namespace
+
+bool HashFile(std::wstring_view path, bela::Span<const Algorithm> algorithms, std::vector<FileDigest> &digests,
+              bela::error_code &ec, const HashFileOptions &options) {
+  std::vector<Algorithm> unique;
+  for (auto a : algorithms) {
+    if (std::find(unique.begin(), unique.end(), a) == unique.end()) {
+      unique.emplace_back(a);
+    }
+  }
+  if (unique.empty()) {
+    ec = bela::make_error_code(L"no hash algorithm specified");
+    return false;
+  }
+  File file;
+  uint64_t size = 0;
+  if (!file.Open(path, ec) || !file.Size(size, ec)) {
+    return false;
+  }
+  auto mapped = options.mode == ReadMode::Mapped || (options.mode == ReadMode::Auto && size <= options.map_threshold);
+  const auto bufsize =
+      mapped ? MultiHasher::block_alignment
+             : (std::min)((std::max)((options.buffer_size + buffer_alignment - 1) / buffer_alignment, size_t{1}) *
+                              buffer_alignment,
+                          maximum_buffer_size);
+  MultiHasher mh;
+  mh.Initialize(unique, bufsize, options.pool);
+  // empty files can't be mapped and have nothing to read
+  if (size != 0) {
+    if (mapped) {
+      auto data = file.Map(ec);
+      if (data == nullptr) {
+        return false;
+      }
+      mh.UpdateInPlace(data, static_cast<size_t>(size));
+    } else if (!HashStreamed(file, mh, ec)) {
+      return false;
+    }
+  }
+  mh.Finalize();
+  digests.clear();
+  digests.reserve(unique.size());
+  for (auto a : unique) {
+    auto &d = digests.emplace_back();
+    d.algorithm = a;
+    d.length = mh.Digest(a, d.digest, sizeof(d.digest));
+  }
+  return true;
+}
+
+} // namespace bela::hash
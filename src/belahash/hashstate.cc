@@ -0,0 +1,98 @@
+///
+#include "hashstate.hpp"
+
+namespace bela::hash {
+namespace internal {
+StateStatus ReadStateHeader(StateReader &r, Algorithm &a) {
+  uint8_t magic[sizeof(state_magic)];
+  r.Bytes(magic, sizeof(magic));
+  if (memcmp(magic, state_magic, sizeof(magic)) != 0) {
+    return StateStatus::NotState;
+  }
+  if (r.U8() != state_version) {
+    return StateStatus::UnsupportedVersion;
+  }
+  auto v = r.U8();
+  if (v > static_cast<uint8_t>(Algorithm::SM3)) {
+    return StateStatus::WrongAlgorithm;
+  }
+  a = static_cast<Algorithm>(v);
+  return StateStatus::Ok;
+}
+} // namespace internal
+
+namespace blake3 {
+std::string Hasher::SaveState() const {
+  std::string state;
+  internal::StateWriter w(state, Algorithm::BLAKE3);
+  for (auto v : h.key) {
+    w.U32(v);
+  }
+  for (auto v : h.chunk.cv) {
+    w.U32(v);
+  }
+  w.U64(h.chunk.chunk_counter);
+  w.U8(h.chunk.buf_len);
+  w.U8(h.chunk.blocks_compressed);
+  w.U8(h.chunk.flags);
+  w.Bytes(h.chunk.buf, h.chunk.buf_len);
+  w.U8(h.cv_stack_len);
+  w.Bytes(h.cv_stack, static_cast<size_t>(h.cv_stack_len) * BLAKE3_OUT_LEN);
+  return state;
+}
+
+StateStatus Hasher::RestoreState(std::string_view state) {
+  internal::StateReader r(state);
+  Algorithm a;
+  if (auto status = internal::ReadStateHeader(r, a); status != StateStatus::Ok) {
+    return status;
+  }
+  if (a != Algorithm::BLAKE3) {
+    return StateStatus::WrongAlgorithm;
+  }
+  // unused buf bytes must stay zero, the last block is compressed with them
+  blake3_hasher s{};
+  for (auto &v : s.key) {
+    v = r.U32();
+  }
+  for (auto &v : s.chunk.cv) {
+    v = r.U32();
+  }
+  s.chunk.chunk_counter = r.U64();
+  s.chunk.buf_len = r.U8();
+  s.chunk.blocks_compressed = r.U8();
+  s.chunk.flags = r.U8();
+  if (s.chunk.buf_len > BLAKE3_BLOCK_LEN || s.chunk.blocks_compressed > BLAKE3_CHUNK_LEN / BLAKE3_BLOCK_LEN) {
+    r.Invalid();
+  } else {
+    r.Bytes(s.chunk.buf, s.chunk.buf_len);
+  }
+  s.cv_stack_len = r.U8();
+  if (s.cv_stack_len > BLAKE3_MAX_DEPTH + 1) {
+    r.Invalid();
+  } else {
+    r.Bytes(s.cv_stack, static_cast<size_t>(s.cv_stack_len) * BLAKE3_OUT_LEN);
+  }
+  if (auto status = r.Finish(); status != StateStatus::Ok) {
+    return status;
+  }
+  h = s;
+  return StateStatus::Ok;
+}
+} // namespace blake3
+
+StateStatus AnyHasher::RestoreState(std::string_view state) {
+  internal::StateReader r(state);
+  Algorithm a;
+  if (auto status = internal::ReadStateHeader(r, a); status != StateStatus::Ok) {
+    return status;
+  }
+  AnyHasher x(a);
+  if (auto status = std::visit([&](auto &v) { return v.RestoreState(state); }, x.h); status != StateStatus::Ok) {
+    return status;
+  }
+  *this = std::move(x);
+  return StateStatus::Ok;
+}
+
+} // namespace bela::hash
@@ -0,0 +1,85 @@
+///
+#ifndef BELA_HASH_STATE_HPP
+#define BELA_HASH_STATE_HPP
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <bela/hash.hpp>
+
+namespace bela::hash::internal {
+// hasher state blob: 'B' 'H' 'S' version algorithm, then the algorithm fields little-endian.
+// Buffered bytes are stored without padding so the blob stays a few hundred bytes at most
+constexpr uint8_t state_magic[3] = {'B', 'H', 'S'};
+constexpr uint8_t state_version = 1;
+
+class StateWriter {
+public:
+  StateWriter(std::string &out_, Algorithm a) : out(out_) {
+    out.assign(reinterpret_cast<const char *>(state_magic), sizeof(state_magic));
+    U8(state_version);
+    U8(static_cast<uint8_t>(a));
+  }
+  void U8(uint8_t v) { out.push_back(static_cast<char>(v)); }
+  void U32(uint32_t v) {
+    for (int i = 0; i < 4; i++) {
+      U8(static_cast<uint8_t>(v >> (i * 8)));
+    }
+  }
+  void U64(uint64_t v) {
+    for (int i = 0; i < 8; i++) {
+      U8(static_cast<uint8_t>(v >> (i * 8)));
+    }
+  }
+  void Bytes(const void *p, size_t len) { out.append(reinterpret_cast<const char *>(p), len); }
+
+private:
+  std::string &out;
+};
+
+// StateReader reads past the end yield zero and mark the reader bad, callers check Finish once
+class StateReader {
+public:
+  explicit StateReader(std::string_view in_) : in(in_) {}
+  uint8_t U8() {
+    uint8_t v = 0;
+    Bytes(&v, 1);
+    return v;
+  }
+  uint32_t U32() {
+    uint32_t v = 0;
+    for (int i = 0; i < 4; i++) {
+      v |= static_cast<uint32_t>(U8()) << (i * 8);
+    }
+    return v;
+  }
+  uint64_t U64() {
+    uint64_t v = 0;
+    for (int i = 0; i < 8; i++) {
+      v |= static_cast<uint64_t>(U8()) << (i * 8);
+    }
+    return v;
+  }
+  void Bytes(void *p, size_t len) {
+    if (len > in.size()) {
+      bad = true;
+      memset(p, 0, len);
+      in = std::string_view();
+      return;
+    }
+    memcpy(p, in.data(), len);
+    in.remove_prefix(len);
+  }
+  void Invalid() { bad = true; }
+  // Finish Ok when every field was present, valid and nothing trails
+  StateStatus Finish() const { return bad || !in.empty() ? StateStatus::Corrupt : StateStatus::Ok; }
+
+private:
+  std::string_view in;
+  bool bad{false};
+};
+
+// ReadStateHeader check magic and version, return the algorithm the state belongs to
+StateStatus ReadStateHeader(StateReader &r, Algorithm &a);
+} // namespace bela::hash::internal
+
+#endif
@@ -0,0 +1,146 @@
+///
+#include <algorithm>
+#include <cstring>
+#include <new>
+#include <bela/multihash.hpp>
+
+namespace bela::hash {
+void MultiHasher::AlignedDelete::operator()(uint8_t *p) const {
+  ::operator delete(p, std::align_val_t{block_alignment});
+}
+
+MultiHasher::~MultiHasher() {
+  if (group) {
+    group->Wait();
+  }
+}
+
+bool MultiHasher::Initialize(bela::Span<const Algorithm> algorithms, size_t blockSize_, bela::ThreadPool *pool) {
+  if (group) {
+    group->Wait();
+  }
+  lanes.clear();
+  sizes[0] = sizes[1] = 0;
+  current = 0;
+  acquired = false;
+  finalized = false;
+  for (auto a : algorithms) {
+    if (std::any_of(lanes.begin(), lanes.end(), [&](const auto &l) { return l->hasher.algorithm() == a; })) {
+      continue;
+    }
+    auto lane = std::make_unique<Lane>();
+    lane->hasher.Initialize(a);
+    lanes.emplace_back(std::move(lane));
+  }
+  if (lanes.empty()) {
+    return false;
+  }
+  blockSize = (std::max)(blockSize_, static_cast<size_t>(4096));
+  for (auto &b : buffers) {
+    b.reset(static_cast<uint8_t *>(::operator new(blockSize, std::align_val_t{block_alignment})));
+  }
+  group = std::make_unique<bela::TaskGroup>(pool != nullptr ? *pool : bela::ThreadPool::Default());
+  return true;
+}
+
+uint8_t *MultiHasher::Acquire(size_t &capacity) {
+  // the other buffer may still be hashed, this one was released by the Wait in the last Publish
+  if (!acquired) {
+    sizes[current] = 0;
+    acquired = true;
+  }
+  capacity = blockSize - sizes[current];
+  return buffers[current].get() + sizes[current];
+}
+
+void MultiHasher::Publish() {
+  acquired = false;
+  const auto size = sizes[current];
+  if (size == 0) {
+    return;
+  }
+  const auto data = buffers[current].get();
+  // every hasher must finish the previous block before it sees this one
+  group->Wait();
+  for (auto &lane : lanes) {
+    group->Run([l = lane.get(), data, size] { l->hasher.Update(data, size); });
+  }
+  current ^= 1;
+}
+
+void MultiHasher::Commit(size_t n) {
+  sizes[current] += (std::min)(n, blockSize - sizes[current]);
+  if (sizes[current] == blockSize) {
+    Publish();
+  }
+}
+
+void MultiHasher::Update(const void *input, size_t input_len) {
+  auto p = reinterpret_cast<const uint8_t *>(input);
+  while (input_len > 0) {
+    size_t capacity = 0;
+    auto buf = Acquire(capacity);
+    auto n = (std::min)(capacity, input_len);
+    memcpy(buf, p, n);
+    Commit(n);
+    p += n;
+    input_len -= n;
+  }
+}
+
+void MultiHasher::UpdateInPlace(const void *input, size_t input_len) {
+  if (input_len == 0 || lanes.empty()) {
+    return;
+  }
+  if (acquired) {
+    Publish();
+  }
+  group->Wait();
+  auto p = reinterpret_cast<const uint8_t *>(input);
+  // the caller waits anyway, it takes the first hasher
+  for (size_t i = 1; i < lanes.size(); i++) {
+    group->Run([l = lanes[i].get(), p, input_len] { l->hasher.Update(p, input_len); });
+  }
+  lanes[0]->hasher.Update(p, input_len);
+  group->Wait();
+}
+
+void MultiHasher::Finalize() {
+  if (finalized || lanes.empty()) {
+    return;
+  }
+  if (acquired) {
+    Publish();
+  }
+  group->Wait();
+  for (auto &lane : lanes) {
+    lane->hasher.Finalize(lane->digest, lane->hasher.DigestLength());
+  }
+  finalized = true;
+}
+
+size_t MultiHasher::Digest(Algorithm a, uint8_t *out, size_t out_len) const {
+  for (const auto &lane : lanes) {
+    if (lane->hasher.algorithm() != a) {
+      continue;
+    }
+    auto len = lane->hasher.DigestLength();
+    if (!finalized || out_len < len) {
+      return 0;
+    }
+    memcpy(out, lane->digest, len);
+    return len;
+  }
+  return 0;
+}
+
+std::wstring MultiHasher::Digest(Algorithm a) const {
+  uint8_t buf[max_digest_length];
+  std::wstring s;
+  if (auto len = Digest(a, buf, sizeof(buf)); len != 0) {
+    HashEncode(buf, len, s);
+  }
+  return s;
+}
+
+} // namespace bela::hash
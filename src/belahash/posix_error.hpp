@@ -0,0 +1,18 @@
+///
+#ifndef BELA_HASH_POSIX_ERROR_HPP
+#define BELA_HASH_POSIX_ERROR_HPP
+#include <cerrno>
+#include <string_view>
+#include <system_error>
+#include <bela/codecvt.hpp>
+#include <bela/error_code.hpp>
+
+namespace bela::hash::internal {
+// make_errno_error_code the POSIX file paths report errno like make_system_error_code reports GetLastError
+inline bela::error_code make_errno_error_code(std::wstring_view prefix = L"") {
+  auto e = errno;
+  return bela::make_error_code(e, prefix, bela::ToWide(std::generic_category().message(e)));
+}
+} // namespace bela::hash::internal
+
+#endif
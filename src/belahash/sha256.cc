@@ -16,23 +16,13 @@
  * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
  * or FITNESS FOR A PARTICULAR PURPOSE.  Use this program  at  your own risk!
  */
+#include <atomic>
 #include <bela/hash.hpp>
 #include "hashinternal.hpp"
+#include "sha256_impl.hpp"
+#include "hashstate.hpp"
 
 namespace bela::hash::sha256 {
-//
-constexpr const uint32_t k256[64] = {
-    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5, 0xd807aa98,
-    0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174, 0xe49b69c1, 0xefbe4786,
-    0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da, 0x983e5152, 0xa831c66d, 0xb00327c8,
-    0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967, 0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13,
-    0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85, 0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819,
-    0xd6990624, 0xf40e3585, 0x106aa070, 0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a,
-    0x5b9cca4f, 0x682e6ff3, 0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7,
-    0xc67178f2
-    //
-};
-
 /* The SHA256/224 functions defined by FIPS 180-3, 4.1.2 */
 /* Optimized version of Ch(x,y,z)=((x & y) | (~x & z)) */
 #define Ch(x, y, z) ((z) ^ ((x) & ((y) ^ (z))))
@@ -58,22 +48,15 @@ constexpr const uint32_t k256[64] = {
 
 void Hasher::Initialize(HashBits hb_) {
   hb = hb_;
-  static constexpr const uint32_t SHA256_H0[8] = {0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
-                                                  0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19};
-  /* Initial values from FIPS 180-3. These words were obtained by taking
-   * bits from 33th to 64th of the fractional parts of the square
-   * roots of ninth through sixteenth prime numbers. */
-  static constexpr const uint32_t SHA224_H0[8] = {0xc1059ed8, 0x367cd507, 0x3070dd17, 0xf70e5939,
-                                                  0xffc00b31, 0x68581511, 0x64f98fa7, 0xbefa4fa4};
   if (hb == HashBits::SHA256) {
     length = 0;
     digest_length = sha256_hash_size;
-    memcpy(this->hash, SHA256_H0, sizeof(this->hash));
+    memcpy(this->hash, sha256_h0, sizeof(this->hash));
     return;
   }
   length = 0;
   digest_length = sha224_hash_size;
-  memcpy(this->hash, SHA224_H0, sizeof(this->hash));
+  memcpy(this->hash, sha224_h0, sizeof(this->hash));
 }
 
 /**
@@ -82,7 +65,7 @@ void Hasher::Initialize(HashBits hb_) {
  * @param hash algorithm state
  * @param block the message block to process
  */
-static void sha256_process_block(unsigned hash[8], unsigned block[16]) {
+static void sha256_process_block(unsigned hash[8], const unsigned block[16]) {
   unsigned A, B, C, D, E, F, G, H;
   unsigned W[16];
   const unsigned *k;
@@ -132,6 +115,82 @@ static void sha256_process_block(unsigned hash[8], unsigned block[16]) {
   hash[4] += E, hash[5] += F, hash[6] += G, hash[7] += H;
 }
 
+void sha256_compress_portable(uint32_t hash[8], const uint8_t *blocks, size_t n) {
+  uint32_t aligned[16];
+  for (; n > 0; n--, blocks += sha256_block_size) {
+    if (IS_ALIGNED_32(blocks)) {
+      /* the most common case is processing of an already aligned message
+      without copying it */
+      sha256_process_block(hash, (const unsigned *)blocks);
+      continue;
+    }
+    memcpy(aligned, blocks, sha256_block_size);
+    sha256_process_block(hash, aligned);
+  }
+}
+
+using compress_t = void (*)(uint32_t hash[8], const uint8_t *blocks, size_t n);
+
+static compress_t resolve_compress(Backend b) {
+  [[maybe_unused]] const auto &features = bela::hash::internal::GetCpuFeatures();
+  switch (b) {
+  case Backend::Portable:
+    return sha256_compress_portable;
+#if defined(BELA_HASH_X86)
+  case Backend::SHANI:
+    return (features.sha && features.sse41) ? sha256_compress_shani : nullptr;
+  case Backend::AVX2:
+    return (features.avx2 && features.bmi2) ? sha256_compress_avx2 : nullptr;
+  case Backend::Auto:
+    if (features.sha && features.sse41) {
+      return sha256_compress_shani;
+    }
+    if (features.avx2 && features.bmi2) {
+      return sha256_compress_avx2;
+    }
+    return sha256_compress_portable;
+#else
+  case Backend::Auto:
+    return sha256_compress_portable;
+#endif
+  default:
+    break;
+  }
+  return nullptr;
+}
+
+static Backend resolve_backend(compress_t fn) {
+#if defined(BELA_HASH_X86)
+  if (fn == sha256_compress_shani) {
+    return Backend::SHANI;
+  }
+  if (fn == sha256_compress_avx2) {
+    return Backend::AVX2;
+  }
+#endif
+  return Backend::Portable;
+}
+
+static std::atomic<compress_t> &compress_fn() {
+  static std::atomic<compress_t> fn{resolve_compress(Backend::Auto)};
+  return fn;
+}
+
+bool SetBackend(Backend b) {
+  auto fn = resolve_compress(b);
+  if (fn == nullptr) {
+    return false;
+  }
+  compress_fn().store(fn, std::memory_order_relaxed);
+  return true;
+}
+
+Backend ActiveBackend() { return resolve_backend(compress_fn().load(std::memory_order_relaxed)); }
+
+void sha256_compress(uint32_t hash[8], const uint8_t *blocks, size_t n) {
+  compress_fn().load(std::memory_order_relaxed)(hash, blocks, n);
+}
+
 void Hasher::Update(const void *input, size_t input_len) {
   auto msg = reinterpret_cast<const uint8_t *>(input);
   size_t index = (size_t)length & 63;
@@ -146,24 +205,14 @@ void Hasher::Update(const void *input, size_t input_len) {
     }
 
     /* process partial block */
-    sha256_process_block(hash, (unsigned *)message);
+    sha256_compress(hash, reinterpret_cast<const uint8_t *>(message), 1);
     msg += left;
     input_len -= left;
   }
-  while (input_len >= sha256_block_size) {
-    unsigned *aligned_message_block;
-    if (IS_ALIGNED_32(msg)) {
-      /* the most common case is processing of an already aligned message
-      without copying it */
-      aligned_message_block = (unsigned *)msg;
-    } else {
-      memcpy(message, msg, sha256_block_size);
-      aligned_message_block = (unsigned *)message;
-    }
-
-    sha256_process_block(hash, aligned_message_block);
-    msg += sha256_block_size;
-    input_len -= sha256_block_size;
+  if (auto blocks = input_len / sha256_block_size; blocks != 0) {
+    sha256_compress(hash, msg, blocks);
+    msg += blocks * sha256_block_size;
+    input_len -= blocks * sha256_block_size;
   }
   if (input_len != 0) {
     memcpy(message, msg, input_len); /* save leftovers */
@@ -185,7 +234,7 @@ void Hasher::Finalize(uint8_t *out, size_t out_len) {
     while (index < 16) {
       message[index++] = 0;
     }
-    sha256_process_block(hash, message);
+    sha256_compress(hash, reinterpret_cast<const uint8_t *>(message), 1);
     index = 0;
   }
   while (index < 14) {
@@ -193,10 +242,44 @@ void Hasher::Finalize(uint8_t *out, size_t out_len) {
   }
   message[14] = bela::swapbe((unsigned)(length >> 29));
   message[15] = bela::swapbe((unsigned)(length << 3));
-  sha256_process_block(hash, message);
+  sha256_compress(hash, reinterpret_cast<const uint8_t *>(message), 1);
 
   if (out != nullptr && out_len >= digest_length) {
     be32_copy(out, 0, hash, digest_length);
   }
 }
+
+std::string Hasher::SaveState() const {
+  std::string state;
+  internal::StateWriter w(state, hb == HashBits::SHA224 ? Algorithm::SHA224 : Algorithm::SHA256);
+  w.U64(length);
+  for (auto v : hash) {
+    w.U32(v);
+  }
+  w.Bytes(message, static_cast<size_t>(length & 63));
+  return state;
+}
+
+StateStatus Hasher::RestoreState(std::string_view state) {
+  internal::StateReader r(state);
+  Algorithm a;
+  if (auto status = internal::ReadStateHeader(r, a); status != StateStatus::Ok) {
+    return status;
+  }
+  if (a != Algorithm::SHA224 && a != Algorithm::SHA256) {
+    return StateStatus::WrongAlgorithm;
+  }
+  Hasher h;
+  h.Initialize(a == Algorithm::SHA224 ? HashBits::SHA224 : HashBits::SHA256);
+  h.length = r.U64();
+  for (auto &v : h.hash) {
+    v = r.U32();
+  }
+  r.Bytes(h.message, static_cast<size_t>(h.length & 63));
+  if (auto status = r.Finish(); status != StateStatus::Ok) {
+    return status;
+  }
+  *this = h;
+  return StateStatus::Ok;
+}
 } // namespace bela::hash::sha256
@@ -0,0 +1,125 @@
+/// SHA-256 AVX2 backend
+// The message schedule of two consecutive blocks is expanded together, block 0 in the low
+// 128-bit lane and block 1 in the high lane; rounds stay scalar (rorx with BMI2).
+// GCC/Clang: compile with -mavx2 -mbmi2
+#include "sha256_impl.hpp"
+#include "sha256_x86.hpp"
+
+namespace bela::hash::sha256 {
+namespace {
+inline __m256i rotr32(__m256i x, int n) { return _mm256_or_si256(_mm256_srli_epi32(x, n), _mm256_slli_epi32(x, 32 - n)); }
+inline __m256i sigma0(__m256i x) {
+  return _mm256_xor_si256(_mm256_xor_si256(rotr32(x, 7), rotr32(x, 18)), _mm256_srli_epi32(x, 3));
+}
+inline __m256i sigma1(__m256i x) {
+  return _mm256_xor_si256(_mm256_xor_si256(rotr32(x, 17), rotr32(x, 19)), _mm256_srli_epi32(x, 10));
+}
+
+inline uint32_t rotr(uint32_t x, int n) { return (x >> n) | (x << (32 - n)); }
+
+// W[t..t+3] from W[t-16..t-1] held in X0..X3
+inline __m256i schedule(__m256i X0, __m256i X1, __m256i X2, __m256i X3) {
+  const __m256i lo = _mm256_set_epi32(0, 0, -1, -1, 0, 0, -1, -1);
+  auto w = _mm256_add_epi32(X0, sigma0(_mm256_alignr_epi8(X1, X0, 4)));
+  w = _mm256_add_epi32(w, _mm256_alignr_epi8(X3, X2, 4));
+  // W[t], W[t+1] need sigma1(W[t-2]), sigma1(W[t-1])
+  w = _mm256_add_epi32(w, _mm256_and_si256(sigma1(_mm256_shuffle_epi32(X3, 0xEE)), lo));
+  // W[t+2], W[t+3] need sigma1(W[t]), sigma1(W[t+1]) just computed
+  w = _mm256_add_epi32(w, _mm256_andnot_si256(lo, sigma1(_mm256_shuffle_epi32(w, 0x44))));
+  return w;
+}
+
+inline void rounds(uint32_t hash[8], const uint32_t wk[64]) {
+  uint32_t a = hash[0], b = hash[1], c = hash[2], d = hash[3];
+  uint32_t e = hash[4], f = hash[5], g = hash[6], h = hash[7];
+  for (int i = 0; i < 64; i++) {
+    auto t1 = h + (rotr(e, 6) ^ rotr(e, 11) ^ rotr(e, 25)) + (g ^ (e & (f ^ g))) + wk[i];
+    auto t2 = (rotr(a, 2) ^ rotr(a, 13) ^ rotr(a, 22)) + ((a & b) ^ (c & (a ^ b)));
+    h = g;
+    g = f;
+    f = e;
+    e = d + t1;
+    d = c;
+    c = b;
+    b = a;
+    a = t1 + t2;
+  }
+  hash[0] += a, hash[1] += b, hash[2] += c, hash[3] += d;
+  hash[4] += e, hash[5] += f, hash[6] += g, hash[7] += h;
+}
+} // namespace
+
+void sha256_compress_avx2(uint32_t hash[8], const uint8_t *blocks, size_t n) {
+  const __m256i MASK = _mm256_set_epi64x(0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL, 0x0c0d0e0f08090a0bULL,
+                                         0x0405060700010203ULL);
+  alignas(32) uint32_t wk[2][64];
+  while (n > 0) {
+    // single trailing block: expand it in both lanes and drop the high one
+    const auto second = n > 1 ? blocks + 64 : blocks;
+    __m256i X[4];
+    for (int i = 0; i < 4; i++) {
+      auto x = _mm256_castsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i *>(blocks + i * 16)));
+      x = _mm256_inserti128_si256(x, _mm_loadu_si128(reinterpret_cast<const __m128i *>(second + i * 16)), 1);
+      X[i] = _mm256_shuffle_epi8(x, MASK);
+    }
+    for (int t = 0; t < 64; t += 4) {
+      if (t >= 16) {
+        auto w = schedule(X[0], X[1], X[2], X[3]);
+        X[0] = X[1];
+        X[1] = X[2];
+        X[2] = X[3];
+        X[3] = w;
+      }
+      const auto k = _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i *>(&k256[t])));
+      const auto v = _mm256_add_epi32(X[t < 16 ? t / 4 : 3], k);
+      _mm_store_si128(reinterpret_cast<__m128i *>(&wk[0][t]), _mm256_castsi256_si128(v));
+      _mm_store_si128(reinterpret_cast<__m128i *>(&wk[1][t]), _mm256_extracti128_si256(v, 1));
+    }
+    rounds(hash, wk[0]);
+    if (n == 1) {
+      break;
+    }
+    rounds(hash, wk[1]);
+    blocks += 128;
+    n -= 2;
+  }
+}
+
+// 8 independent messages, one per 32-bit lane
+void sha256_compress_x8_avx2(uint32_t state[64], const uint8_t *const blocks[8]) {
+  __m256i W[16];
+  load_transpose8x8(blocks, 0, &W[0]);
+  load_transpose8x8(blocks, 32, &W[8]);
+  __m256i s[8];
+  for (int i = 0; i < 8; i++) {
+    s[i] = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(&state[i * 8]));
+  }
+  auto a = s[0], b = s[1], c = s[2], d = s[3], e = s[4], f = s[5], g = s[6], h = s[7];
+  for (int t = 0; t < 64; t++) {
+    auto &w = W[t & 15];
+    if (t >= 16) {
+      const auto w15 = W[(t - 15) & 15];
+      const auto w2 = W[(t - 2) & 15];
+      w = _mm256_add_epi32(_mm256_add_epi32(w, sigma0(w15)), _mm256_add_epi32(W[(t - 7) & 15], sigma1(w2)));
+    }
+    const auto S1 = _mm256_xor_si256(_mm256_xor_si256(rotr32(e, 6), rotr32(e, 11)), rotr32(e, 25));
+    const auto ch = _mm256_xor_si256(g, _mm256_and_si256(e, _mm256_xor_si256(f, g)));
+    auto t1 = _mm256_add_epi32(_mm256_add_epi32(h, S1), _mm256_add_epi32(ch, w));
+    t1 = _mm256_add_epi32(t1, _mm256_set1_epi32(static_cast<int>(k256[t])));
+    const auto S0 = _mm256_xor_si256(_mm256_xor_si256(rotr32(a, 2), rotr32(a, 13)), rotr32(a, 22));
+    const auto maj = _mm256_or_si256(_mm256_and_si256(a, b), _mm256_and_si256(c, _mm256_or_si256(a, b)));
+    h = g;
+    g = f;
+    f = e;
+    e = _mm256_add_epi32(d, t1);
+    d = c;
+    c = b;
+    b = a;
+    a = _mm256_add_epi32(t1, _mm256_add_epi32(S0, maj));
+  }
+  const __m256i v[8] = {a, b, c, d, e, f, g, h};
+  for (int i = 0; i < 8; i++) {
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(&state[i * 8]), _mm256_add_epi32(s[i], v[i]));
+  }
+}
+} // namespace bela::hash::sha256
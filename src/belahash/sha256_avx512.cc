@@ -0,0 +1,66 @@
+/// SHA-256 AVX-512 multi-buffer backend
+// 16 independent messages, one per 32-bit lane.
+// GCC/Clang: compile with -mavx512f -mavx512vl
+#if defined(__GNUC__) && !defined(__clang__)
+// GCC's avx512fintrin.h fills the pass-through operand of ror/srli/inserti64x4 with _mm512_undefined_epi32(), a
+// self-initialized variable that -Wuninitialized reports at every inlined call
+#pragma GCC diagnostic ignored "-Wuninitialized"
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+#include "sha256_impl.hpp"
+#include "sha256_x86.hpp"
+
+namespace bela::hash::sha256 {
+namespace {
+inline __m512i xor3(__m512i a, __m512i b, __m512i c) { return _mm512_ternarylogic_epi32(a, b, c, 0x96); }
+inline __m512i sigma0(__m512i x) { return xor3(_mm512_ror_epi32(x, 7), _mm512_ror_epi32(x, 18), _mm512_srli_epi32(x, 3)); }
+inline __m512i sigma1(__m512i x) {
+  return xor3(_mm512_ror_epi32(x, 17), _mm512_ror_epi32(x, 19), _mm512_srli_epi32(x, 10));
+}
+} // namespace
+
+void sha256_compress_x16_avx512(uint32_t state[128], const uint8_t *const blocks[16]) {
+  __m512i W[16];
+  {
+    __m256i lo[16];
+    __m256i hi[16];
+    load_transpose8x8(blocks, 0, &lo[0]);
+    load_transpose8x8(blocks, 32, &lo[8]);
+    load_transpose8x8(blocks + 8, 0, &hi[0]);
+    load_transpose8x8(blocks + 8, 32, &hi[8]);
+    for (int t = 0; t < 16; t++) {
+      W[t] = _mm512_inserti64x4(_mm512_castsi256_si512(lo[t]), hi[t], 1);
+    }
+  }
+  __m512i s[8];
+  for (int i = 0; i < 8; i++) {
+    s[i] = _mm512_loadu_si512(&state[i * 16]);
+  }
+  auto a = s[0], b = s[1], c = s[2], d = s[3], e = s[4], f = s[5], g = s[6], h = s[7];
+  for (int t = 0; t < 64; t++) {
+    auto &w = W[t & 15];
+    if (t >= 16) {
+      w = _mm512_add_epi32(_mm512_add_epi32(w, sigma0(W[(t - 15) & 15])),
+                           _mm512_add_epi32(W[(t - 7) & 15], sigma1(W[(t - 2) & 15])));
+    }
+    const auto S1 = xor3(_mm512_ror_epi32(e, 6), _mm512_ror_epi32(e, 11), _mm512_ror_epi32(e, 25));
+    const auto ch = _mm512_ternarylogic_epi32(e, f, g, 0xCA); // e ? f : g
+    auto t1 = _mm512_add_epi32(_mm512_add_epi32(h, S1), _mm512_add_epi32(ch, w));
+    t1 = _mm512_add_epi32(t1, _mm512_set1_epi32(static_cast<int>(k256[t])));
+    const auto S0 = xor3(_mm512_ror_epi32(a, 2), _mm512_ror_epi32(a, 13), _mm512_ror_epi32(a, 22));
+    const auto maj = _mm512_ternarylogic_epi32(a, b, c, 0xE8);
+    h = g;
+    g = f;
+    f = e;
+    e = _mm512_add_epi32(d, t1);
+    d = c;
+    c = b;
+    b = a;
+    a = _mm512_add_epi32(t1, _mm512_add_epi32(S0, maj));
+  }
+  const __m512i v[8] = {a, b, c, d, e, f, g, h};
+  for (int i = 0; i < 8; i++) {
+    _mm512_storeu_si512(&state[i * 16], _mm512_add_epi32(s[i], v[i]));
+  }
+}
+} // namespace bela::hash::sha256
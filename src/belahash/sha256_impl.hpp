@@ -0,0 +1,45 @@
+///
+#ifndef BELA_HASH_SHA256_IMPL_HPP
+#define BELA_HASH_SHA256_IMPL_HPP
+#include <cstddef>
+#include <cstdint>
+#include "cpufeatures.hpp"
+
+namespace bela::hash::sha256 {
+//
+inline constexpr uint32_t k256[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5, 0xd807aa98,
+    0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174, 0xe49b69c1, 0xefbe4786,
+    0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da, 0x983e5152, 0xa831c66d, 0xb00327c8,
+    0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967, 0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13,
+    0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85, 0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819,
+    0xd6990624, 0xf40e3585, 0x106aa070, 0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a,
+    0x5b9cca4f, 0x682e6ff3, 0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7,
+    0xc67178f2
+    //
+};
+
+inline constexpr uint32_t sha256_h0[8] = {0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
+                                         0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19};
+/* Initial values from FIPS 180-3. These words were obtained by taking
+ * bits from 33th to 64th of the fractional parts of the square
+ * roots of ninth through sixteenth prime numbers. */
+inline constexpr uint32_t sha224_h0[8] = {0xc1059ed8, 0x367cd507, 0x3070dd17, 0xf70e5939,
+                                         0xffc00b31, 0x68581511, 0x64f98fa7, 0xbefa4fa4};
+
+// compress through the kernel selected by SetBackend (or Auto)
+void sha256_compress(uint32_t hash[8], const uint8_t *blocks, size_t n);
+// compress n contiguous 64-byte blocks (big-endian message words, any alignment) into hash
+void sha256_compress_portable(uint32_t hash[8], const uint8_t *blocks, size_t n);
+#if defined(BELA_HASH_X86)
+// x86 SHA extensions (SHA-NI), requires SSE4.1
+void sha256_compress_shani(uint32_t hash[8], const uint8_t *blocks, size_t n);
+// AVX2 message schedule for two blocks at once, BMI2 rorx scalar rounds
+void sha256_compress_avx2(uint32_t hash[8], const uint8_t *blocks, size_t n);
+// multi-buffer kernels: one block per lane, state is transposed state[word * lanes + lane]
+void sha256_compress_x8_avx2(uint32_t state[64], const uint8_t *const blocks[8]);
+void sha256_compress_x16_avx512(uint32_t state[128], const uint8_t *const blocks[16]);
+#endif
+} // namespace bela::hash::sha256
+
+#endif
@@ -0,0 +1,145 @@
+/// SHA-256 multi-buffer: hash many small messages together, one message per SIMD lane
+#include <bela/hash.hpp>
+#include "hashinternal.hpp"
+#include "sha256_impl.hpp"
+
+namespace bela::hash::sha256 {
+namespace {
+using kernel_t = void (*)(uint32_t *state, const uint8_t *const *blocks);
+
+// Lane a message in flight: full blocks come straight from the message, the last one or two
+// padded blocks from tail.
+struct lane_t {
+  const uint8_t *msg{nullptr};
+  size_t full{0};   // full blocks in message
+  size_t blocks{0}; // total blocks include padding
+  size_t j{0};      // next block
+  size_t index{0};  // output index
+  uint8_t tail[128];
+  bool active{false};
+  void Assign(bela::Span<const uint8_t> m, size_t i) {
+    msg = m.data();
+    full = m.size() / sha256_block_size;
+    index = i;
+    j = 0;
+    active = true;
+    auto rest = m.size() - full * sha256_block_size;
+    auto tailBlocks = rest + 9 > sha256_block_size ? 2 : 1;
+    blocks = full + tailBlocks;
+    auto tailLen = tailBlocks * sha256_block_size;
+    memset(tail, 0, tailLen);
+    if (rest != 0) {
+      memcpy(tail, msg + full * sha256_block_size, rest);
+    }
+    tail[rest] = 0x80;
+    const uint64_t bits = static_cast<uint64_t>(m.size()) << 3;
+    for (int k = 0; k < 8; k++) {
+      tail[tailLen - 1 - k] = static_cast<uint8_t>(bits >> (8 * k));
+    }
+  }
+  const uint8_t *Block() const { return j < full ? msg + j * sha256_block_size : tail + (j - full) * sha256_block_size; }
+};
+
+inline void write_digest(const uint32_t h[8], Digest &d, HashBits hb) {
+  const auto len = hb == HashBits::SHA224 ? sha224_hash_size : sha256_hash_size;
+  for (int i = 0; i < len / 4; i++) {
+    const auto v = bela::swapbe(h[i]);
+    memcpy(d.data() + i * 4, &v, 4);
+  }
+}
+
+template <size_t Lanes>
+void hash_many_lanes(bela::Span<const bela::Span<const uint8_t>> messages, bela::Span<Digest> digests, size_t count,
+                     HashBits hb, kernel_t kernel) {
+  static const uint8_t zero[sha256_block_size] = {0};
+  const auto h0 = hb == HashBits::SHA224 ? sha224_h0 : sha256_h0;
+  alignas(64) uint32_t state[8 * Lanes];
+  lane_t lanes[Lanes];
+  const uint8_t *ptrs[Lanes];
+  size_t next = 0;
+  auto assign = [&](size_t l) {
+    lanes[l].Assign(messages[next], next);
+    for (int i = 0; i < 8; i++) {
+      state[i * Lanes + l] = h0[i];
+    }
+    next++;
+  };
+  for (size_t l = 0; l < Lanes && next < count; l++) {
+    assign(l);
+  }
+  for (;;) {
+    size_t active = 0;
+    for (size_t l = 0; l < Lanes; l++) {
+      if (lanes[l].active) {
+        ptrs[l] = lanes[l].Block();
+        active++;
+        continue;
+      }
+      ptrs[l] = zero;
+    }
+    // no more messages to schedule and most lanes idle: finish stragglers with the single-buffer kernel
+    if (active == 0 || (next == count && active <= Lanes / 4)) {
+      break;
+    }
+    kernel(state, ptrs);
+    for (size_t l = 0; l < Lanes; l++) {
+      auto &lane = lanes[l];
+      if (!lane.active || ++lane.j != lane.blocks) {
+        continue;
+      }
+      uint32_t h[8];
+      for (int i = 0; i < 8; i++) {
+        h[i] = state[i * Lanes + l];
+      }
+      write_digest(h, digests[lane.index], hb);
+      lane.active = false;
+      if (next < count) {
+        assign(l);
+      }
+    }
+  }
+  for (size_t l = 0; l < Lanes; l++) {
+    auto &lane = lanes[l];
+    if (!lane.active) {
+      continue;
+    }
+    uint32_t h[8];
+    for (int i = 0; i < 8; i++) {
+      h[i] = state[i * Lanes + l];
+    }
+    if (lane.j < lane.full) {
+      sha256_compress(h, lane.msg + lane.j * sha256_block_size, lane.full - lane.j);
+      lane.j = lane.full;
+    }
+    sha256_compress(h, lane.tail + (lane.j - lane.full) * sha256_block_size, lane.blocks - lane.j);
+    write_digest(h, digests[lane.index], hb);
+  }
+}
+} // namespace
+
+void HashMany(bela::Span<const bela::Span<const uint8_t>> messages, bela::Span<Digest> digests, HashBits hb) {
+  const auto count = (std::min)(messages.size(), digests.size());
+#if defined(BELA_HASH_X86)
+  const auto &features = bela::hash::internal::GetCpuFeatures();
+  // honor a pinned Portable backend, otherwise use the widest lanes available
+  const auto backend = ActiveBackend();
+  if (count > 1 && backend != Backend::Portable) {
+    if (features.avx512f && features.avx512vl) {
+      hash_many_lanes<16>(messages, digests, count, hb, sha256_compress_x16_avx512);
+      return;
+    }
+    // a single SHA-NI stream keeps pace with 8 AVX2 lanes
+    if (features.avx2 && backend != Backend::SHANI) {
+      hash_many_lanes<8>(messages, digests, count, hb, sha256_compress_x8_avx2);
+      return;
+    }
+  }
+#endif
+  Hasher h;
+  for (size_t i = 0; i < count; i++) {
+    h.Initialize(hb);
+    h.Update(messages[i].data(), messages[i].size());
+    h.Finalize(digests[i].data(), digests[i].size());
+  }
+}
+} // namespace bela::hash::sha256
@@ -0,0 +1,51 @@
+/// SHA-256 x86 SHA extensions backend
+// GCC/Clang: compile with -msse4.1 -msha
+#include "sha256_impl.hpp"
+#include <immintrin.h>
+
+namespace bela::hash::sha256 {
+void sha256_compress_shani(uint32_t hash[8], const uint8_t *blocks, size_t n) {
+  const __m128i MASK = _mm_set_epi64x(0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL);
+  // state {a,b,c,d} {e,f,g,h} --> {a,b,e,f} {c,d,g,h} layout required by sha256rnds2
+  __m128i TMP = _mm_loadu_si128(reinterpret_cast<const __m128i *>(&hash[0]));
+  __m128i STATE1 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(&hash[4]));
+  TMP = _mm_shuffle_epi32(TMP, 0xB1);          // CDAB
+  STATE1 = _mm_shuffle_epi32(STATE1, 0x1B);    // EFGH
+  __m128i STATE0 = _mm_alignr_epi8(TMP, STATE1, 8); // ABEF
+  STATE1 = _mm_blend_epi16(STATE1, TMP, 0xF0); // CDGH
+
+  for (; n > 0; n--, blocks += 64) {
+    const __m128i ABEF_SAVE = STATE0;
+    const __m128i CDGH_SAVE = STATE1;
+    __m128i W[4];
+    // 16 groups of 4 rounds. W[] is a circular buffer of the message schedule:
+    // sha256msg1/msg2 compute W[i+4] from W[i..i+3] interleaved with the rounds.
+    for (int i = 0; i < 16; i++) {
+      if (i < 4) {
+        W[i] = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(blocks + i * 16)), MASK);
+      }
+      __m128i MSG = _mm_add_epi32(W[i & 3], _mm_loadu_si128(reinterpret_cast<const __m128i *>(&k256[i * 4])));
+      STATE1 = _mm_sha256rnds2_epu32(STATE1, STATE0, MSG);
+      if (i >= 3 && i < 15) {
+        TMP = _mm_alignr_epi8(W[i & 3], W[(i - 1) & 3], 4);
+        W[(i + 1) & 3] = _mm_add_epi32(W[(i + 1) & 3], TMP);
+        W[(i + 1) & 3] = _mm_sha256msg2_epu32(W[(i + 1) & 3], W[i & 3]);
+      }
+      MSG = _mm_shuffle_epi32(MSG, 0x0E);
+      STATE0 = _mm_sha256rnds2_epu32(STATE0, STATE1, MSG);
+      if (i >= 1 && i < 13) {
+        W[(i - 1) & 3] = _mm_sha256msg1_epu32(W[(i - 1) & 3], W[i & 3]);
+      }
+    }
+    STATE0 = _mm_add_epi32(STATE0, ABEF_SAVE);
+    STATE1 = _mm_add_epi32(STATE1, CDGH_SAVE);
+  }
+
+  TMP = _mm_shuffle_epi32(STATE0, 0x1B);       // FEBA
+  STATE1 = _mm_shuffle_epi32(STATE1, 0xB1);    // DCHG
+  STATE0 = _mm_blend_epi16(TMP, STATE1, 0xF0); // DCBA
+  STATE1 = _mm_alignr_epi8(STATE1, TMP, 8);    // ABEF
+  _mm_storeu_si128(reinterpret_cast<__m128i *>(&hash[0]), STATE0);
+  _mm_storeu_si128(reinterpret_cast<__m128i *>(&hash[4]), STATE1);
+}
+} // namespace bela::hash::sha256
@@ -0,0 +1,43 @@
+///
+#ifndef BELA_HASH_SHA256_X86_HPP
+#define BELA_HASH_SHA256_X86_HPP
+// only included by translation units compiled with AVX2 (or newer) enabled
+#include <immintrin.h>
+
+namespace bela::hash::sha256 {
+// Load 32 bytes at offset off of 8 blocks and transpose: out[t] holds big-endian word t of every lane
+inline void load_transpose8x8(const uint8_t *const blocks[8], size_t off, __m256i out[8]) {
+  const __m256i MASK = _mm256_set_epi64x(0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL, 0x0c0d0e0f08090a0bULL,
+                                         0x0405060700010203ULL);
+  __m256i r[8];
+  for (int l = 0; l < 8; l++) {
+    r[l] = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(blocks[l] + off));
+  }
+  const auto t0 = _mm256_unpacklo_epi32(r[0], r[1]);
+  const auto t1 = _mm256_unpackhi_epi32(r[0], r[1]);
+  const auto t2 = _mm256_unpacklo_epi32(r[2], r[3]);
+  const auto t3 = _mm256_unpackhi_epi32(r[2], r[3]);
+  const auto t4 = _mm256_unpacklo_epi32(r[4], r[5]);
+  const auto t5 = _mm256_unpackhi_epi32(r[4], r[5]);
+  const auto t6 = _mm256_unpacklo_epi32(r[6], r[7]);
+  const auto t7 = _mm256_unpackhi_epi32(r[6], r[7]);
+  const auto u0 = _mm256_unpacklo_epi64(t0, t2);
+  const auto u1 = _mm256_unpackhi_epi64(t0, t2);
+  const auto u2 = _mm256_unpacklo_epi64(t1, t3);
+  const auto u3 = _mm256_unpackhi_epi64(t1, t3);
+  const auto u4 = _mm256_unpacklo_epi64(t4, t6);
+  const auto u5 = _mm256_unpackhi_epi64(t4, t6);
+  const auto u6 = _mm256_unpacklo_epi64(t5, t7);
+  const auto u7 = _mm256_unpackhi_epi64(t5, t7);
+  out[0] = _mm256_shuffle_epi8(_mm256_permute2x128_si256(u0, u4, 0x20), MASK);
+  out[1] = _mm256_shuffle_epi8(_mm256_permute2x128_si256(u1, u5, 0x20), MASK);
+  out[2] = _mm256_shuffle_epi8(_mm256_permute2x128_si256(u2, u6, 0x20), MASK);
+  out[3] = _mm256_shuffle_epi8(_mm256_permute2x128_si256(u3, u7, 0x20), MASK);
+  out[4] = _mm256_shuffle_epi8(_mm256_permute2x128_si256(u0, u4, 0x31), MASK);
+  out[5] = _mm256_shuffle_epi8(_mm256_permute2x128_si256(u1, u5, 0x31), MASK);
+  out[6] = _mm256_shuffle_epi8(_mm256_permute2x128_si256(u2, u6, 0x31), MASK);
+  out[7] = _mm256_shuffle_epi8(_mm256_permute2x128_si256(u3, u7, 0x31), MASK);
+}
+} // namespace bela::hash::sha256
+
+#endif
@@ -21,39 +21,10 @@
 #include <cassert>
 #include <bela/hash.hpp>
 #include "hashinternal.hpp"
+#include "sha3_impl.hpp"
+#include "hashstate.hpp"
 
 namespace bela::hash::sha3 {
-/* constants */
-#define NumberOfRounds 24
-
-/* SHA3 (Keccak) constants for 24 rounds */
-static constexpr uint64_t keccak_round_constants[NumberOfRounds] = {
-    I64(0x0000000000000001),
-    I64(0x0000000000008082),
-    I64(0x800000000000808A),
-    I64(0x8000000080008000),
-    I64(0x000000000000808B),
-    I64(0x0000000080000001),
-    I64(0x8000000080008081),
-    I64(0x8000000000008009),
-    I64(0x000000000000008A),
-    I64(0x0000000000000088),
-    I64(0x0000000080008009),
-    I64(0x000000008000000A),
-    I64(0x000000008000808B),
-    I64(0x800000000000008B),
-    I64(0x8000000000008089),
-    I64(0x8000000000008003),
-    I64(0x8000000000008002),
-    I64(0x8000000000000080),
-    I64(0x000000000000800A),
-    I64(0x800000008000000A),
-    I64(0x8000000080008081),
-    I64(0x8000000000008080),
-    I64(0x0000000080000001),
-    I64(0x8000000080008008)
-    //
-};
 void Hasher::Initialize(HashBits hb_) {
   hb = hb_;
   /* NB: The Keccak capacity parameter = bits * 2 */
@@ -64,115 +35,94 @@ void Hasher::Initialize(HashBits hb_) {
   block_size = rate / 8;
 }
 
-#define XORED_A(i) A[(i)] ^ A[(i) + 5] ^ A[(i) + 10] ^ A[(i) + 15] ^ A[(i) + 20]
-#define THETA_STEP(i)                                                                                                  \
-  A[(i)] ^= D[(i)];                                                                                                    \
-  A[(i) + 5] ^= D[(i)];                                                                                                \
-  A[(i) + 10] ^= D[(i)];                                                                                               \
-  A[(i) + 15] ^= D[(i)];                                                                                               \
-  A[(i) + 20] ^= D[(i)]
-
-/* Keccak theta() transformation */
-static void keccak_theta(uint64_t *A) {
-  uint64_t D[5];
-  D[0] = ROTL64(XORED_A(1), 1) ^ XORED_A(4);
-  D[1] = ROTL64(XORED_A(2), 1) ^ XORED_A(0);
-  D[2] = ROTL64(XORED_A(3), 1) ^ XORED_A(1);
-  D[3] = ROTL64(XORED_A(4), 1) ^ XORED_A(2);
-  D[4] = ROTL64(XORED_A(0), 1) ^ XORED_A(3);
-  THETA_STEP(0);
-  THETA_STEP(1);
-  THETA_STEP(2);
-  THETA_STEP(3);
-  THETA_STEP(4);
-}
-
-/* Keccak pi() transformation */
-static void keccak_pi(uint64_t *A) {
-  uint64_t A1;
-  A1 = A[1];
-  A[1] = A[6];
-  A[6] = A[9];
-  A[9] = A[22];
-  A[22] = A[14];
-  A[14] = A[20];
-  A[20] = A[2];
-  A[2] = A[12];
-  A[12] = A[13];
-  A[13] = A[19];
-  A[19] = A[23];
-  A[23] = A[15];
-  A[15] = A[4];
-  A[4] = A[24];
-  A[24] = A[21];
-  A[21] = A[8];
-  A[8] = A[16];
-  A[16] = A[5];
-  A[5] = A[3];
-  A[3] = A[18];
-  A[18] = A[17];
-  A[17] = A[11];
-  A[11] = A[7];
-  A[7] = A[10];
-  A[10] = A1;
-  /* note: A[ 0] is left as is */
-}
-
-#define CHI_STEP(i)                                                                                                    \
-  A0 = A[0 + (i)];                                                                                                     \
-  A1 = A[1 + (i)];                                                                                                     \
-  A[0 + (i)] ^= ~A1 & A[2 + (i)];                                                                                      \
-  A[1 + (i)] ^= ~A[2 + (i)] & A[3 + (i)];                                                                              \
-  A[2 + (i)] ^= ~A[3 + (i)] & A[4 + (i)];                                                                              \
-  A[3 + (i)] ^= ~A[4 + (i)] & A0;                                                                                      \
-  A[4 + (i)] ^= ~A0 & A1
-
-/* Keccak chi() transformation */
-static void keccak_chi(uint64_t *A) {
-  uint64_t A0, A1;
-  CHI_STEP(0);
-  CHI_STEP(5);
-  CHI_STEP(10);
-  CHI_STEP(15);
-  CHI_STEP(20);
-}
-
-static void sha3_permutation(uint64_t *state) {
-  for (int round = 0; round < NumberOfRounds; round++) {
-    keccak_theta(state);
-
-    /* apply Keccak rho() transformation */
-    state[1] = ROTL64(state[1], 1);
-    state[2] = ROTL64(state[2], 62);
-    state[3] = ROTL64(state[3], 28);
-    state[4] = ROTL64(state[4], 27);
-    state[5] = ROTL64(state[5], 36);
-    state[6] = ROTL64(state[6], 44);
-    state[7] = ROTL64(state[7], 6);
-    state[8] = ROTL64(state[8], 55);
-    state[9] = ROTL64(state[9], 20);
-    state[10] = ROTL64(state[10], 3);
-    state[11] = ROTL64(state[11], 10);
-    state[12] = ROTL64(state[12], 43);
-    state[13] = ROTL64(state[13], 25);
-    state[14] = ROTL64(state[14], 39);
-    state[15] = ROTL64(state[15], 41);
-    state[16] = ROTL64(state[16], 45);
-    state[17] = ROTL64(state[17], 15);
-    state[18] = ROTL64(state[18], 21);
-    state[19] = ROTL64(state[19], 8);
-    state[20] = ROTL64(state[20], 18);
-    state[21] = ROTL64(state[21], 2);
-    state[22] = ROTL64(state[22], 61);
-    state[23] = ROTL64(state[23], 56);
-    state[24] = ROTL64(state[24], 14);
+/* Keccak-f[1600] theta-rho-pi-chi-iota round, E = round(A). Unrolled with lane complementing
+ * (XKCP "bebigokimisa"): lanes 1, 2, 8, 12, 17, 20 are kept complemented inside the permutation,
+ * which replaces most of the chi NOT operations with OR. Lane names: A[x + 5 * y],
+ * y in (b, g, k, m, s), x in (a, e, i, o, u). */
+#define KECCAK_ROUND(A, E, rc)                                                                                         \
+  {                                                                                                                    \
+    const uint64_t C0 = A[0] ^ A[5] ^ A[10] ^ A[15] ^ A[20];                                                           \
+    const uint64_t C1 = A[1] ^ A[6] ^ A[11] ^ A[16] ^ A[21];                                                           \
+    const uint64_t C2 = A[2] ^ A[7] ^ A[12] ^ A[17] ^ A[22];                                                           \
+    const uint64_t C3 = A[3] ^ A[8] ^ A[13] ^ A[18] ^ A[23];                                                           \
+    const uint64_t C4 = A[4] ^ A[9] ^ A[14] ^ A[19] ^ A[24];                                                           \
+    const uint64_t D0 = C4 ^ ROTL64(C1, 1);                                                                            \
+    const uint64_t D1 = C0 ^ ROTL64(C2, 1);                                                                            \
+    const uint64_t D2 = C1 ^ ROTL64(C3, 1);                                                                            \
+    const uint64_t D3 = C2 ^ ROTL64(C4, 1);                                                                            \
+    const uint64_t D4 = C3 ^ ROTL64(C0, 1);                                                                            \
+    uint64_t B0, B1, B2, B3, B4;                                                                                       \
+    B0 = A[0] ^ D0;                                                                                                    \
+    B1 = ROTL64(A[6] ^ D1, 44);                                                                                        \
+    B2 = ROTL64(A[12] ^ D2, 43);                                                                                       \
+    B3 = ROTL64(A[18] ^ D3, 21);                                                                                       \
+    B4 = ROTL64(A[24] ^ D4, 14);                                                                                       \
+    E[0] = B0 ^ (B1 | B2) ^ (rc);                                                                                      \
+    E[1] = B1 ^ (~B2 | B3);                                                                                            \
+    E[2] = B2 ^ (B3 & B4);                                                                                             \
+    E[3] = B3 ^ (B4 | B0);                                                                                             \
+    E[4] = B4 ^ (B0 & B1);                                                                                             \
+    B0 = ROTL64(A[3] ^ D3, 28);                                                                                        \
+    B1 = ROTL64(A[9] ^ D4, 20);                                                                                        \
+    B2 = ROTL64(A[10] ^ D0, 3);                                                                                        \
+    B3 = ROTL64(A[16] ^ D1, 45);                                                                                       \
+    B4 = ROTL64(A[22] ^ D2, 61);                                                                                       \
+    E[5] = B0 ^ (B1 | B2);                                                                                             \
+    E[6] = B1 ^ (B2 & B3);                                                                                             \
+    E[7] = B2 ^ (B3 | ~B4);                                                                                            \
+    E[8] = B3 ^ (B4 | B0);                                                                                             \
+    E[9] = B4 ^ (B0 & B1);                                                                                             \
+    B0 = ROTL64(A[1] ^ D1, 1);                                                                                         \
+    B1 = ROTL64(A[7] ^ D2, 6);                                                                                         \
+    B2 = ROTL64(A[13] ^ D3, 25);                                                                                       \
+    B3 = ROTL64(A[19] ^ D4, 8);                                                                                        \
+    B4 = ROTL64(A[20] ^ D0, 18);                                                                                       \
+    E[10] = B0 ^ (B1 | B2);                                                                                            \
+    E[11] = B1 ^ (B2 & B3);                                                                                            \
+    E[12] = B2 ^ (~B3 & B4);                                                                                           \
+    E[13] = ~B3 ^ (B4 | B0);                                                                                           \
+    E[14] = B4 ^ (B0 & B1);                                                                                            \
+    B0 = ROTL64(A[4] ^ D4, 27);                                                                                        \
+    B1 = ROTL64(A[5] ^ D0, 36);                                                                                        \
+    B2 = ROTL64(A[11] ^ D1, 10);                                                                                       \
+    B3 = ROTL64(A[17] ^ D2, 15);                                                                                       \
+    B4 = ROTL64(A[23] ^ D3, 56);                                                                                       \
+    E[15] = B0 ^ (B1 & B2);                                                                                            \
+    E[16] = B1 ^ (B2 | B3);                                                                                            \
+    E[17] = B2 ^ (~B3 | B4);                                                                                           \
+    E[18] = ~B3 ^ (B4 & B0);                                                                                           \
+    E[19] = B4 ^ (B0 | B1);                                                                                            \
+    B0 = ROTL64(A[2] ^ D2, 62);                                                                                        \
+    B1 = ROTL64(A[8] ^ D3, 55);                                                                                        \
+    B2 = ROTL64(A[14] ^ D4, 39);                                                                                       \
+    B3 = ROTL64(A[15] ^ D0, 41);                                                                                       \
+    B4 = ROTL64(A[21] ^ D1, 2);                                                                                        \
+    E[20] = B0 ^ (~B1 & B2);                                                                                           \
+    E[21] = ~B1 ^ (B2 | B3);                                                                                           \
+    E[22] = B2 ^ (B3 & B4);                                                                                            \
+    E[23] = B3 ^ (B4 | B0);                                                                                            \
+    E[24] = B4 ^ (B0 & B1);                                                                                            \
+  }
 
-    keccak_pi(state);
-    keccak_chi(state);
+#define KECCAK_COMPLEMENT(A)                                                                                           \
+  A[1] = ~A[1];                                                                                                        \
+  A[2] = ~A[2];                                                                                                        \
+  A[8] = ~A[8];                                                                                                        \
+  A[12] = ~A[12];                                                                                                      \
+  A[17] = ~A[17];                                                                                                      \
+  A[20] = ~A[20]
 
-    /* apply iota(state, round) */
-    *state ^= keccak_round_constants[round];
+void sha3_permutation(uint64_t state[25]) {
+  uint64_t A[25];
+  uint64_t E[25];
+  memcpy(A, state, sizeof(A));
+  KECCAK_COMPLEMENT(A);
+  for (int round = 0; round < NumberOfRounds; round += 2) {
+    KECCAK_ROUND(A, E, keccak_round_constants[round]);
+    KECCAK_ROUND(E, A, keccak_round_constants[round + 1]);
   }
+  KECCAK_COMPLEMENT(A);
+  memcpy(state, A, sizeof(A));
 }
 
 /**
@@ -287,4 +237,71 @@ void Hasher::Finalize(uint8_t *out, size_t out_len) {
     me64_to_le_str(out, hash, digest_length);
   }
 }
+
+std::string Hasher::SaveState() const {
+  std::string state;
+  Algorithm a = Algorithm::SHA3_256;
+  switch (hb) {
+  case HashBits::SHA3224:
+    a = Algorithm::SHA3_224;
+    break;
+  case HashBits::SHA3384:
+    a = Algorithm::SHA3_384;
+    break;
+  case HashBits::SHA3512:
+    a = Algorithm::SHA3_512;
+    break;
+  default:
+    break;
+  }
+  internal::StateWriter w(state, a);
+  w.U32(rest);
+  for (auto v : hash) {
+    w.U64(v);
+  }
+  // message holds rest raw input bytes, the block size follows from the algorithm
+  w.Bytes(message, rest & ~SHA3_FINALIZED);
+  return state;
+}
+
+StateStatus Hasher::RestoreState(std::string_view state) {
+  internal::StateReader r(state);
+  Algorithm a;
+  if (auto status = internal::ReadStateHeader(r, a); status != StateStatus::Ok) {
+    return status;
+  }
+  Hasher h;
+  switch (a) {
+  case Algorithm::SHA3_224:
+    h.Initialize(HashBits::SHA3224);
+    break;
+  case Algorithm::SHA3_256:
+    h.Initialize(HashBits::SHA3256);
+    break;
+  case Algorithm::SHA3_384:
+    h.Initialize(HashBits::SHA3384);
+    break;
+  case Algorithm::SHA3_512:
+    h.Initialize(HashBits::SHA3512);
+    break;
+  default:
+    return StateStatus::WrongAlgorithm;
+  }
+  h.rest = r.U32();
+  for (auto &v : h.hash) {
+    v = r.U64();
+  }
+  // a finalized state has nothing buffered
+  const auto buffered = h.rest & ~SHA3_FINALIZED;
+  if (buffered >= h.block_size || (buffered != h.rest && buffered != 0)) {
+    r.Invalid();
+  } else {
+    r.Bytes(h.message, buffered);
+  }
+  if (auto status = r.Finish(); status != StateStatus::Ok) {
+    return status;
+  }
+  *this = h;
+  return StateStatus::Ok;
+}
 } // namespace bela::hash::sha3
\ No newline at end of file
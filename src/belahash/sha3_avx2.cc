@@ -0,0 +1,75 @@
+/// SHA-3 AVX2 backend: Keccak-f[1600] on 4 independent states at once
+// GCC/Clang: compile with -mavx2
+#include <immintrin.h>
+#include <bela/endian.hpp>
+#include "sha3_impl.hpp"
+
+namespace bela::hash::sha3 {
+namespace {
+template <int n> inline __m256i rol64(__m256i x) {
+  return _mm256_or_si256(_mm256_slli_epi64(x, n), _mm256_srli_epi64(x, 64 - n));
+}
+inline __m256i xor5(__m256i a, __m256i b, __m256i c, __m256i d, __m256i e) {
+  return _mm256_xor_si256(_mm256_xor_si256(_mm256_xor_si256(a, b), _mm256_xor_si256(c, d)), e);
+}
+// a ^ (~b & c)
+inline __m256i chi(__m256i a, __m256i b, __m256i c) { return _mm256_xor_si256(a, _mm256_andnot_si256(b, c)); }
+
+#define KECCAK_PLANE(E, o, A, i0, D0, r0, i1, D1, r1, i2, D2, r2, i3, D3, r3, i4, D4, r4)                             \
+  {                                                                                                                    \
+    const auto B0 = rol64<r0>(_mm256_xor_si256(A[i0], D0));                                                            \
+    const auto B1 = rol64<r1>(_mm256_xor_si256(A[i1], D1));                                                            \
+    const auto B2 = rol64<r2>(_mm256_xor_si256(A[i2], D2));                                                            \
+    const auto B3 = rol64<r3>(_mm256_xor_si256(A[i3], D3));                                                            \
+    const auto B4 = rol64<r4>(_mm256_xor_si256(A[i4], D4));                                                            \
+    E[o + 0] = chi(B0, B1, B2);                                                                                        \
+    E[o + 1] = chi(B1, B2, B3);                                                                                        \
+    E[o + 2] = chi(B2, B3, B4);                                                                                        \
+    E[o + 3] = chi(B3, B4, B0);                                                                                        \
+    E[o + 4] = chi(B4, B0, B1);                                                                                        \
+  }
+
+inline void keccak_round(const __m256i A[25], __m256i E[25], uint64_t rc) {
+  const auto C0 = xor5(A[0], A[5], A[10], A[15], A[20]);
+  const auto C1 = xor5(A[1], A[6], A[11], A[16], A[21]);
+  const auto C2 = xor5(A[2], A[7], A[12], A[17], A[22]);
+  const auto C3 = xor5(A[3], A[8], A[13], A[18], A[23]);
+  const auto C4 = xor5(A[4], A[9], A[14], A[19], A[24]);
+  const auto D0 = _mm256_xor_si256(C4, rol64<1>(C1));
+  const auto D1 = _mm256_xor_si256(C0, rol64<1>(C2));
+  const auto D2 = _mm256_xor_si256(C1, rol64<1>(C3));
+  const auto D3 = _mm256_xor_si256(C2, rol64<1>(C4));
+  const auto D4 = _mm256_xor_si256(C3, rol64<1>(C0));
+  // rol64<0> is the identity, AVX2 logical shifts by 64 yield zero
+  KECCAK_PLANE(E, 0, A, 0, D0, 0, 6, D1, 44, 12, D2, 43, 18, D3, 21, 24, D4, 14);
+  KECCAK_PLANE(E, 5, A, 3, D3, 28, 9, D4, 20, 10, D0, 3, 16, D1, 45, 22, D2, 61);
+  KECCAK_PLANE(E, 10, A, 1, D1, 1, 7, D2, 6, 13, D3, 25, 19, D4, 8, 20, D0, 18);
+  KECCAK_PLANE(E, 15, A, 4, D4, 27, 5, D0, 36, 11, D1, 10, 17, D2, 15, 23, D3, 56);
+  KECCAK_PLANE(E, 20, A, 2, D2, 62, 8, D3, 55, 14, D4, 39, 15, D0, 41, 21, D1, 2);
+  E[0] = _mm256_xor_si256(E[0], _mm256_set1_epi64x(static_cast<long long>(rc)));
+}
+} // namespace
+
+void sha3_absorb_x4_avx2(uint64_t state[100], const uint8_t *const blocks[4], size_t rate_words) {
+  __m256i A[25];
+  __m256i E[25];
+  for (size_t i = 0; i < 25; i++) {
+    A[i] = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(&state[i * 4]));
+  }
+  for (size_t i = 0; i < rate_words; i++) {
+    const auto w = _mm256_set_epi64x(
+        static_cast<long long>(bela::readle<uint64_t>(blocks[3] + i * 8)),
+        static_cast<long long>(bela::readle<uint64_t>(blocks[2] + i * 8)),
+        static_cast<long long>(bela::readle<uint64_t>(blocks[1] + i * 8)),
+        static_cast<long long>(bela::readle<uint64_t>(blocks[0] + i * 8)));
+    A[i] = _mm256_xor_si256(A[i], w);
+  }
+  for (int round = 0; round < NumberOfRounds; round += 2) {
+    keccak_round(A, E, keccak_round_constants[round]);
+    keccak_round(E, A, keccak_round_constants[round + 1]);
+  }
+  for (size_t i = 0; i < 25; i++) {
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(&state[i * 4]), A[i]);
+  }
+}
+} // namespace bela::hash::sha3
@@ -0,0 +1,32 @@
+///
+#ifndef BELA_HASH_SHA3_IMPL_HPP
+#define BELA_HASH_SHA3_IMPL_HPP
+#include <cstddef>
+#include <cstdint>
+#include "cpufeatures.hpp"
+
+namespace bela::hash::sha3 {
+/* constants */
+constexpr int NumberOfRounds = 24;
+
+/* SHA3 (Keccak) constants for 24 rounds */
+inline constexpr uint64_t keccak_round_constants[NumberOfRounds] = {
+    0x0000000000000001ULL, 0x0000000000008082ULL, 0x800000000000808AULL, 0x8000000080008000ULL,
+    0x000000000000808BULL, 0x0000000080000001ULL, 0x8000000080008081ULL, 0x8000000000008009ULL,
+    0x000000000000008AULL, 0x0000000000000088ULL, 0x0000000080008009ULL, 0x000000008000000AULL,
+    0x000000008000808BULL, 0x800000000000008BULL, 0x8000000000008089ULL, 0x8000000000008003ULL,
+    0x8000000000008002ULL, 0x8000000000000080ULL, 0x000000000000800AULL, 0x800000008000000AULL,
+    0x8000000080008081ULL, 0x8000000000008080ULL, 0x0000000080000001ULL, 0x8000000080008008ULL,
+    //
+};
+
+// Keccak-f[1600] permutation
+void sha3_permutation(uint64_t state[25]);
+#if defined(BELA_HASH_X86)
+// 4 independent Keccak states, state[lane_index * 4 + instance]. XOR one rate-sized block
+// (little-endian words) of each instance into its state, then permute all four
+void sha3_absorb_x4_avx2(uint64_t state[100], const uint8_t *const blocks[4], size_t rate_words);
+#endif
+} // namespace bela::hash::sha3
+
+#endif
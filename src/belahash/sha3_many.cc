@@ -0,0 +1,129 @@
+/// SHA-3 multi-buffer: four messages absorbed together, one per AVX2 64-bit lane
+#include <bela/hash.hpp>
+#include "hashinternal.hpp"
+#include "sha3_impl.hpp"
+
+namespace bela::hash::sha3 {
+namespace {
+constexpr size_t max_rate = sha3_max_rate_in_qwords * 8;
+
+// Lane a message in flight: full rate blocks come straight from the message, the padded last
+// block from tail
+struct lane_t {
+  const uint8_t *msg{nullptr};
+  size_t full{0};
+  size_t j{0};
+  size_t index{0};
+  uint8_t tail[max_rate];
+  bool active{false};
+  void Assign(bela::Span<const uint8_t> m, size_t i, size_t rate) {
+    msg = m.data();
+    full = m.size() / rate;
+    index = i;
+    j = 0;
+    active = true;
+    auto rest = m.size() - full * rate;
+    memset(tail, 0, rate);
+    if (rest != 0) {
+      memcpy(tail, msg + full * rate, rest);
+    }
+    tail[rest] |= 0x06;
+    tail[rate - 1] |= 0x80;
+  }
+  size_t Blocks() const { return full + 1; }
+  const uint8_t *Block(size_t rate) const { return j < full ? msg + j * rate : tail; }
+};
+
+inline void write_digest(const uint64_t h[25], Digest &d, size_t len) { me64_to_le_str(d.data(), h, len); }
+
+#if defined(BELA_HASH_X86)
+void hash_many_x4(bela::Span<const bela::Span<const uint8_t>> messages, bela::Span<Digest> digests, size_t count,
+                  size_t rate, size_t digest_length) {
+  constexpr size_t Lanes = 4;
+  static const uint8_t zero[max_rate] = {0};
+  alignas(32) uint64_t state[25 * Lanes];
+  lane_t lanes[Lanes];
+  const uint8_t *ptrs[Lanes];
+  size_t next = 0;
+  auto assign = [&](size_t l) {
+    lanes[l].Assign(messages[next], next, rate);
+    for (size_t i = 0; i < 25; i++) {
+      state[i * Lanes + l] = 0;
+    }
+    next++;
+  };
+  for (size_t l = 0; l < Lanes && next < count; l++) {
+    assign(l);
+  }
+  for (;;) {
+    size_t active = 0;
+    for (size_t l = 0; l < Lanes; l++) {
+      if (lanes[l].active) {
+        ptrs[l] = lanes[l].Block(rate);
+        active++;
+        continue;
+      }
+      ptrs[l] = zero;
+    }
+    // nothing left to schedule and a single lane busy: finish it with the scalar permutation
+    if (active == 0 || (next == count && active == 1)) {
+      break;
+    }
+    sha3_absorb_x4_avx2(state, ptrs, rate / 8);
+    for (size_t l = 0; l < Lanes; l++) {
+      auto &lane = lanes[l];
+      if (!lane.active || ++lane.j != lane.Blocks()) {
+        continue;
+      }
+      uint64_t h[25];
+      for (size_t i = 0; i < 25; i++) {
+        h[i] = state[i * Lanes + l];
+      }
+      write_digest(h, digests[lane.index], digest_length);
+      lane.active = false;
+      if (next < count) {
+        assign(l);
+      }
+    }
+  }
+  for (size_t l = 0; l < Lanes; l++) {
+    auto &lane = lanes[l];
+    if (!lane.active) {
+      continue;
+    }
+    uint64_t h[25];
+    for (size_t i = 0; i < 25; i++) {
+      h[i] = state[i * Lanes + l];
+    }
+    for (; lane.j < lane.Blocks(); lane.j++) {
+      const auto block = lane.Block(rate);
+      for (size_t i = 0; i < rate / 8; i++) {
+        h[i] ^= bela::readle<uint64_t>(block + i * 8);
+      }
+      sha3_permutation(h);
+    }
+    write_digest(h, digests[lane.index], digest_length);
+  }
+}
+#endif
+} // namespace
+
+void HashMany(bela::Span<const bela::Span<const uint8_t>> messages, bela::Span<Digest> digests, HashBits hb) {
+  const auto count = (std::min)(messages.size(), digests.size());
+  const auto digest_length = static_cast<size_t>(hb) / 8;
+#if defined(BELA_HASH_X86)
+  if (count > 1 && bela::hash::internal::GetCpuFeatures().avx2) {
+    /* NB: The Keccak capacity parameter = bits * 2 */
+    const size_t rate = (1600 - static_cast<size_t>(hb) * 2) / 8;
+    hash_many_x4(messages, digests, count, rate, digest_length);
+    return;
+  }
+#endif
+  Hasher h;
+  for (size_t i = 0; i < count; i++) {
+    h.Initialize(hb);
+    h.Update(messages[i].data(), messages[i].size());
+    h.Finalize(digests[i].data(), digest_length);
+  }
+}
+} // namespace bela::hash::sha3
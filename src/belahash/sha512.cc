@@ -19,6 +19,7 @@
 
 #include <bela/hash.hpp>
 #include "hashinternal.hpp"
+#include "hashstate.hpp"
 
 namespace bela::hash::sha512 {
 
@@ -226,4 +227,38 @@ void Hasher::Finalize(uint8_t *out, size_t out_len) {
     be64_copy(out, 0, hash, digest_length);
   }
 }
+
+std::string Hasher::SaveState() const {
+  std::string state;
+  internal::StateWriter w(state, hb == HashBits::SHA384 ? Algorithm::SHA384 : Algorithm::SHA512);
+  w.U64(length);
+  for (auto v : hash) {
+    w.U64(v);
+  }
+  w.Bytes(message, static_cast<size_t>(length & 127));
+  return state;
+}
+
+StateStatus Hasher::RestoreState(std::string_view state) {
+  internal::StateReader r(state);
+  Algorithm a;
+  if (auto status = internal::ReadStateHeader(r, a); status != StateStatus::Ok) {
+    return status;
+  }
+  if (a != Algorithm::SHA384 && a != Algorithm::SHA512) {
+    return StateStatus::WrongAlgorithm;
+  }
+  Hasher h;
+  h.Initialize(a == Algorithm::SHA384 ? HashBits::SHA384 : HashBits::SHA512);
+  h.length = r.U64();
+  for (auto &v : h.hash) {
+    v = r.U64();
+  }
+  r.Bytes(h.message, static_cast<size_t>(h.length & 127));
+  if (auto status = r.Finish(); status != StateStatus::Ok) {
+    return status;
+  }
+  *this = h;
+  return StateStatus::Ok;
+}
 } // namespace bela::hash::sha512
\ No newline at end of file
@@ -3,6 +3,7 @@
 // https://github.com/NEWPLAN/SMx/blob/master/SM3/Windows/SM3/src/sm3.c
 #include <bela/hash.hpp>
 #include "hashinternal.hpp"
+#include "hashstate.hpp"
 
 #if IS_BIG_ENDIAN
 #define GET32(n, b, i)                                                                                                 \
@@ -215,4 +216,39 @@ void Hasher::Finalize(uint8_t *out, size_t out_len) {
   }
 }
 
+std::string Hasher::SaveState() const {
+  std::string state;
+  internal::StateWriter w(state, Algorithm::SM3);
+  w.U32(Nl);
+  w.U32(Nh);
+  for (auto v : digest) {
+    w.U32(v);
+  }
+  w.Bytes(block, Nl & 0x3F);
+  return state;
+}
+
+StateStatus Hasher::RestoreState(std::string_view state) {
+  internal::StateReader r(state);
+  Algorithm a;
+  if (auto status = internal::ReadStateHeader(r, a); status != StateStatus::Ok) {
+    return status;
+  }
+  if (a != Algorithm::SM3) {
+    return StateStatus::WrongAlgorithm;
+  }
+  Hasher h;
+  h.Nl = r.U32();
+  h.Nh = r.U32();
+  for (auto &v : h.digest) {
+    v = r.U32();
+  }
+  r.Bytes(h.block, h.Nl & 0x3F);
+  if (auto status = r.Finish(); status != StateStatus::Ok) {
+    return status;
+  }
+  *this = h;
+  return StateStatus::Ok;
+}
+
 } // namespace bela::hash::sm3
\ No newline at end of file
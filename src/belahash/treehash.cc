@@ -0,0 +1,409 @@
+///
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <mutex>
+#include <bela/treehash.hpp>
+#include <bela/codecvt.hpp>
+#include <bela/numbers.hpp>
+#include <bela/str_split.hpp>
+#include <bela/threadpool.hpp>
+#if defined(_WIN32)
+#include <bela/fs.hpp>
+#else
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include "posix_error.hpp"
+#endif
+
+namespace bela::hash {
+namespace {
+// TreeWalker one directory per task, files are hashed by tasks of the same group
+struct TreeWalker {
+  TreeWalker(Algorithm algorithm_, bela::ThreadPool &pool_, const TreeManifest *previous_)
+      : algorithm(algorithm_), pool(pool_), group(pool_), previous(previous_) {}
+  Algorithm algorithm;
+  bela::ThreadPool &pool;
+  bela::TaskGroup group;
+  const TreeManifest *previous;
+  std::mutex mu;
+  std::vector<std::unique_ptr<TreeEntry>> entries;
+  bela::error_code ec; // first error
+  std::atomic<bool> failed{false};
+  std::atomic<size_t> hashed{0};
+  std::atomic<size_t> reused{0};
+
+  void Fail(bela::error_code &&e) {
+    std::lock_guard<std::mutex> lock(mu);
+    if (!failed.exchange(true)) {
+      ec = std::move(e);
+    }
+  }
+
+  TreeEntry *Add(std::unique_ptr<TreeEntry> &&entry) {
+    std::lock_guard<std::mutex> lock(mu);
+    return entries.emplace_back(std::move(entry)).get();
+  }
+
+  void HashOne(TreeEntry *entry, const std::wstring &file) {
+    if (failed) {
+      return;
+    }
+    const Algorithm algorithms[] = {algorithm};
+    HashFileOptions options;
+    options.pool = &pool;
+    std::vector<FileDigest> digests;
+    bela::error_code e;
+    if (!HashFile(file, algorithms, digests, e, options)) {
+      e.message = bela::StringCat(file, L": ", e.message);
+      Fail(std::move(e));
+      return;
+    }
+    entry->digest = digests[0];
+    hashed++;
+  }
+
+  // AddFile take the digest from the previous manifest when size and mtime match, else hash it on the pool
+  void AddFile(std::wstring &&file, std::wstring &&rel, uint64_t size, int64_t mtime) {
+    auto entry = std::make_unique<TreeEntry>();
+    entry->path = std::move(rel);
+    entry->size = size;
+    entry->mtime = mtime;
+    if (previous != nullptr) {
+      if (auto p = previous->Find(entry->path); p != nullptr && p->size == entry->size && p->mtime == entry->mtime) {
+        entry->digest = p->digest;
+        Add(std::move(entry));
+        reused++;
+        return;
+      }
+    }
+    auto e = Add(std::move(entry));
+    group.Run([this, e, file = std::move(file)] { HashOne(e, file); });
+  }
+
+#if defined(_WIN32)
+  void Walk(const std::wstring &dir, const std::wstring &rel) {
+    if (failed) {
+      return;
+    }
+    bela::fs::Finder finder;
+    bela::error_code e;
+    if (!finder.First(dir, L"*", e)) {
+      Fail(std::move(e));
+      return;
+    }
+    do {
+      if (finder.Ignore()) {
+        continue;
+      }
+      auto child = bela::StringCat(dir, L"\\", finder.Name());
+      auto childRel = rel.empty() ? std::wstring(finder.Name()) : bela::StringCat(rel, L"/", finder.Name());
+      if (finder.IsDir()) {
+        // don't follow junctions and directory symlinks, the tree could loop
+        if (!finder.IsReparsePoint()) {
+          group.Run([this, child = std::move(child), childRel = std::move(childRel)] { Walk(child, childRel); });
+        }
+        continue;
+      }
+      const auto &fd = finder.FD();
+      AddFile(std::move(child), std::move(childRel), (static_cast<uint64_t>(fd.nFileSizeHigh) << 32) | fd.nFileSizeLow,
+              static_cast<int64_t>((static_cast<uint64_t>(fd.ftLastWriteTime.dwHighDateTime) << 32) |
+                                   fd.ftLastWriteTime.dwLowDateTime));
+    } while (finder.Next());
+  }
+#else
+  void Walk(const std::wstring &dir, const std::wstring &rel) {
+    if (failed) {
+      return;
+    }
+    auto d = ::opendir(bela::ToNarrow(dir).data());
+    if (d == nullptr) {
+      Fail(internal::make_errno_error_code(bela::StringCat(dir, L": ")));
+      return;
+    }
+    auto closer = bela::finally([&] { ::closedir(d); });
+    for (;;) {
+      errno = 0;
+      auto de = ::readdir(d);
+      if (de == nullptr) {
+        if (errno != 0) {
+          Fail(internal::make_errno_error_code(bela::StringCat(dir, L": ")));
+        }
+        return;
+      }
+      std::string_view name(de->d_name);
+      if (name == "." || name == "..") {
+        continue;
+      }
+      struct stat st;
+      if (::fstatat(::dirfd(d), de->d_name, &st, AT_SYMLINK_NOFOLLOW) != 0) {
+        Fail(internal::make_errno_error_code(bela::StringCat(dir, L"/", bela::ToWide(name), L": ")));
+        return;
+      }
+      auto wname = bela::ToWide(name);
+      auto child = bela::StringCat(dir, L"/", wname);
+      auto childRel = rel.empty() ? wname : bela::StringCat(rel, L"/", wname);
+      // don't follow directory symlinks, the tree could loop. Symlinked files are hashed like on Windows
+      if (S_ISDIR(st.st_mode)) {
+        group.Run([this, child = std::move(child), childRel = std::move(childRel)] { Walk(child, childRel); });
+        continue;
+      }
+      if (S_ISLNK(st.st_mode) && ::fstatat(::dirfd(d), de->d_name, &st, 0) != 0) {
+        continue; // dangling
+      }
+      if (!S_ISREG(st.st_mode)) {
+        continue;
+      }
+      // mtime as FILETIME ticks, manifests compare the same way on every platform
+      constexpr int64_t unix_epoch_ticks = 116444736000000000;
+      AddFile(std::move(child), std::move(childRel), static_cast<uint64_t>(st.st_size),
+              unix_epoch_ticks + static_cast<int64_t>(st.st_mtim.tv_sec) * 10000000 + st.st_mtim.tv_nsec / 100);
+    }
+  }
+#endif
+};
+
+void HashLeaf(Algorithm algorithm, const TreeEntry &e, uint8_t *out) {
+  AnyHasher h(algorithm);
+  auto path = bela::ToNarrow(e.path);
+  uint8_t buf[8];
+  auto put64 = [&](uint64_t v) {
+    for (int i = 0; i < 8; i++) {
+      buf[i] = static_cast<uint8_t>(v >> (i * 8));
+    }
+    h.Update(buf, sizeof(buf));
+  };
+  const uint8_t prefix = 0x00;
+  h.Update(&prefix, 1);
+  put64(path.size());
+  h.Update(path.data(), path.size());
+  put64(e.size);
+  h.Update(e.digest.digest, e.digest.length);
+  h.Finalize(out, h.DigestLength());
+}
+
+void HashNodes(Algorithm algorithm, bela::Span<const TreeEntry> entries, uint8_t *out) {
+  if (entries.size() == 1) {
+    HashLeaf(algorithm, entries[0], out);
+    return;
+  }
+  size_t k = 1;
+  while ((k << 1) < entries.size()) {
+    k <<= 1;
+  }
+  const auto len = DigestLength(algorithm);
+  uint8_t children[max_digest_length * 2];
+  HashNodes(algorithm, entries.subspan(0, k), children);
+  HashNodes(algorithm, entries.subspan(k), children + len);
+  AnyHasher h(algorithm);
+  const uint8_t prefix = 0x01;
+  h.Update(&prefix, 1);
+  h.Update(children, len * 2);
+  h.Finalize(out, len);
+}
+
+bool DecodeHex(std::wstring_view hex, FileDigest &d) {
+  auto value = [](wchar_t c) -> int {
+    if (c >= L'0' && c <= L'9') {
+      return c - L'0';
+    }
+    if (c >= L'a' && c <= L'f') {
+      return c - L'a' + 10;
+    }
+    if (c >= L'A' && c <= L'F') {
+      return c - L'A' + 10;
+    }
+    return -1;
+  };
+  if (hex.size() != d.length * 2) {
+    return false;
+  }
+  for (size_t i = 0; i < d.length; i++) {
+    auto hi = value(hex[i * 2]);
+    auto lo = value(hex[i * 2 + 1]);
+    if (hi < 0 || lo < 0) {
+      return false;
+    }
+    d.digest[i] = static_cast<uint8_t>((hi << 4) | lo);
+  }
+  return true;
+}
+
+// manifest algorithm names, an explicit list: the Algorithm values are not required to be contiguous
+constexpr Algorithm manifest_algorithms[] = {Algorithm::SHA224,   Algorithm::SHA256,   Algorithm::SHA384,
+                                             Algorithm::SHA512,   Algorithm::SHA3_224, Algorithm::SHA3_256,
+                                             Algorithm::SHA3_384, Algorithm::SHA3_512, Algorithm::BLAKE3,
+                                             Algorithm::SM3};
+
+// paths are the last field of a line, escape what would end or corrupt the line
+void EscapePath(std::wstring_view path, std::wstring &out) {
+  for (auto c : path) {
+    switch (c) {
+    case L'\\':
+      out.append(L"\\\\");
+      break;
+    case L'\n':
+      out.append(L"\\n");
+      break;
+    case L'\r':
+      out.append(L"\\r");
+      break;
+    default:
+      out.push_back(c);
+      break;
+    }
+  }
+}
+
+bool UnescapePath(std::wstring_view text, std::wstring &path) {
+  path.clear();
+  for (size_t i = 0; i < text.size(); i++) {
+    if (text[i] != L'\\') {
+      path.push_back(text[i]);
+      continue;
+    }
+    if (++i == text.size()) {
+      return false;
+    }
+    switch (text[i]) {
+    case L'\\':
+      path.push_back(L'\\');
+      break;
+    case L'n':
+      path.push_back(L'\n');
+      break;
+    case L'r':
+      path.push_back(L'\r');
+      break;
+    default:
+      return false;
+    }
+  }
+  return true;
+}
+
+// next space separated field, rest holds what follows
+std::wstring_view NextField(std::wstring_view &rest) {
+  auto pos = rest.find(L' ');
+  auto field = rest.substr(0, pos);
+  rest = pos == std::wstring_view::npos ? std::wstring_view() : rest.substr(pos + 1);
+  return field;
+}
+} // namespace
+
+FileDigest MerkleRoot(Algorithm algorithm, bela::Span<const TreeEntry> entries) {
+  FileDigest d;
+  d.algorithm = algorithm;
+  d.length = DigestLength(algorithm);
+  if (entries.empty()) {
+    AnyHasher h(algorithm);
+    h.Finalize(d.digest, d.length);
+    return d;
+  }
+  HashNodes(algorithm, entries, d.digest);
+  return d;
+}
+
+const TreeEntry *TreeManifest::Find(std::wstring_view path) const {
+  auto it = std::lower_bound(entries.begin(), entries.end(), path,
+                             [](const TreeEntry &e, std::wstring_view p) { return e.path < p; });
+  if (it == entries.end() || it->path != path) {
+    return nullptr;
+  }
+  return &*it;
+}
+
+std::wstring TreeManifest::Encode() const {
+  auto s = bela::StringCat(L"bela-tree v1 ", AlgorithmName(algorithm), L" ", root.Hex(), L"\n");
+  for (const auto &e : entries) {
+    bela::StrAppend(&s, e.digest.Hex(), L" ", e.size, L" ", e.mtime, L" ");
+    EscapePath(e.path, s);
+    s.push_back(L'\n');
+  }
+  return s;
+}
+
+std::optional<TreeManifest> TreeManifest::Decode(std::wstring_view text, bela::error_code &ec) {
+  std::vector<std::wstring_view> lines = bela::StrSplit(text, bela::ByChar(L'\n'), bela::SkipEmpty());
+  if (lines.empty()) {
+    ec = bela::make_error_code(L"empty tree manifest");
+    return std::nullopt;
+  }
+  auto trim = [](std::wstring_view line) {
+    if (!line.empty() && line.back() == L'\r') {
+      line.remove_suffix(1);
+    }
+    return line;
+  };
+  TreeManifest m;
+  auto header = trim(lines[0]);
+  if (NextField(header) != L"bela-tree" || NextField(header) != L"v1") {
+    ec = bela::make_error_code(L"not a bela tree manifest");
+    return std::nullopt;
+  }
+  auto name = NextField(header);
+  auto it = std::find_if(std::begin(manifest_algorithms), std::end(manifest_algorithms),
+                         [&](Algorithm a) { return AlgorithmName(a) == name; });
+  if (it == std::end(manifest_algorithms)) {
+    ec = bela::make_error_code(bela::StringCat(L"unsupported manifest algorithm: ", name));
+    return std::nullopt;
+  }
+  m.algorithm = *it;
+  FileDigest root;
+  root.algorithm = m.algorithm;
+  root.length = DigestLength(m.algorithm);
+  if (!DecodeHex(header, root)) {
+    ec = bela::make_error_code(L"bad manifest root digest");
+    return std::nullopt;
+  }
+  m.entries.reserve(lines.size() - 1);
+  for (size_t i = 1; i < lines.size(); i++) {
+    auto rest = trim(lines[i]);
+    auto &e = m.entries.emplace_back();
+    e.digest.algorithm = m.algorithm;
+    e.digest.length = root.length;
+    if (!DecodeHex(NextField(rest), e.digest) || !bela::SimpleAtoi(NextField(rest), &e.size) ||
+        !bela::SimpleAtoi(NextField(rest), &e.mtime) || rest.empty() || !UnescapePath(rest, e.path)) {
+      ec = bela::make_error_code(bela::StringCat(L"bad manifest line ", i + 1));
+      return std::nullopt;
+    }
+  }
+  std::sort(m.entries.begin(), m.entries.end(), [](const TreeEntry &a, const TreeEntry &b) { return a.path < b.path; });
+  m.root = MerkleRoot(m.algorithm, m.entries);
+  if (memcmp(m.root.digest, root.digest, root.length) != 0) {
+    ec = bela::make_error_code(L"manifest root digest mismatch");
+    return std::nullopt;
+  }
+  return std::make_optional(std::move(m));
+}
+
+std::optional<TreeManifest> TreeHasher::Hash(std::wstring_view root, bela::error_code &ec,
+                                             const TreeManifest *previous) {
+  while (root.size() > 1 && (root.back() == L'\\' || root.back() == L'/')) {
+    root.remove_suffix(1);
+  }
+  if (previous != nullptr && previous->algorithm != algorithm) {
+    previous = nullptr;
+  }
+  TreeWalker walker(algorithm, pool != nullptr ? *pool : bela::ThreadPool::Default(), previous);
+  walker.Walk(std::wstring(root), L"");
+  walker.group.Wait();
+  hashed = walker.hashed;
+  reused = walker.reused;
+  if (walker.failed) {
+    ec = std::move(walker.ec);
+    return std::nullopt;
+  }
+  TreeManifest m;
+  m.algorithm = algorithm;
+  m.entries.reserve(walker.entries.size());
+  for (auto &e : walker.entries) {
+    m.entries.emplace_back(std::move(*e));
+  }
+  std::sort(m.entries.begin(), m.entries.end(), [](const TreeEntry &a, const TreeEntry &b) { return a.path < b.path; });
+  m.root = MerkleRoot(algorithm, m.entries);
+  return std::make_optional(std::move(m));
+}
+
+} // namespace bela::hash
@@ -0,0 +1,117 @@
+///
+#include <bela/checksum.hpp>
+#define XXH_STATIC_LINKING_ONLY
+#include "xxhash/xxhash.h"
+#include "cpufeatures.hpp"
+
+#if defined(BELA_HASH_X86)
+// xxhash_avx2.c and xxhash_avx512.c, same algorithm and state layout with wider accumulators
+extern "C" {
+XXH64_hash_t bela_avx2_XXH3_64bits_withSeed(const void *input, size_t length, XXH64_hash_t seed);
+XXH128_hash_t bela_avx2_XXH3_128bits_withSeed(const void *input, size_t length, XXH64_hash_t seed);
+XXH_errorcode bela_avx2_XXH3_64bits_update(XXH3_state_t *state, const void *input, size_t length);
+XXH_errorcode bela_avx2_XXH3_128bits_update(XXH3_state_t *state, const void *input, size_t length);
+XXH64_hash_t bela_avx512_XXH3_64bits_withSeed(const void *input, size_t length, XXH64_hash_t seed);
+XXH128_hash_t bela_avx512_XXH3_128bits_withSeed(const void *input, size_t length, XXH64_hash_t seed);
+XXH_errorcode bela_avx512_XXH3_64bits_update(XXH3_state_t *state, const void *input, size_t length);
+XXH_errorcode bela_avx512_XXH3_128bits_update(XXH3_state_t *state, const void *input, size_t length);
+}
+#endif
+
+namespace bela::hash {
+namespace {
+static_assert(sizeof(XXH64_state_t) == sizeof(xxh64::Hasher::state), "XXH64_state_t size changed");
+static_assert(sizeof(XXH3_state_t) == sizeof(xxh3::Hasher::state), "XXH3_state_t size changed");
+static_assert(alignof(XXH3_state_t) <= alignof(xxh3::Hasher), "XXH3_state_t alignment changed");
+
+struct Xxh3Kernels {
+  XXH64_hash_t (*hash64)(const void *, size_t, XXH64_hash_t);
+  XXH128_hash_t (*hash128)(const void *, size_t, XXH64_hash_t);
+  XXH_errorcode (*update64)(XXH3_state_t *, const void *, size_t);
+  XXH_errorcode (*update128)(XXH3_state_t *, const void *, size_t);
+};
+
+const Xxh3Kernels &kernels() {
+  static const Xxh3Kernels k = [] {
+#if defined(BELA_HASH_X86)
+    const auto &f = internal::GetCpuFeatures();
+    if (f.avx512f) {
+      return Xxh3Kernels{bela_avx512_XXH3_64bits_withSeed, bela_avx512_XXH3_128bits_withSeed,
+                         bela_avx512_XXH3_64bits_update, bela_avx512_XXH3_128bits_update};
+    }
+    if (f.avx2) {
+      return Xxh3Kernels{bela_avx2_XXH3_64bits_withSeed, bela_avx2_XXH3_128bits_withSeed, bela_avx2_XXH3_64bits_update,
+                         bela_avx2_XXH3_128bits_update};
+    }
+#endif
+    return Xxh3Kernels{XXH3_64bits_withSeed, XXH3_128bits_withSeed, XXH3_64bits_update, XXH3_128bits_update};
+  }();
+  return k;
+}
+
+inline XXH64_state_t *xxh64_state(uint8_t *state) { return reinterpret_cast<XXH64_state_t *>(state); }
+inline const XXH64_state_t *xxh64_state(const uint8_t *state) { return reinterpret_cast<const XXH64_state_t *>(state); }
+inline XXH3_state_t *xxh3_state(uint8_t *state) { return reinterpret_cast<XXH3_state_t *>(state); }
+inline const XXH3_state_t *xxh3_state(const uint8_t *state) { return reinterpret_cast<const XXH3_state_t *>(state); }
+
+void put_be64(uint8_t *out, size_t out_len, uint64_t v) {
+  for (size_t i = 0; i < 8 && i < out_len; i++) {
+    out[i] = static_cast<uint8_t>(v >> (56 - i * 8));
+  }
+}
+} // namespace
+
+namespace xxh64 {
+uint64_t Hash(const void *data, size_t len, uint64_t seed) { return XXH64(data, len, seed); }
+
+void Hasher::Initialize(uint64_t seed) { XXH64_reset(xxh64_state(state), seed); }
+void Hasher::Update(const void *input, size_t input_len) { XXH64_update(xxh64_state(state), input, input_len); }
+uint64_t Hasher::Value() const { return XXH64_digest(xxh64_state(state)); }
+void Hasher::Finalize(uint8_t *out, size_t out_len) { put_be64(out, out_len, Value()); }
+} // namespace xxh64
+
+namespace xxh3 {
+uint64_t Hash64(const void *data, size_t len, uint64_t seed) { return kernels().hash64(data, len, seed); }
+Uint128 Hash128(const void *data, size_t len, uint64_t seed) {
+  auto h = kernels().hash128(data, len, seed);
+  return Uint128{h.low64, h.high64};
+}
+
+void Hasher::Initialize(HashBits hb_, uint64_t seed) {
+  hb = hb_;
+  auto s = xxh3_state(state);
+  XXH3_INITSTATE(s);
+  if (hb == HashBits::XXH3_128) {
+    XXH3_128bits_reset_withSeed(s, seed);
+    return;
+  }
+  XXH3_64bits_reset_withSeed(s, seed);
+}
+
+void Hasher::Update(const void *input, size_t input_len) {
+  if (hb == HashBits::XXH3_128) {
+    kernels().update128(xxh3_state(state), input, input_len);
+    return;
+  }
+  kernels().update64(xxh3_state(state), input, input_len);
+}
+
+uint64_t Hasher::Value64() const { return XXH3_64bits_digest(xxh3_state(state)); }
+Uint128 Hasher::Value128() const {
+  auto h = XXH3_128bits_digest(xxh3_state(state));
+  return Uint128{h.low64, h.high64};
+}
+
+void Hasher::Finalize(uint8_t *out, size_t out_len) {
+  if (hb == HashBits::XXH3_128) {
+    auto v = Value128();
+    put_be64(out, out_len, v.high);
+    if (out_len > 8) {
+      put_be64(out + 8, out_len - 8, v.low);
+    }
+    return;
+  }
+  put_be64(out, out_len, Value64());
+}
+} // namespace xxh3
+} // namespace bela::hash
@@ -0,0 +1,7 @@
+/*
+ * bela: XXH3 with AVX2 accumulators, selected at runtime by xxhash.cc
+ * GCC/Clang: compile with -mavx2, MSVC: -arch:AVX2
+ */
+#define XXH_NAMESPACE bela_avx2_
+#define XXH_VECTOR XXH_AVX2
+#include "xxhash.c"
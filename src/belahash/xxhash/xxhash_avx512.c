@@ -0,0 +1,7 @@
+/*
+ * bela: XXH3 with AVX-512 accumulators, selected at runtime by xxhash.cc
+ * GCC/Clang: compile with -mavx512f, MSVC: -arch:AVX512
+ */
+#define XXH_NAMESPACE bela_avx512_
+#define XXH_VECTOR XXH_AVX512
+#include "xxhash.c"
@@ -1,5 +1,6 @@
 //
 #include <bela/base.hpp>
+#include <bela/cord.hpp>
 #include <bela/mapview.hpp>
 #include <bela/endian.hpp>
 #include <bela/io.hpp>
@@ -65,22 +66,18 @@ bool ReadLine(std::wstring_view file, std::wstring &out, bela::error_code &ec, u
   return true;
 }
 
-bool WriteTextInternal(std::string_view bom, std::string_view text, std::wstring_view file, bela::error_code &ec) {
+namespace {
+HANDLE CreateText(std::wstring_view file, bela::error_code &ec) {
   auto FileHandle = ::CreateFileW(file.data(), FILE_GENERIC_READ | FILE_GENERIC_WRITE, FILE_SHARE_READ, nullptr,
                                   CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
   if (FileHandle == INVALID_HANDLE_VALUE) {
     ec = bela::make_system_error_code();
-    return false;
   }
-  auto closer = bela::finally([&] { CloseHandle(FileHandle); });
+  return FileHandle;
+}
+
+bool WriteAll(HANDLE FileHandle, std::string_view text, bela::error_code &ec) {
   DWORD written = 0;
-  if (!bom.empty()) {
-    if (WriteFile(FileHandle, bom.data(), static_cast<DWORD>(bom.size()), &written, nullptr) != TRUE) {
-      ec = bela::make_system_error_code();
-      return false;
-    }
-  }
-  written = 0;
   auto p = text.data();
   auto size = text.size();
   while (size > 0) {
@@ -95,6 +92,63 @@ bool WriteTextInternal(std::string_view bom, std::string_view text, std::wstring
   return size == 0;
 }
 
+// Utf8Sink converts wide chunks in slices of at most 32K characters, a surrogate pair split by a chunk or slice
+// boundary is held back until its low half arrives
+struct Utf8Sink {
+  static constexpr size_t slice = 32 * 1024;
+  HANDLE FileHandle;
+  wchar_t pending{0};
+  bool Write(std::wstring_view text, bela::error_code &ec) {
+    if (pending != 0 && !text.empty()) {
+      const wchar_t pair[] = {pending, text.front()};
+      pending = 0;
+      text.remove_prefix(1);
+      if (!WriteAll(FileHandle, bela::ToNarrow(pair, 2), ec)) {
+        return false;
+      }
+    }
+    while (!text.empty()) {
+      auto n = (std::min)(text.size(), slice);
+      auto consumed = n;
+      if (auto c = text[n - 1]; c >= 0xD800 && c <= 0xDBFF) {
+        if (n == text.size()) {
+          pending = c; // the low half starts the next chunk
+          n--;
+        } else {
+          n++;
+          consumed++;
+        }
+      }
+      if (n != 0 && !WriteAll(FileHandle, bela::ToNarrow(text.data(), n), ec)) {
+        return false;
+      }
+      text.remove_prefix(consumed);
+    }
+    return true;
+  }
+  bool Finish(bela::error_code &ec) {
+    if (pending == 0) {
+      return true;
+    }
+    const wchar_t c = pending;
+    pending = 0;
+    return WriteAll(FileHandle, bela::ToNarrow(&c, 1), ec);
+  }
+};
+} // namespace
+
+bool WriteTextInternal(std::string_view bom, std::string_view text, std::wstring_view file, bela::error_code &ec) {
+  auto FileHandle = CreateText(file, ec);
+  if (FileHandle == INVALID_HANDLE_VALUE) {
+    return false;
+  }
+  auto closer = bela::finally([&] { CloseHandle(FileHandle); });
+  if (!WriteAll(FileHandle, bom, ec)) {
+    return false;
+  }
+  return WriteAll(FileHandle, text, ec);
+}
+
 bool WriteTextU16LE(std::wstring_view text, std::wstring_view file, bela::error_code &ec) {
   if constexpr (bela::IsBigEndian()) {
     constexpr uint8_t u16bebom[] = {0xFE, 0xFF};
@@ -116,6 +170,38 @@ bool WriteText(std::string_view text, std::wstring_view file, bela::error_code &
   return WriteTextInternal("", text, file, ec);
 }
 
+bool WriteText(const bela::Cord &text, std::wstring_view file, bela::error_code &ec) {
+  auto FileHandle = CreateText(file, ec);
+  if (FileHandle == INVALID_HANDLE_VALUE) {
+    return false;
+  }
+  auto closer = bela::finally([&] { CloseHandle(FileHandle); });
+  Utf8Sink sink{FileHandle};
+  bool ok = true;
+  text.ForEachChunk([&](std::wstring_view chunk) { ok = ok && sink.Write(chunk, ec); });
+  return ok && sink.Finish(ec);
+}
+
+bool WriteTextU16LE(const bela::Cord &text, std::wstring_view file, bela::error_code &ec) {
+  if constexpr (bela::IsBigEndian()) {
+    return WriteTextU16LE(bela::Cord(text).Flatten(), file, ec);
+  }
+  auto FileHandle = CreateText(file, ec);
+  if (FileHandle == INVALID_HANDLE_VALUE) {
+    return false;
+  }
+  auto closer = bela::finally([&] { CloseHandle(FileHandle); });
+  constexpr uint8_t u16lebom[] = {0xFF, 0xFE};
+  if (!WriteAll(FileHandle, std::string_view{reinterpret_cast<const char *>(u16lebom), 2}, ec)) {
+    return false;
+  }
+  bool ok = true;
+  text.ForEachChunk([&](std::wstring_view chunk) {
+    ok = ok && WriteAll(FileHandle, {reinterpret_cast<const char *>(chunk.data()), chunk.size() * sizeof(wchar_t)}, ec);
+  });
+  return ok;
+}
+
 bool WriteTextAtomic(std::string_view text, std::wstring_view file, bela::error_code &ec) {
   if (!bela::PathExists(file)) {
     return WriteTextInternal("", text, file, ec);
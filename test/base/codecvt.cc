@@ -0,0 +1,77 @@
+#include <bela/codecvt.hpp>
+#include <bela/terminal.hpp>
+#include <chrono>
+
+using bela::codecvt_internal::Backend;
+
+constexpr std::pair<Backend, std::wstring_view> backends[] = {
+    {Backend::Portable, L"portable"}, {Backend::SSE41, L"sse41"}, {Backend::AVX2, L"avx2"}, {Backend::NEON, L"neon"}};
+
+int wmain(int argc, wchar_t **argv) {
+  const bool bench = argc >= 2 && std::wstring_view(argv[1]) == L"--bench";
+  std::string_view samples[] = {
+      "C:\\Program Files\\Git\\bin\\git.exe",
+      "Grüße aus Köln, größere Übungsräume für Ärzte und Älplerinnen",
+      "\xD0\x9F\xD1\x80\xD0\xB8\xD0\xB2\xD0\xB5\xD1\x82, \xD0\xBC\xD0\xB8\xD1\x80", // Привет, мир
+      "D:\\\xE6\x96\x87\xE6\xA1\xA3\\\xE9\xA1\xB9\xE7\x9B\xAE\\\xE6\xB5\x8B\xE8\xAF\x95\xE6\x95\xB0\xE6\x8D\xAE.toml",
+      "emoji \xF0\x9F\x98\x80 mixed \xF0\x9F\x8E\x89\xF0\x9F\x8E\x89 with \xE2\x82\xAC and \xC3\xA9 and U+10FFFF \xF4\x8F\xBF\xBF",
+      // invalid: truncated, overlong, surrogate, stray continuation. decoded leniently as before
+      "abc\xE4\xBD",
+      "overlong \xC0\xAF slash",
+      "surrogate \xED\xA0\x80 half",
+      "stray \x80\xBF continuation",
+  };
+  std::string big;
+  for (int i = 0; i < 4096; i++) {
+    big.append(samples[i % 5]).append("\n");
+  }
+  std::wstring want[std::size(samples)];
+  bela::codecvt_internal::SetBackend(Backend::Portable);
+  for (size_t i = 0; i < std::size(samples); i++) {
+    want[i] = bela::ToWide(samples[i]);
+  }
+  auto want_big = bela::ToWide(big);
+  bela::FPrintF(stderr, L"%s\n%s\n%s\n%s\n", want[1], want[2], want[3], want[4]);
+  bela::FPrintF(stderr, L"invalid '%s' '%s' '%s' '%s'\n", want[5], want[6], want[7], want[8]);
+  size_t failed = 0;
+  for (const auto &[b, name] : backends) {
+    if (!bela::codecvt_internal::SetBackend(b)) {
+      bela::FPrintF(stderr, L"%s: not supported\n", name);
+      continue;
+    }
+    size_t mismatch = 0;
+    for (size_t i = 0; i < std::size(samples); i++) {
+      // every length, so each tail and window position is covered
+      for (size_t n = 0; n <= samples[i].size(); n++) {
+        bela::codecvt_internal::SetBackend(Backend::Portable);
+        auto expected = bela::ToWide(samples[i].substr(0, n));
+        bela::codecvt_internal::SetBackend(b);
+        if (bela::ToWide(samples[i].substr(0, n)) != expected) {
+          mismatch++;
+        }
+      }
+      if (bela::ToWide(samples[i]) != want[i]) {
+        mismatch++;
+      }
+    }
+    const auto equal = bela::ToWide(big) == want_big;
+    bela::FPrintF(stderr, L"%s: mismatch %d, equal %b\n", name, mismatch, equal);
+    if (mismatch != 0 || !equal) {
+      failed++;
+    }
+    if (!bench) {
+      continue;
+    }
+    constexpr int rounds = 200;
+    auto begin = std::chrono::steady_clock::now();
+    size_t units = 0;
+    for (int i = 0; i < rounds; i++) {
+      units += bela::ToWide(big).size();
+    }
+    auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+    bela::FPrintF(stderr, L"%s: %d bytes -> %d units, %.2f MB/s\n", name, big.size(), units / rounds,
+                  static_cast<double>(big.size()) * rounds / elapsed / 1e6);
+  }
+  bela::codecvt_internal::SetBackend(Backend::Auto);
+  return failed == 0 ? 0 : 1;
+}
@@ -0,0 +1,106 @@
+// cord_test [--bench] : check Cord text, adopted buffers and chunked UTF-8 writes, then optionally time
+// building a large report with StrAppend against Cord
+#include <bela/cord.hpp>
+#include <bela/fs.hpp>
+#include <bela/io.hpp>
+#include <bela/terminal.hpp>
+#include <chrono>
+
+int Check(std::wstring_view name, std::wstring_view got, std::wstring_view want) {
+  if (got == want) {
+    return 0;
+  }
+  bela::FPrintF(stderr, L"FAIL %s: %d chars, want %d\n", name, got.size(), want.size());
+  return 1;
+}
+
+// WriteText(const Cord &) must rejoin a surrogate pair split across two chunks, the file reads back unchanged
+int WriteSplitPair() {
+  constexpr std::wstring_view file = L"cord_test.txt";
+  bela::Cord c;
+  auto head = std::wstring(bela::Cord::min_owned, L'a');
+  head.push_back(static_cast<wchar_t>(0xD83D)); // U+1F600 high half
+  auto tail = std::wstring(1, static_cast<wchar_t>(0xDE00));
+  tail.append(bela::Cord::min_owned, L'b');
+  const auto want = head + tail;
+  c.Append(std::move(head));
+  c.Append(std::move(tail));
+  int failed = 0;
+  if (c.ChunkCount() != 2) {
+    bela::FPrintF(stderr, L"FAIL split pair: %d chunks, want 2\n", c.ChunkCount());
+    failed++;
+  }
+  bela::error_code ec;
+  std::wstring text;
+  if (!bela::io::WriteText(c, file, ec) || !bela::io::ReadFile(file, text, ec)) {
+    bela::FPrintF(stderr, L"FAIL split pair write/read: %s\n", ec.message);
+    return failed + 1;
+  }
+  failed += Check(L"split pair UTF-8", text, want);
+  if (!bela::io::WriteTextU16LE(c, file, ec) || !bela::io::ReadFile(file, text, ec)) {
+    bela::FPrintF(stderr, L"FAIL split pair UTF-16 write/read: %s\n", ec.message);
+    return failed + 1;
+  }
+  failed += Check(L"split pair UTF-16", text, want);
+  bela::fs::Remove(file, ec);
+  return failed;
+}
+
+int wmain(int argc, wchar_t **argv) {
+  int failed = 0;
+  bela::Cord c;
+  c.Append(L"hello", L" ", 2021, L" ", bela::Hex(0xBE1A));
+  bela::StrAppend(&c, L" world", L'!', L"\n");
+  // an owned buffer long enough to be adopted: it must become a chunk, not be copied
+  std::wstring owned(2048, L'x');
+  const auto buffer = owned.data();
+  c.Append(std::move(owned));
+  c.Append(L"\n");
+  const auto want = bela::StringCat(L"hello 2021 be1a world!\n", std::wstring(2048, L'x'), L"\n");
+  bool adopted = false;
+  c.ForEachChunk([&](std::wstring_view chunk) { adopted = adopted || chunk.data() == buffer; });
+  if (!adopted) {
+    bela::FPrintF(stderr, L"FAIL rvalue buffer was copied\n");
+    failed++;
+  }
+  if (c.size() != want.size() || c.ChunkCount() < 2) {
+    bela::FPrintF(stderr, L"FAIL size %d chunks %d\n", c.size(), c.ChunkCount());
+    failed++;
+  }
+  failed += Check(L"str", c.str(), want);
+  failed += Check(L"Flatten", c.Flatten(), want);
+  if (c.ChunkCount() != 1) {
+    bela::FPrintF(stderr, L"FAIL Flatten left %d chunks\n", c.ChunkCount());
+    failed++;
+  }
+  // Cord appends, copied and moved, keep the order
+  bela::Cord other(std::wstring_view(L"tail"));
+  c.Append(other);
+  c.Append(std::move(other));
+  failed += Check(L"Append(Cord)", c.str(), bela::StringCat(want, L"tailtail"));
+  failed += WriteSplitPair();
+  bela::FPrintF(stderr, L"cord: %d failed\n", failed);
+  if (argc < 2 || std::wstring_view(argv[1]) != L"--bench") {
+    return failed == 0 ? 0 : 1;
+  }
+  constexpr size_t lines = 200000;
+  auto begin = std::chrono::steady_clock::now();
+  std::wstring s;
+  for (size_t i = 0; i < lines; i++) {
+    bela::StrAppend(&s, L"a3f0c9e1d2b4a5c6 ", i, L" ", i * 7, L" some/relative/path/file.txt\n");
+  }
+  auto mid = std::chrono::steady_clock::now();
+  bela::Cord big;
+  for (size_t i = 0; i < lines; i++) {
+    big.Append(L"a3f0c9e1d2b4a5c6 ", i, L" ", i * 7, L" some/relative/path/file.txt\n");
+  }
+  auto end = std::chrono::steady_clock::now();
+  bela::FPrintF(stderr, L"wstring %d us, cord %d us (%d chunks)\n",
+                std::chrono::duration_cast<std::chrono::microseconds>(mid - begin).count(),
+                std::chrono::duration_cast<std::chrono::microseconds>(end - mid).count(), big.ChunkCount());
+  if (big.str() != s) {
+    bela::FPrintF(stderr, L"FAIL large cord differs from the string\n");
+    return 1;
+  }
+  return failed == 0 ? 0 : 1;
+}
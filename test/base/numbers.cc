@@ -0,0 +1,173 @@
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <vector>
+#include <bela/numbers.hpp>
+#include <bela/narrow/numbers.hpp>
+#include <bela/narrow/strcat.hpp>
+#include <bela/strcat.hpp>
+#include <bela/terminal.hpp>
+#include "../testdata.hpp"
+
+int wmain() {
+  constexpr std::wstring_view wides[] = {L"0",
+                                         L" 12345678 ",
+                                         L"-2147483648",
+                                         L"2147483648",
+                                         L"9223372036854775807",
+                                         L"-9223372036854775809",
+                                         L"18446744073709551615",
+                                         L"18446744073709551616",
+                                         L"1234567890123x",
+                                         L"+000000000000000000042"};
+  for (auto w : wides) {
+    int32_t i32 = 0;
+    int64_t i64 = 0;
+    uint64_t u64 = 0;
+    auto r32 = bela::SimpleAtoi(w, &i32);
+    auto r64 = bela::SimpleAtoi(w, &i64);
+    auto ru64 = bela::SimpleAtoi(w, &u64);
+    bela::FPrintF(stderr, L"[%s] int32 %b %d int64 %b %d uint64 %b %d\n", w, r32, i32, r64, i64, ru64, u64);
+    // narrow parsing must agree with wide parsing on ASCII text
+    std::string n;
+    for (auto c : w) {
+      n.push_back(static_cast<char>(c));
+    }
+    int64_t n64 = 0;
+    uint64_t nu64 = 0;
+    if (bela::narrow::SimpleAtoi(n, &n64) != r64 || n64 != i64 || bela::narrow::SimpleAtoi(n, &nu64) != ru64 ||
+        nu64 != u64) {
+      bela::FPrintF(stderr, L"narrow mismatch: %s\n", w);
+      return 1;
+    }
+  }
+  // expected bits from a correctly rounded strtod/strtof, out of range text still succeeds as infinity or zero.
+  // The exact halfway cases must round to even: a sticky bit left over from an exact division used to round them up
+  struct float_case {
+    std::wstring_view text;
+    bool ok;
+    uint64_t d;
+    uint32_t f;
+  };
+  constexpr float_case floats[] = {
+      {L"0.1", true, 0x3FB999999999999A, 0x3DCCCCCD},
+      {L" -2.5e-3 ", true, 0xBF647AE147AE147B, 0xBB23D70A},
+      {L"+1e23", true, 0x44B52D02C7E14AF6, 0x65A96816},
+      {L"1.7976931348623159e308", true, 0x7FF0000000000000, 0x7F800000},
+      {L"4.9e-324", true, 0x0000000000000001, 0x00000000},
+      {L"123456789012345678901", true, 0x441AC53A7E04BCDA, 0x60D629D4},
+      {L"inf", true, 0x7FF0000000000000, 0x7F800000},
+      {L".5", true, 0x3FE0000000000000, 0x3F000000},
+      {L"9007199254740993", true, 0x4340000000000000, 0x5A000000},
+      {L"9007199254740993.000000000000000000001", true, 0x4340000000000001, 0x5A000000},
+      {L"60973.658203125", true, 0x40EDC5B510000000, 0x476E2DA8},
+      {L"4.1353087890625000e+04", true, 0x40E43122D0000000, 0x47218916},
+      {L"5.72621402213807539062500000000e+13", true, 0x42CA0A30C373E260, 0x56505186},
+      {L"1.00000005960464477539062500", true, 0x3FF0000010000000, 0x3F800000},
+      {L"1e-400", true, 0x0000000000000000, 0x00000000},
+      {L"-1e400", true, 0xFFF0000000000000, 0xFF800000},
+      {L"1e", false, 0, 0},
+      {L"0x1p3", false, 0, 0},
+      {L"+-1", false, 0, 0},
+      {L" ", false, 0, 0},
+  };
+  for (const auto &c : floats) {
+    double d = 0;
+    float x = 0;
+    auto rd = bela::SimpleAtod(c.text, &d);
+    auto rf = bela::SimpleAtof(c.text, &x);
+    uint64_t db = 0;
+    uint32_t fb = 0;
+    memcpy(&db, &d, sizeof(db));
+    memcpy(&fb, &x, sizeof(fb));
+    if (rd != c.ok || rf != c.ok || (c.ok && (db != c.d || fb != c.f))) {
+      bela::FPrintF(stderr, L"[%s] double %b %016x want %016x float %b %08x want %08x\n", c.text, rd, db, c.d, rf, fb,
+                    c.f);
+      return 1;
+    }
+  }
+  // integer text must read back as the same value, StringCat, narrow StringCat and %d share one writer
+  constexpr int64_t ints[] = {0,          7,          -9,          10,       99, -100, 999999999, 1000000000,
+                              4294967295, 4294967296, -2147483648, INT64_MAX, INT64_MIN};
+  for (auto i : ints) {
+    auto w = bela::StringCat(i);
+    auto n = bela::narrow::StringCat(i);
+    int64_t back = 0;
+    if (!bela::SimpleAtoi(w, &back) || back != i || w != bela::StrFormat(L"%d", i) || n.size() != w.size()) {
+      bela::FPrintF(stderr, L"integer text mismatch: %s\n", w);
+      return 1;
+    }
+    bela::FPrintF(stderr, L"%s %s|%s\n", w, bela::StringCat(bela::Dec(i, bela::kZeroPad8)), n);
+  }
+  bela::FPrintF(stderr, L"%d %s\n", UINT64_MAX, bela::StringCat(UINT64_MAX));
+  // bulk column parsing stops at the first bad field and reports where it starts, count values were stored
+  struct int_column {
+    std::wstring_view text;
+    wchar_t delimiter;
+    size_t capacity;
+    bela::ParseNumbersResult want;
+    int64_t values[4];
+  };
+  const int_column int_columns[] = {
+      {L"1024\r\n-7\r\n 123456789012 \r\n", L'\n', 8, {3, 26, std::errc{}}, {1024, -7, 123456789012}},
+      {L"1,2,,4", L',', 8, {2, 4, std::errc::invalid_argument}, {1, 2}},
+      {L"3.5,1e-3,+2,inf,", L',', 8, {0, 0, std::errc::invalid_argument}, {}},
+      {L"1,9223372036854775808", L',', 8, {1, 2, std::errc::result_out_of_range}, {1}},
+      {L"-9223372036854775808,+9223372036854775807", L',', 8, {2, 41, std::errc{}}, {INT64_MIN, INT64_MAX}},
+      {L"12x,4", L',', 8, {0, 0, std::errc::invalid_argument}, {}},
+      {L"10,20,30", L',', 2, {2, 6, std::errc::value_too_large}, {10, 20}},
+      {L"10,20", L',', 2, {2, 5, std::errc{}}, {10, 20}},
+      {L"", L',', 8, {0, 0, std::errc{}}, {}},
+  };
+  for (const auto &c : int_columns) {
+    int64_t out[8] = {0};
+    auto r = bela::ParseNumbers(c.text, c.delimiter, bela::MakeSpan(out, c.capacity));
+    if (r.count != c.want.count || r.offset != c.want.offset || r.ec != c.want.ec ||
+        !std::equal(out, out + r.count, c.values)) {
+      bela::FPrintF(stderr, L"[%s] int64 count %d offset %d ec %d\n", c.text, r.count, r.offset,
+                    static_cast<int>(r.ec));
+      return 1;
+    }
+  }
+  struct double_column {
+    std::wstring_view text;
+    size_t capacity;
+    bela::ParseNumbersResult want;
+    double values[4];
+  };
+  const double_column double_columns[] = {
+      {L"3.5,1e-3,+2,inf,", 8, {4, 16, std::errc{}}, {3.5, 1e-3, 2, std::numeric_limits<double>::infinity()}},
+      {L"1,2,,4", 8, {2, 4, std::errc::invalid_argument}, {1, 2}},
+      {L"1,9223372036854775808", 8, {2, 21, std::errc{}}, {1, 9223372036854775808.0}},
+      {L" 0.1 , -2.5e-3 ,60973.658203125", 8, {3, 31, std::errc{}}, {0.1, -2.5e-3, 60973.658203125}},
+      {L"12x,4", 8, {0, 0, std::errc::invalid_argument}, {}},
+      {L"1.5,2.5,3.5", 2, {2, 8, std::errc::value_too_large}, {1.5, 2.5}},
+  };
+  for (const auto &c : double_columns) {
+    double out[8] = {0};
+    auto r = bela::ParseNumbers(c.text, L',', bela::MakeSpan(out, c.capacity));
+    if (r.count != c.want.count || r.offset != c.want.offset || r.ec != c.want.ec ||
+        !std::equal(out, out + r.count, c.values)) {
+      bela::FPrintF(stderr, L"[%s] double count %d offset %d ec %d\n", c.text, r.count, r.offset,
+                    static_cast<int>(r.ec));
+      return 1;
+    }
+  }
+  // a long column, the integer fields are read eight digits per load and must agree with SimpleAtoi
+  std::wstring column;
+  std::vector<int64_t> want;
+  bela::test::Xorshift rng;
+  for (int i = 0; i < 1000; i++) {
+    auto x = rng.Next();
+    auto v = static_cast<int64_t>(x) >> (x % 63);
+    want.push_back(v);
+    bela::StrAppend(&column, v, i % 3 == 0 ? L"\r\n" : L"\n");
+  }
+  std::vector<int64_t> got(want.size());
+  auto r = bela::ParseNumbers(column, L'\n', bela::MakeSpan(got));
+  if (r.count != want.size() || r.offset != column.size() || r.ec != std::errc{} || got != want) {
+    bela::FPrintF(stderr, L"long column count %d offset %d ec %d\n", r.count, r.offset, static_cast<int>(r.ec));
+    return 1;
+  }
+  return 0;
+}
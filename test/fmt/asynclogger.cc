@@ -0,0 +1,149 @@
+/// asynclogger_test [--bench [threads]] : check every message reaches the file in per thread order, then
+/// optionally log to stdout from worker threads and report call latency on stderr
+///   asynclogger_test --bench 8 > NUL
+#include <algorithm>
+#include <chrono>
+#include <vector>
+#include <bela/logger.hpp>
+#include <bela/numbers.hpp>
+#include <bela/str_split.hpp>
+
+constexpr int lines = 20000;
+
+template <typename Fn> void Run(const wchar_t *name, int threads, Fn &&fn) {
+  std::vector<std::vector<double>> latency(threads);
+  std::vector<std::thread> workers;
+  auto begin = std::chrono::steady_clock::now();
+  for (int t = 0; t < threads; t++) {
+    workers.emplace_back([&, t] {
+      auto &l = latency[t];
+      l.reserve(lines);
+      for (int i = 0; i < lines; i++) {
+        auto s = std::chrono::steady_clock::now();
+        fn(t, i);
+        std::chrono::duration<double, std::nano> d = std::chrono::steady_clock::now() - s;
+        l.push_back(d.count());
+      }
+    });
+  }
+  for (auto &w : workers) {
+    w.join();
+  }
+  std::chrono::duration<double, std::milli> total = std::chrono::steady_clock::now() - begin;
+  std::vector<double> all;
+  for (const auto &l : latency) {
+    all.insert(all.end(), l.begin(), l.end());
+  }
+  std::sort(all.begin(), all.end());
+  bela::FPrintF(stderr, L"%s: %d lines in %.1f ms, p50 %.0f ns p99 %.0f ns max %.0f ns\n", name, all.size(),
+                total.count(), all[all.size() / 2], all[all.size() * 99 / 100], all.back());
+}
+
+// Lossless producers log numbered lines through a small Block ring, so they keep waiting on the writer, every
+// third line is longer than a slot. The file must hold each line once, in order per thread.
+int Lossless(int threads, size_t capacity) {
+  auto out = tmpfile();
+  if (out == nullptr) {
+    bela::FPrintF(stderr, L"FAIL tmpfile\n");
+    return 1;
+  }
+  const std::wstring pad(bela::AsyncLogger::inline_chars, L'.');
+  constexpr int count = 5000;
+  uint64_t dropped = 0;
+  {
+    bela::AsyncLoggerOptions options;
+    options.capacity = capacity;
+    bela::AsyncLogger logger(options);
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; t++) {
+      workers.emplace_back([&, t] {
+        for (int i = 0; i < count; i++) {
+          logger.FPrintF(out, L"%d %d %s\n", t, i, i % 3 == 0 ? std::wstring_view(pad) : std::wstring_view());
+        }
+      });
+    }
+    for (auto &w : workers) {
+      w.join();
+    }
+    logger.Flush();
+    dropped = logger.Dropped();
+  }
+  std::string text;
+  rewind(out);
+  char chunk[4096];
+  size_t n = 0;
+  while ((n = fread(chunk, 1, sizeof(chunk), out)) != 0) {
+    text.append(chunk, n);
+  }
+  fclose(out);
+  int failed = dropped == 0 ? 0 : 1;
+  std::vector<int> next(threads, 0);
+  const auto wtext = bela::ToWide(text);
+  for (auto line : bela::StrSplit(wtext, bela::ByChar(L'\n'), bela::SkipEmpty())) {
+    std::vector<std::wstring_view> fields = bela::StrSplit(line, bela::ByChar(L' '));
+    int t = -1;
+    int i = -1;
+    if (fields.size() != 3 || !bela::SimpleAtoi(fields[0], &t) || !bela::SimpleAtoi(fields[1], &i) || t < 0 ||
+        t >= threads || i != next[t] || fields[2].size() != (i % 3 == 0 ? pad.size() : 0)) {
+      failed++;
+      continue;
+    }
+    next[t]++;
+  }
+  for (int t = 0; t < threads; t++) {
+    if (next[t] != count) {
+      failed++;
+    }
+  }
+  if (failed != 0) {
+    bela::FPrintF(stderr, L"FAIL %d threads capacity %d: %d bad lines, %d dropped\n", threads, capacity, failed,
+                  dropped);
+  }
+  return failed;
+}
+
+int wmain(int argc, wchar_t **argv) {
+  int failed = Lossless(4, 8) + Lossless(8, 64) + Lossless(1, 4096);
+  // an empty message is written (as nothing), only a format that doesn't match its arguments is refused
+  {
+    bela::AsyncLogger logger;
+    if (!logger.FPrintF(stderr, L"") || !logger.FPrintF(stderr, L"%s", L"") ||
+        !logger.FPrintF(stderr, L"%s%s", "", std::wstring())) {
+      bela::FPrintF(stderr, L"FAIL empty message refused\n");
+      failed++;
+    }
+    if (logger.FPrintF(stderr, L"%d %d\n", 1)) {
+      bela::FPrintF(stderr, L"FAIL missing argument accepted\n");
+      failed++;
+    }
+  }
+  bela::FPrintF(stderr, L"asynclogger: %d failed\n", failed);
+  if (argc < 2 || std::wstring_view(argv[1]) != L"--bench") {
+    return failed == 0 ? 0 : 1;
+  }
+  int threads = 4;
+  if (argc > 2 && (!bela::SimpleAtoi(argv[2], &threads) || threads <= 0)) {
+    bela::FPrintF(stderr, L"usage: %s --bench [threads]\n", argv[0]);
+    return 1;
+  }
+  Run(L"FPrintF", threads, [](int t, int i) {
+    bela::FPrintF(stdout, L"thread %d line %d value %.3f\n", t, i, i * 0.125);
+  });
+  {
+    bela::AsyncLogger logger;
+    Run(L"AsyncLogger", threads, [&](int t, int i) {
+      logger.FPrintF(stdout, L"thread %d line %d value %.3f\n", t, i, i * 0.125);
+    });
+    logger.Flush();
+  }
+  bela::AsyncLoggerOptions options;
+  options.capacity = 64;
+  options.overflow = bela::LogOverflow::Drop;
+  bela::AsyncLogger logger(options);
+  Run(L"AsyncLogger (drop)", threads, [&](int t, int i) {
+    logger.FPrintF(stdout, L"thread %d line %d value %.3f\n", t, i, i * 0.125);
+  });
+  logger.Flush();
+  bela::FPrintF(stderr, L"dropped %d of %d\n", logger.Dropped(), static_cast<uint64_t>(threads) * lines);
+  return failed == 0 ? 0 : 1;
+}
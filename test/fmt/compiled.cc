@@ -0,0 +1,105 @@
+///
+#include <chrono>
+#include <bela/terminal.hpp>
+
+#if defined(BELA_HAVE_COMPILED_FORMAT)
+namespace fi = bela::format_internal;
+using fi::ArgType;
+// every directive against the argument types it must refuse, checked where bela::Format checks them
+static_assert(fi::VerbAccepts(L'd', ArgType::INTEGER) && fi::VerbAccepts(L'x', ArgType::UINTEGER) &&
+              fi::VerbAccepts(L'd', ArgType::BOOLEAN) && fi::VerbAccepts(L'd', ArgType::FLOAT));
+static_assert(!fi::VerbAccepts(L'd', ArgType::STRING) && !fi::VerbAccepts(L'X', ArgType::USTRING));
+static_assert(fi::VerbAccepts(L's', ArgType::STRING) && fi::VerbAccepts(L's', ArgType::USTRING));
+static_assert(!fi::VerbAccepts(L's', ArgType::INTEGER) && !fi::VerbAccepts(L's', ArgType::POINTER) &&
+              !fi::VerbAccepts(L's', ArgType::CHARACTER));
+static_assert(fi::VerbAccepts(L'c', ArgType::CHARACTER) && !fi::VerbAccepts(L'c', ArgType::STRING) &&
+              !fi::VerbAccepts(L'U', ArgType::FLOAT));
+static_assert(fi::VerbAccepts(L'b', ArgType::BOOLEAN) && !fi::VerbAccepts(L'b', ArgType::STRING));
+static_assert(fi::VerbAccepts(L'f', ArgType::FLOAT) && !fi::VerbAccepts(L'f', ArgType::INTEGER) &&
+              !fi::VerbAccepts(L'g', ArgType::STRING));
+static_assert(fi::VerbAccepts(L'p', ArgType::POINTER) && !fi::VerbAccepts(L'p', ArgType::INTEGER));
+static_assert(!fi::VerbAccepts(L'%', ArgType::INTEGER) && !fi::VerbAccepts(L'k', ArgType::INTEGER));
+// the same through the argument types bela::Format deduces
+static_assert(fi::CompiledFormat<L"%d %s %f %p">::ArgsMatch<int, std::wstring, double, const void *>());
+static_assert(fi::CompiledFormat<L"%s">::ArgsMatch<const char *>() &&
+              fi::CompiledFormat<L"%s">::ArgsMatch<std::u16string_view>());
+static_assert(!fi::CompiledFormat<L"%d">::ArgsMatch<const wchar_t *>());
+static_assert(!fi::CompiledFormat<L"%s">::ArgsMatch<int>());
+static_assert(!fi::CompiledFormat<L"%f">::ArgsMatch<long long>());
+static_assert(!fi::CompiledFormat<L"%c">::ArgsMatch<std::string>());
+static_assert(!fi::CompiledFormat<L"%p">::ArgsMatch<unsigned>());
+static_assert(!fi::CompiledFormat<L"%s %d">::ArgsMatch<int, int>());
+// argument count, literal %% and widths don't consume arguments
+static_assert(fi::CompiledFormat<L"100%% %-8s|%08x">::ArgCount() == 2);
+static_assert(fi::CompiledFormat<L"plain">::ArgCount() == 0);
+// dangling '%' and unknown directives
+static_assert(fi::ParseFormat(L"50%", 3, nullptr) == fi::bad_format);
+static_assert(fi::ParseFormat(L"%k", 2, nullptr) == fi::bad_format);
+static_assert(fi::ParseFormat(L"%-08.3", 6, nullptr) == fi::bad_format);
+#endif
+
+int wmain(int argc, wchar_t **argv) {
+#if defined(BELA_HAVE_COMPILED_FORMAT)
+  int failed = 0;
+  auto check = [&](std::wstring_view what, std::wstring_view runtime, std::wstring_view compiled) {
+    if (runtime != compiled) {
+      bela::FPrintF(stderr, L"FAIL %s\nruntime:  [%s]\ncompiled: [%s]\n", what, runtime, compiled);
+      failed++;
+    }
+  };
+  std::wstring name(L"bela");
+  int n = -1999;
+  unsigned int x = 0xBEEF;
+  check(L"mixed", bela::StrFormat(L"[%s] %d (%08x) %-6s| %c %b %% %p", name, n, x, "UTF-8", L'Z', true, argv),
+        bela::StrFormat(bela::Format<L"[%s] %d (%08x) %-6s| %c %b %% %p">, name, n, x, "UTF-8", L'Z', true, argv));
+  check(L"floats", bela::StrFormat(L"%f %.2f %e %g %8.3f|%-8.1f|", 3.5, 2.0 / 3, 1e-7, 1e21, -1.25, 0.05),
+        bela::StrFormat(bela::Format<L"%f %.2f %e %g %8.3f|%-8.1f|">, 3.5, 2.0 / 3, 1e-7, 1e21, -1.25, 0.05));
+  const auto big = -9007199254740993LL;
+  check(L"integers", bela::StrFormat(L"%d %x %X %o %05d %-5d| %U", big, UINT64_MAX, 255, 8, -42, 7, 0x1F600),
+        bela::StrFormat(bela::Format<L"%d %x %X %o %05d %-5d| %U">, big, UINT64_MAX, 255, 8, -42, 7, 0x1F600));
+  const std::u16string_view u16(u"utf16");
+  const std::string_view empty;
+  check(L"strings", bela::StrFormat(L"%s|%10s|%-10s|%s", u16, L"right", "left", empty),
+        bela::StrFormat(bela::Format<L"%s|%10s|%-10s|%s">, u16, L"right", "left", empty));
+  check(L"literal only", bela::StrFormat(L"no directives"), bela::StrFormat(bela::Format<L"no directives">));
+  check(L"empty", bela::StrFormat(L"%s", L""), bela::StrFormat(bela::Format<L"%s">, L""));
+  std::wstring a1 = L"prefix:";
+  std::wstring a2 = a1;
+  bela::StrAppendFormat(&a1, L"%d/%s", 42, name);
+  bela::StrAppendFormat(&a2, bela::Format<L"%d/%s">, 42, name);
+  check(L"append", a1, a2);
+  // fixed buffers that overflow: both report -1, the buffer contents are unspecified
+  wchar_t b1[8];
+  wchar_t b2[8];
+  auto l1 = bela::StrFormat(b1, L"%d%d", 1234, 5678);
+  auto l2 = bela::StrFormat(b2, bela::Format<L"%d%d">, 1234, 5678);
+  if (l1 != -1 || l2 != -1) {
+    bela::FPrintF(stderr, L"FAIL overflow: runtime %d compiled %d, want -1\n", l1, l2);
+    failed++;
+  }
+  bela::FPrintF(stderr, L"compiled: %d failed\n", failed);
+  if (argc < 2 || std::wstring_view(argv[1]) != L"--bench") {
+    return failed == 0 ? 0 : 1;
+  }
+  constexpr int N = 1000000;
+  wchar_t line[64];
+  bela::ssize_t total = 0;
+  auto begin = std::chrono::steady_clock::now();
+  for (int i = 0; i < N; i++) {
+    total += bela::StrFormat(line, L"%d:%s", i, L"ok");
+  }
+  auto mid = std::chrono::steady_clock::now();
+  for (int i = 0; i < N; i++) {
+    total += bela::StrFormat(line, bela::Format<L"%d:%s">, i, L"ok");
+  }
+  auto end = std::chrono::steady_clock::now();
+  std::chrono::duration<double, std::nano> d1 = mid - begin;
+  std::chrono::duration<double, std::nano> d2 = end - mid;
+  bela::FPrintF(stderr, bela::Format<L"runtime %d ns/op compiled %d ns/op (%d)\n">, static_cast<int>(d1.count() / N),
+                static_cast<int>(d2.count() / N), total);
+  return failed == 0 ? 0 : 1;
+#else
+  bela::FPrintF(stderr, L"bela::Format requires C++20 class type template arguments\n");
+  return 0;
+#endif
+}
@@ -0,0 +1,90 @@
+///
+#include <chrono>
+#include <bela/terminal.hpp>
+
+int failed = 0;
+
+template <typename CharT>
+void Check(std::wstring_view what, const bela::basic_format_buffer<CharT> &buf, size_t returned,
+           std::basic_string_view<CharT> want, bool spilled) {
+  if (buf.view() != want || returned != want.size() || buf.size() != want.size() || buf.spilled() != spilled ||
+      buf.capacity() < buf.size()) {
+    bela::FPrintF(stderr, L"FAIL %s: size %d returned %d want %d spilled %b\n", what, buf.size(), returned,
+                  want.size(), buf.spilled());
+    failed++;
+  }
+}
+
+int wmain(int argc, wchar_t **argv) {
+  // 255, 256 and 257 characters against the 256 inline ones, as one string argument and as a number whose digits
+  // straddle the boundary
+  for (size_t len : {255, 256, 257}) {
+    std::wstring text(len, L'x');
+    bela::FormatBuffer<256> buf;
+    auto n = bela::StrAppendFormat(&buf, L"%s", text);
+    Check(bela::StringCat(L"string ", len), buf, n, std::wstring_view(bela::StrFormat(L"%s", text)), len > 256);
+    std::wstring prefix(len - 4, L'-');
+    bela::FormatBuffer<256> num;
+    auto m = bela::StrAppendFormat(&num, L"%s%d", prefix, -123456);
+    Check(bela::StringCat(L"number ", len), num, m, std::wstring_view(bela::StrFormat(L"%s%d", prefix, -123456)),
+          len + 3 > 256);
+#if defined(BELA_HAVE_COMPILED_FORMAT)
+    bela::FormatBuffer<256> compiled;
+    auto c = bela::StrAppendFormat(&compiled, bela::Format<L"%s">, text);
+    Check(bela::StringCat(L"compiled ", len), compiled, c, std::wstring_view(text), len > 256);
+#endif
+  }
+  // spill over several appends, the text moves to the heap once and keeps growing there
+  bela::FormatBuffer<64> buf;
+  std::wstring want;
+  for (int i = 0; i < 200; i++) {
+    bela::StrAppendFormat(&buf, L"%08x %s|", i * 0x1F3D, argv[0]);
+    want.append(bela::StrFormat(L"%08x %s|", i * 0x1F3D, argv[0]));
+    if (buf.view() != want || buf.spilled() != (want.size() > 64)) {
+      bela::FPrintF(stderr, L"FAIL append %d: size %d want %d spilled %b\n", i, buf.size(), want.size(), buf.spilled());
+      failed++;
+      break;
+    }
+  }
+  // clear keeps the heap storage, the next text is written from the start
+  auto capacity = buf.capacity();
+  buf.clear();
+  auto n = bela::StrAppendFormat(&buf, L"argc: %d", argc);
+  Check(L"after clear", buf, n, std::wstring_view(bela::StrFormat(L"argc: %d", argc)), true);
+  if (buf.capacity() != capacity) {
+    bela::FPrintF(stderr, L"FAIL clear changed capacity %d -> %d\n", capacity, buf.capacity());
+    failed++;
+  }
+  // empty output stays inline
+  bela::FormatBuffer<16> empty;
+  Check(L"empty", empty, bela::StrAppendFormat(&empty, L"%s", L""), std::wstring_view(), false);
+  // narrow, 31 32 and 33 bytes of UTF-8 against 32 inline bytes
+  for (size_t len : {31, 32, 33}) {
+    std::string text(len - 3, 'n');
+    bela::narrow::FormatBuffer<32> nbuf;
+    auto m = bela::narrow::StrAppendFormat(&nbuf, "%s\xE4\xB8\xAD", text);
+    Check(bela::StringCat(L"narrow ", len), nbuf, m, std::string_view(bela::narrow::StrFormat("%s\xE4\xB8\xAD", text)),
+          len > 32);
+  }
+  bela::FPrintF(stderr, L"formatbuffer: %d failed\n", failed);
+  if (argc < 2 || std::wstring_view(argv[1]) != L"--bench") {
+    return failed == 0 ? 0 : 1;
+  }
+  constexpr int N = 1000000;
+  size_t total = 0;
+  auto begin = std::chrono::steady_clock::now();
+  for (int i = 0; i < N; i++) {
+    total += bela::StrFormat(L"worker %d handled %s in %d ms", i, L"request", i % 100).size();
+  }
+  auto mid = std::chrono::steady_clock::now();
+  for (int i = 0; i < N; i++) {
+    bela::FormatBuffer<256> line;
+    total += bela::StrAppendFormat(&line, L"worker %d handled %s in %d ms", i, L"request", i % 100);
+  }
+  auto end = std::chrono::steady_clock::now();
+  std::chrono::duration<double, std::nano> d1 = mid - begin;
+  std::chrono::duration<double, std::nano> d2 = end - mid;
+  bela::FPrintF(stderr, L"std::wstring %d ns/op FormatBuffer %d ns/op (%d)\n", static_cast<int>(d1.count() / N),
+                static_cast<int>(d2.count() / N), total);
+  return failed == 0 ? 0 : 1;
+}
@@ -49,6 +49,8 @@ int wmain(int argc, wchar_t **argv) {
   bela::FPrintF(stderr, L"[%010d]\n", n2);
   double ddd = 000192.15777411;
   bela::FPrintF(stderr, L"[%08.7f]\n", ddd);
+  bela::FPrintF(stderr, L"[%f] [%.3e] [%g] [%v] [%012.3f] [%-10.2f] [%.2f]\n", ddd, ddd, 1e300, 0.1 + 0.2, -ddd, 0.05,
+                1e22);
   long xl = 18256444;
   bela::FPrintF(stderr, L"[%-16x]\n", xl);
   bela::FPrintF(stderr, L"[%016X]\n", xl);
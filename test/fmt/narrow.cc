@@ -0,0 +1,58 @@
+///
+#include <bela/terminal.hpp>
+#include <bela/narrow/fmt.hpp>
+
+int failed = 0;
+
+// Check narrow::StrFormat must equal ToNarrow of the wide StrFormat with the same format and arguments, so must
+// StrAppendFormat and the fixed buffer overloads
+template <typename... Args> void Check(const char *fmt, Args... args) {
+  const auto wfmt = bela::ToWide(fmt);
+  const auto want = bela::ToNarrow(bela::StrFormat(wfmt.data(), args...));
+  const auto got = bela::narrow::StrFormat(fmt, args...);
+  if (got != want) {
+    bela::FPrintF(stderr, L"FAIL '%s'\nnarrow: [%s]\nwide:   [%s]\n", fmt, got, want);
+    failed++;
+  }
+  std::string appended("prefix:");
+  bela::narrow::StrAppendFormat(&appended, fmt, args...);
+  if (appended != "prefix:" + want) {
+    bela::FPrintF(stderr, L"FAIL append '%s': [%s]\n", fmt, appended);
+    failed++;
+  }
+  char big[256];
+  auto n = bela::narrow::StrFormat(big, fmt, args...);
+  if (n != static_cast<bela::ssize_t>(want.size()) || want != std::string_view(big, want.size())) {
+    bela::FPrintF(stderr, L"FAIL buffer '%s': %d [%s]\n", fmt, n, std::string_view(big, n < 0 ? 0 : n));
+    failed++;
+  }
+  // -1 when the text doesn't fit, the wide overloads do the same
+  char small[8];
+  auto m = bela::narrow::StrFormat(small, fmt, args...);
+  if (want.size() < std::size(small) ? m != static_cast<bela::ssize_t>(want.size()) || want != small
+                                     : want.size() > std::size(small) && m != -1) {
+    bela::FPrintF(stderr, L"FAIL small buffer '%s': %d\n", fmt, m);
+    failed++;
+  }
+}
+
+int wmain(int argc, wchar_t **argv) {
+  const auto ux = "\xf0\x9f\x98\x81 UTF-8 text \xE3\x8D\xA4";
+  std::wstring wx(L"Engine (\xD83D\xDEE0) 中国 \U0001F496");
+  const std::u16string_view u16(u"UTF-16 é中");
+  char32_t em = 0x1F603;
+  int n = -1999;
+  Check("Argc: %d Arg0: %s W: %s UTF-8: %s emoji: %c %U", argc, argv[0], wx, ux, em, em);
+  Check("[%-10d] [%10d] [%010d] [%08x] [%X] %b %% %p", n, n, 2999, 0xBEEF, 0xBEEF, true, argv);
+  Check("%s|%s|%s|%d|%c", wx, ux, u16, n, em);
+  Check("[%12s] [%-12s] [%3s]", ux, wx, "toolong");
+  Check("%c%c%c %c|%c", 'a', L'é', u'中', em, L'x');
+  Check("%d %d %x %o %d", INT64_MAX, UINT64_MAX, static_cast<unsigned short>(0xFFFF), 8, static_cast<signed char>(-5));
+  Check("%f %.3f %e %g %10.2f|%-10.1f|", 3.5, 2.0 / 3, 1e-7, 1e21, -1.25, 0.05);
+  Check("%b %b %b", false, 0, 'y');
+  Check("no directives");
+  Check("%s", "");
+  Check("%d%%", 42);
+  bela::FPrintF(stderr, L"narrow: %d failed\n", failed);
+  return failed == 0 ? 0 : 1;
+}
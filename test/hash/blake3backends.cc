@@ -0,0 +1,68 @@
+// every blake3 backend the CPU can run must give the portable digest, on lengths around the 1024 byte chunk
+// and the power of two subtrees the SIMD kernels hash many chunks of at once
+#include <string>
+#include <vector>
+#include <bela/terminal.hpp>
+#include <bela/hash.hpp>
+
+using bela::hash::blake3::Backend;
+
+constexpr std::pair<Backend, std::wstring_view> backends[] = {{Backend::SSE2, L"SSE2"},
+                                                              {Backend::SSE41, L"SSE41"},
+                                                              {Backend::AVX2, L"AVX2"},
+                                                              {Backend::AVX512, L"AVX512"},
+                                                              {Backend::NEON, L"NEON"}};
+
+// one-shot, then split inside the first chunk so the hasher buffers a partial chunk, and a 100 byte XOF tail
+std::wstring Digests(const std::vector<uint8_t> &input, size_t n) {
+  std::wstring s;
+  for (size_t split : {n, n / 3}) {
+    bela::hash::blake3::Hasher h;
+    h.Initialize();
+    h.Update(input.data(), split);
+    h.Update(input.data() + split, n - split);
+    uint8_t out[100];
+    h.Finalize(out, sizeof(out));
+    bela::hash::HashEncode(out, sizeof(out), s);
+  }
+  return s;
+}
+
+int wmain() {
+  // i % 251 like the upstream test vectors
+  std::vector<uint8_t> input(65 * 1024 + 1);
+  for (size_t i = 0; i < input.size(); i++) {
+    input[i] = static_cast<uint8_t>(i % 251);
+  }
+  std::vector<size_t> lengths = {0, 1, 63, 64, 65, 127, 128, 129};
+  for (size_t chunks : {1, 2, 3, 4, 5, 7, 8, 9, 15, 16, 17, 31, 32, 33, 64, 65}) {
+    for (auto n : {chunks * 1024 - 1, chunks * 1024, chunks * 1024 + 1}) {
+      lengths.push_back(n);
+    }
+  }
+  int failed = 0;
+  if (!bela::hash::blake3::SetBackend(Backend::Portable)) {
+    bela::FPrintF(stderr, L"FAIL portable backend refused\n");
+    return 1;
+  }
+  std::vector<std::wstring> want;
+  for (auto n : lengths) {
+    want.push_back(Digests(input, n));
+  }
+  int tested = 0;
+  for (const auto &[backend, name] : backends) {
+    if (!bela::hash::blake3::SetBackend(backend)) {
+      continue;
+    }
+    tested++;
+    for (size_t i = 0; i < lengths.size(); i++) {
+      if (Digests(input, lengths[i]) != want[i]) {
+        bela::FPrintF(stderr, L"FAIL %s: %d bytes differ from portable\n", name, lengths[i]);
+        failed++;
+      }
+    }
+  }
+  bela::hash::blake3::SetBackend(Backend::Auto);
+  bela::FPrintF(stderr, L"blake3 backends: %d tested, %d failed\n", tested, failed);
+  return failed == 0 ? 0 : 1;
+}
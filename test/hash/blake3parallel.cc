@@ -0,0 +1,53 @@
+// blake3 UpdateParallel must produce the same digest as Update, and scale with the pool
+#include <chrono>
+#include <vector>
+#include <bela/terminal.hpp>
+#include <bela/hash.hpp>
+#include <bela/threadpool.hpp>
+#include "../testdata.hpp"
+
+int wmain() {
+  std::vector<uint8_t> buf(256 * 1024 * 1024 + 4567);
+  bela::test::Fill(buf);
+  auto &pool = bela::ThreadPool::Default();
+  constexpr size_t sizes[] = {0, 1, 1024, 1025, 256 * 1024 + 1, 3 * 1024 * 1024 + 17, 64 * 1024 * 1024};
+  // a partial chunk already buffered must not break subtree alignment
+  constexpr size_t prefixes[] = {0, 1, 5000};
+  int failed = 0;
+  for (auto n : sizes) {
+    for (auto pre : prefixes) {
+      if (pre > n) {
+        continue;
+      }
+      bela::hash::blake3::Hasher a;
+      bela::hash::blake3::Hasher b;
+      a.Initialize();
+      b.Initialize();
+      a.Update(buf.data(), n);
+      b.Update(buf.data(), pre);
+      b.UpdateParallel(buf.data() + pre, n - pre, pool);
+      if (a.Finalize() != b.Finalize()) {
+        bela::FPrintF(stderr, L"FAIL size %d prefix %d\n", n, pre);
+        failed++;
+      }
+    }
+  }
+  auto measure = [&](auto &&fn) {
+    auto begin = std::chrono::steady_clock::now();
+    fn();
+    std::chrono::duration<double> d = std::chrono::steady_clock::now() - begin;
+    return static_cast<double>(buf.size()) / d.count() / (1024 * 1024);
+  };
+  auto serial = measure([&] {
+    bela::hash::blake3::Hasher h;
+    h.Initialize();
+    h.Update(buf.data(), buf.size());
+  });
+  auto parallel = measure([&] {
+    bela::hash::blake3::Hasher h;
+    h.Initialize();
+    h.UpdateParallel(buf.data(), buf.size(), pool);
+  });
+  bela::FPrintF(stderr, L"serial %.0f MB/s, parallel (%d threads) %.0f MB/s\n", serial, pool.Size(), parallel);
+  return failed == 0 ? 0 : 1;
+}
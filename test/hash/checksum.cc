@@ -0,0 +1,50 @@
+// CRC32C/XXH64/XXH3 known answers, streaming must match one-shot
+#include <algorithm>
+#include <string>
+#include <bela/terminal.hpp>
+#include <bela/checksum.hpp>
+#include "../testdata.hpp"
+
+int wmain() {
+  int failed = 0;
+  auto expect = [&](std::wstring_view name, std::wstring_view got, std::wstring_view want) {
+    if (got != want) {
+      bela::FPrintF(stderr, L"%s: got %s want %s\n", name, got, want);
+      failed++;
+    }
+  };
+  bela::hash::crc32c::Hasher crc;
+  crc.Initialize();
+  crc.Update("123456789", 9);
+  expect(L"crc32c", crc.Finalize(), L"e3069283");
+  bela::hash::xxh64::Hasher x64;
+  x64.Initialize();
+  expect(L"xxh64", x64.Finalize(), L"ef46db3751d8e999");
+  bela::hash::xxh3::Hasher x3;
+  x3.Initialize();
+  expect(L"xxh3-64", x3.Finalize(), L"2d06800538d394c2");
+  x3.Initialize(bela::hash::xxh3::HashBits::XXH3_128);
+  expect(L"xxh3-128", x3.Finalize(), L"99aa06d3014798d86001c324468d497f");
+
+  std::string data(1024 * 1024 + 13, '\0');
+  bela::test::Fill(data);
+  for (size_t len : {size_t{0}, size_t{17}, size_t{240}, size_t{241}, size_t{100000}, data.size()}) {
+    crc.Initialize();
+    x64.Initialize(len);
+    x3.Initialize(bela::hash::xxh3::HashBits::XXH3_128, len);
+    for (size_t off = 0; off < len; off += 1000) {
+      auto n = (std::min)(len - off, size_t{1000});
+      crc.Update(data.data() + off, n);
+      x64.Update(data.data() + off, n);
+      x3.Update(data.data() + off, n);
+    }
+    if (crc.Value() != bela::hash::crc32c::Checksum(data.data(), len) ||
+        x64.Value() != bela::hash::xxh64::Hash(data.data(), len, len) ||
+        x3.Value128() != bela::hash::xxh3::Hash128(data.data(), len, len)) {
+      bela::FPrintF(stderr, L"streaming %d bytes: mismatch\n", len);
+      failed++;
+    }
+  }
+  bela::FPrintF(stderr, L"checksum: %d failed\n", failed);
+  return failed == 0 ? 0 : 1;
+}
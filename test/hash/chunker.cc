@@ -0,0 +1,43 @@
+// chunker file [previous-file]: print FastCDC chunks, with a second file report how many chunks are shared
+#include <unordered_set>
+#include <bela/terminal.hpp>
+#include <bela/chunker.hpp>
+
+int wmain(int argc, wchar_t **argv) {
+  if (argc < 2) {
+    bela::FPrintF(stderr, L"usage: %s file [previous-file]\n", argv[0]);
+    return 1;
+  }
+  bela::hash::Chunker chunker;
+  std::vector<bela::hash::Chunk> chunks;
+  bela::error_code ec;
+  if (!chunker.SplitFile(argv[1], chunks, ec)) {
+    bela::FPrintF(stderr, L"unable chunk %s: %s\n", argv[1], ec.message);
+    return 1;
+  }
+  for (const auto &c : chunks) {
+    bela::FPrintF(stdout, L"%s %d %d\n", c.digest.Hex(), c.offset, c.length);
+  }
+  if (argc < 3) {
+    return 0;
+  }
+  std::vector<bela::hash::Chunk> previous;
+  if (!chunker.SplitFile(argv[2], previous, ec)) {
+    bela::FPrintF(stderr, L"unable chunk %s: %s\n", argv[2], ec.message);
+    return 1;
+  }
+  std::unordered_set<std::wstring> known;
+  for (const auto &c : previous) {
+    known.insert(c.digest.Hex());
+  }
+  size_t shared = 0;
+  uint64_t shared_bytes = 0;
+  for (const auto &c : chunks) {
+    if (known.count(c.digest.Hex()) != 0) {
+      shared++;
+      shared_bytes += c.length;
+    }
+  }
+  bela::FPrintF(stderr, L"%d/%d chunks (%d bytes) shared with %s\n", shared, chunks.size(), shared_bytes, argv[2]);
+  return 0;
+}
@@ -0,0 +1,75 @@
+// streamed chunking against Split, boundaries independent of how the stream is fed, and a Chunker
+// destroyed with digests still in flight
+#include <string>
+#include <bela/terminal.hpp>
+#include <bela/chunker.hpp>
+#include <bela/threadpool.hpp>
+#include "../testdata.hpp"
+
+bool SameChunks(const std::vector<bela::hash::Chunk> &a, const std::vector<bela::hash::Chunk> &b) {
+  if (a.size() != b.size()) {
+    return false;
+  }
+  for (size_t i = 0; i < a.size(); i++) {
+    if (a[i].offset != b[i].offset || a[i].length != b[i].length || a[i].digest.Hex() != b[i].digest.Hex()) {
+      return false;
+    }
+  }
+  return true;
+}
+
+int wmain() {
+  std::string data(4 * 1024 * 1024 + 333, '\0');
+  bela::test::Fill(data);
+  // small chunks, thousands of digest tasks queued on a two thread pool
+  bela::ThreadPool pool(2);
+  bela::hash::ChunkerOptions options;
+  options.min_size = 256;
+  options.avg_size = 1024;
+  options.max_size = 4096;
+  options.pool = &pool;
+  int failed = 0;
+  bela::hash::Chunker splitter(options);
+  auto want = splitter.Split(data.data(), data.size());
+  // pieces below, at and above max_size: carried over, joined with the next call and scanned in place
+  for (size_t piece : {1000, 4095, 4096, 4097, 9000, 65536, 1000000}) {
+    bela::hash::Chunker chunker(options);
+    for (size_t pos = 0; pos < data.size(); pos += piece) {
+      chunker.Update(data.data() + pos, (std::min)(piece, data.size() - pos));
+    }
+    if (!SameChunks(chunker.Finalize(), want)) {
+      bela::FPrintF(stderr, L"FAIL %d byte updates differ from Split\n", piece);
+      failed++;
+    }
+  }
+  // uneven pieces, a chunk may start in the carry-over after several short calls
+  {
+    constexpr size_t pieces[] = {1, 4000, 3, 5000, 0, 12000, 95, 4096, 70000};
+    bela::hash::Chunker chunker(options);
+    for (size_t pos = 0, i = 0; pos < data.size(); i++) {
+      auto n = (std::min)(pieces[i % std::size(pieces)], data.size() - pos);
+      chunker.Update(data.data() + pos, n);
+      pos += n;
+    }
+    if (!SameChunks(chunker.Finalize(), want)) {
+      bela::FPrintF(stderr, L"FAIL uneven updates differ from Split\n");
+      failed++;
+    }
+  }
+  // destroyed mid-stream: the queued tasks still write digests, the chunks must outlive them
+  for (int i = 0; i < 16; i++) {
+    bela::hash::Chunker chunker(options);
+    chunker.Update(data.data(), data.size() / (i + 1));
+  }
+  // and a Chunker reused after Finalize starts from offset zero
+  bela::hash::Chunker chunker(options);
+  chunker.Update(data.data(), 12345);
+  chunker.Finalize();
+  chunker.Update(data.data(), data.size());
+  if (!SameChunks(chunker.Finalize(), want)) {
+    bela::FPrintF(stderr, L"FAIL reused chunker differs from Split\n");
+    failed++;
+  }
+  bela::FPrintF(stderr, L"chunker: %d chunks, %d failed\n", want.size(), failed);
+  return failed == 0 ? 0 : 1;
+}
@@ -0,0 +1,65 @@
+// compile-time SHA-256/BLAKE3 must agree with the runtime hashers and the upstream BLAKE3 test vectors
+#include <array>
+#include <bela/terminal.hpp>
+#include <bela/consthash.hpp>
+
+constexpr std::string_view schema = R"({"name": "bela", "version": 1, "fields": ["path", "size", "digest"]})";
+constexpr auto schema_sha256 = bela::hash::sha256::ConstexprHash(schema);
+constexpr auto schema_blake3 = bela::hash::blake3::ConstexprHash(schema);
+
+constexpr auto abc_sha256 = bela::hash::sha256::ConstexprHash("abc");
+static_assert(abc_sha256[0] == 0xba && abc_sha256[1] == 0x78 && abc_sha256[31] == 0xad, "SHA-256 'abc'");
+constexpr auto empty_blake3 = bela::hash::blake3::ConstexprHash("");
+static_assert(empty_blake3[0] == 0xaf && empty_blake3[1] == 0x13 && empty_blake3[31] == 0x62, "BLAKE3 ''");
+
+// upstream test_vectors.json inputs are i % 251, past 1024 bytes the chunk CVs go through the CV stack
+template <size_t N> constexpr std::array<uint8_t, N> vector_input() {
+  std::array<uint8_t, N> input{};
+  for (size_t i = 0; i < N; i++) {
+    input[i] = static_cast<uint8_t>(i % 251);
+  }
+  return input;
+}
+template <size_t N> constexpr auto vector_blake3() {
+  constexpr auto input = vector_input<N>();
+  return bela::hash::blake3::ConstexprHash(input.data(), input.size());
+}
+constexpr uint8_t unhex(char c) { return static_cast<uint8_t>(c <= '9' ? c - '0' : c - 'a' + 10); }
+constexpr bool equal_hex(const bela::hash::Digest<BLAKE3_OUT_LEN> &d, std::string_view hex) {
+  for (size_t i = 0; i < d.size(); i++) {
+    if (d[i] != ((unhex(hex[i * 2]) << 4) | unhex(hex[i * 2 + 1]))) {
+      return false;
+    }
+  }
+  return true;
+}
+static_assert(equal_hex(vector_blake3<1025>(), "d00278ae47eb27b34faecf67b4fe263f82d5412916c1ffd97c8cb7fb814b8444"),
+              "BLAKE3 1025 bytes, two chunks");
+static_assert(equal_hex(vector_blake3<2049>(), "5f4d72f40d7a5f82b15ca2b2e44b1de3c2ef86c426c95c1af0b6879522563030"),
+              "BLAKE3 2049 bytes, three chunks");
+static_assert(equal_hex(vector_blake3<4097>(), "9b4052b38f1c5fc8b1f9ff7ac7b27cd242487b3d890d15c96a1c25b8aa0fb995"),
+              "BLAKE3 4097 bytes, five chunks");
+
+int wmain() {
+  int failed = 0;
+  bela::hash::sha256::Hasher sh;
+  sh.Initialize();
+  sh.Update(schema.data(), schema.size());
+  bela::hash::sha256::Digest sd;
+  sh.Finalize(sd.data(), sd.size());
+  if (sd != schema_sha256) {
+    bela::FPrintF(stderr, L"sha256: runtime %s constexpr %s\n", sd.Hex(), schema_sha256.Hex());
+    failed++;
+  }
+  bela::hash::blake3::Hasher bh;
+  bh.Initialize();
+  bh.Update(schema.data(), schema.size());
+  bela::hash::Digest<BLAKE3_OUT_LEN> bd;
+  bh.Finalize(bd.data(), bd.size());
+  if (bd != schema_blake3) {
+    bela::FPrintF(stderr, L"blake3: runtime %s constexpr %s\n", bd.Hex(), schema_blake3.Hex());
+    failed++;
+  }
+  bela::FPrintF(stderr, L"consthash: %d failed\n", failed);
+  return failed == 0 ? 0 : 1;
+}
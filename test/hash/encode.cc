@@ -0,0 +1,58 @@
+// hex/base64 digest encoding: vector kernels against the scalar reference, RFC 4648 vectors
+#include <string>
+#include <unordered_set>
+#include <bela/terminal.hpp>
+#include <bela/hash.hpp>
+
+constexpr std::pair<std::string_view, std::wstring_view> base64_vectors[] = {
+    {"", L""},           {"f", L"Zg=="},        {"fo", L"Zm8="},        {"foo", L"Zm9v"},
+    {"foob", L"Zm9vYg=="}, {"fooba", L"Zm9vYmE="}, {"foobar", L"Zm9vYmFy"},
+};
+
+constexpr bela::hash::Digest<4> d1{{1, 2, 3, 4}};
+constexpr bela::hash::Digest<4> d2{{1, 2, 3, 5}};
+static_assert(d1 != d2 && d1 < d2 && d1.Hash() == 0x04030201);
+
+int wmain() {
+  int failed = 0;
+  uint8_t buf[256];
+  for (size_t i = 0; i < sizeof(buf); i++) {
+    buf[i] = static_cast<uint8_t>(i * 131 + 7);
+  }
+  constexpr char hex[] = "0123456789abcdef";
+  for (size_t n = 0; n <= sizeof(buf); n++) {
+    std::string expected;
+    for (size_t i = 0; i < n; i++) {
+      expected.push_back(hex[buf[i] >> 4]);
+      expected.push_back(hex[buf[i] & 0xf]);
+    }
+    std::string s(bela::hash::HexEncodedLength(n), '?');
+    std::wstring w(bela::hash::HexEncodedLength(n), L'?');
+    bela::hash::EncodeHex(buf, n, s.data());
+    bela::hash::EncodeHex(buf, n, w.data());
+    if (s != expected || w != std::wstring(expected.begin(), expected.end())) {
+      bela::FPrintF(stderr, L"hex %d bytes: mismatch\n", n);
+      failed++;
+    }
+  }
+  for (const auto &[input, expected] : base64_vectors) {
+    std::wstring w(bela::hash::Base64EncodedLength(input.size()), L'?');
+    bela::hash::EncodeBase64(reinterpret_cast<const uint8_t *>(input.data()), input.size(), w.data());
+    if (w != expected) {
+      bela::FPrintF(stderr, L"base64 '%s': got %s want %s\n", input, w, expected);
+      failed++;
+    }
+  }
+  std::unordered_set<bela::hash::sha256::Digest> set;
+  bela::hash::sha256::Digest d;
+  set.insert(d);
+  d[0] = 1;
+  set.insert(d);
+  set.insert(d);
+  if (set.size() != 2) {
+    bela::FPrintF(stderr, L"Digest hash set: %d entries\n", set.size());
+    failed++;
+  }
+  bela::FPrintF(stderr, L"encode: %d failed\n", failed);
+  return failed == 0 ? 0 : 1;
+}
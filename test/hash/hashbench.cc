@@ -0,0 +1,219 @@
+// bela_hash_bench: belahash throughput as JSON
+//   bela_hash_bench [--max-size=bytes] [--min-time=ms] [--algorithm=SHA256]
+// modes: oneshot   Initialize/Update(whole message)/Finalize
+//        streaming message fed in 16KB Update calls (sizes above 16KB only)
+//        threaded  BLAKE3 UpdateParallel, other algorithms one message per pool thread (aggregate GB/s)
+// cpb is TSC ticks per byte, TSC runs at the nominal frequency rather than the boosted core clock.
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <vector>
+#include <bela/terminal.hpp>
+#include <bela/numbers.hpp>
+#include <bela/match.hpp>
+#include <bela/hash.hpp>
+#include <bela/threadpool.hpp>
+#include "../testdata.hpp"
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <x86intrin.h>
+#endif
+#define BENCH_HAVE_TSC 1
+#endif
+
+using bela::hash::Algorithm;
+
+namespace {
+constexpr size_t streaming_chunk = 16 * 1024;
+
+struct Options {
+  uint64_t max_size{1024ull * 1024 * 1024};
+  uint64_t min_time_ms{200};
+  std::wstring_view algorithm;
+};
+
+struct Sample {
+  uint64_t bytes{0};
+  double seconds{0};
+  uint64_t ticks{0};
+};
+
+inline uint64_t ReadTicks() {
+#if defined(BENCH_HAVE_TSC)
+  return __rdtsc();
+#else
+  return 0;
+#endif
+}
+
+// run fn repeatedly until min_time elapsed, fn returns the bytes it hashed
+template <typename Fn> Sample Measure(const Options &opt, Fn &&fn) {
+  Sample s;
+  auto begin = std::chrono::steady_clock::now();
+  auto ticks = ReadTicks();
+  for (;;) {
+    s.bytes += fn();
+    std::chrono::duration<double> d = std::chrono::steady_clock::now() - begin;
+    if (d.count() * 1000 >= static_cast<double>(opt.min_time_ms)) {
+      s.seconds = d.count();
+      break;
+    }
+  }
+  s.ticks = ReadTicks() - ticks;
+  return s;
+}
+
+bool first_result = true;
+
+void Emit(Algorithm a, std::wstring_view backend, std::wstring_view mode, size_t size, size_t threads,
+          const Sample &s) {
+  auto gbps = static_cast<double>(s.bytes) / s.seconds / 1e9;
+  bela::FPrintF(stdout,
+                L"%s\n    {\"algorithm\": \"%s\", \"backend\": \"%s\", \"mode\": \"%s\", \"size\": %d, \"threads\": %d, "
+                L"\"bytes\": %d, \"seconds\": %.6f, \"gbps\": %.4f",
+                first_result ? L"" : L",", bela::hash::AlgorithmName(a), backend, mode, size, threads, s.bytes,
+                s.seconds, gbps);
+#if defined(BENCH_HAVE_TSC)
+  bela::FPrintF(stdout, L", \"cpb\": %.3f}", static_cast<double>(s.ticks) / static_cast<double>(s.bytes));
+#else
+  bela::FPrintF(stdout, L", \"cpb\": null}");
+#endif
+  first_result = false;
+}
+
+void BenchSize(Algorithm a, std::wstring_view backend, const uint8_t *data, size_t size, const Options &opt,
+               bela::ThreadPool &pool) {
+  uint8_t digest[bela::hash::max_digest_length];
+  Emit(a, backend, L"oneshot", size, 1, Measure(opt, [&]() -> uint64_t {
+         bela::hash::AnyHasher h(a);
+         h.Update(data, size);
+         h.Finalize(digest, h.DigestLength());
+         return size;
+       }));
+  if (size > streaming_chunk) {
+    Emit(a, backend, L"streaming", size, 1, Measure(opt, [&]() -> uint64_t {
+           bela::hash::AnyHasher h(a);
+           for (size_t off = 0; off < size; off += streaming_chunk) {
+             h.Update(data + off, (std::min)(streaming_chunk, size - off));
+           }
+           h.Finalize(digest, h.DigestLength());
+           return size;
+         }));
+  }
+  if (pool.Size() < 2) {
+    return;
+  }
+  if (a == Algorithm::BLAKE3) {
+    // tree parallelism only pays off on large inputs
+    if (size >= 1024 * 1024) {
+      Emit(a, backend, L"threaded", size, pool.Size(), Measure(opt, [&]() -> uint64_t {
+             bela::hash::blake3::Hasher h;
+             h.Initialize();
+             h.UpdateParallel(data, size, pool);
+             h.Finalize(digest, BLAKE3_OUT_LEN);
+             return size;
+           }));
+    }
+    return;
+  }
+  Emit(a, backend, L"threaded", size, pool.Size(), Measure(opt, [&]() -> uint64_t {
+         bela::TaskGroup g(pool);
+         for (size_t i = 0; i < pool.Size(); i++) {
+           g.Run([&] {
+             uint8_t d[bela::hash::max_digest_length];
+             bela::hash::AnyHasher h(a);
+             h.Update(data, size);
+             h.Finalize(d, h.DigestLength());
+           });
+         }
+         g.Wait();
+         return static_cast<uint64_t>(size) * pool.Size();
+       }));
+}
+
+void BenchAlgorithm(Algorithm a, std::wstring_view backend, const uint8_t *data, const Options &opt,
+                    bela::ThreadPool &pool) {
+  for (uint64_t size = 16; size <= opt.max_size; size *= 4) {
+    BenchSize(a, backend, data, static_cast<size_t>(size), opt, pool);
+  }
+}
+
+bool ParseOptions(int argc, wchar_t **argv, Options &opt) {
+  for (int i = 1; i < argc; i++) {
+    std::wstring_view arg(argv[i]);
+    auto value = [&](std::wstring_view prefix) { return arg.substr(prefix.size()); };
+    if (bela::StartsWith(arg, L"--max-size=")) {
+      if (!bela::SimpleAtoi(value(L"--max-size="), &opt.max_size) || opt.max_size < 16) {
+        return false;
+      }
+      continue;
+    }
+    if (bela::StartsWith(arg, L"--min-time=")) {
+      if (!bela::SimpleAtoi(value(L"--min-time="), &opt.min_time_ms)) {
+        return false;
+      }
+      continue;
+    }
+    if (bela::StartsWith(arg, L"--algorithm=")) {
+      opt.algorithm = value(L"--algorithm=");
+      continue;
+    }
+    return false;
+  }
+  return true;
+}
+} // namespace
+
+int wmain(int argc, wchar_t **argv) {
+  Options opt;
+  if (!ParseOptions(argc, argv, opt)) {
+    bela::FPrintF(stderr, L"usage: %s [--max-size=bytes] [--min-time=ms] [--algorithm=name]\n", argv[0]);
+    return 1;
+  }
+  // sizes are powers of 4 from 16B: 16 64 256 ... 256MB 1GB
+  auto buffer = std::make_unique<uint8_t[]>(static_cast<size_t>(opt.max_size));
+  bela::test::Fill(buffer.get(), static_cast<size_t>(opt.max_size));
+  auto &pool = bela::ThreadPool::Default();
+  constexpr Algorithm algorithms[] = {Algorithm::SHA224,   Algorithm::SHA256,   Algorithm::SHA384,   Algorithm::SHA512,
+                                      Algorithm::SHA3_224, Algorithm::SHA3_256, Algorithm::SHA3_384, Algorithm::SHA3_512,
+                                      Algorithm::SM3,      Algorithm::BLAKE3};
+  using sha256_backend = bela::hash::sha256::Backend;
+  constexpr std::pair<sha256_backend, std::wstring_view> sha256_backends[] = {
+      {sha256_backend::Portable, L"portable"}, {sha256_backend::AVX2, L"avx2"}, {sha256_backend::SHANI, L"sha-ni"}};
+  using blake3_backend = bela::hash::blake3::Backend;
+  constexpr std::pair<blake3_backend, std::wstring_view> blake3_backends[] = {
+      {blake3_backend::Portable, L"portable"}, {blake3_backend::SSE2, L"sse2"},     {blake3_backend::SSE41, L"sse41"},
+      {blake3_backend::AVX2, L"avx2"},         {blake3_backend::AVX512, L"avx512"}, {blake3_backend::NEON, L"neon"}};
+
+  bela::FPrintF(stdout, L"{\n  \"version\": 1,\n  \"threads\": %d,\n  \"max_size\": %d,\n  \"results\": [", pool.Size(),
+                opt.max_size);
+  for (auto a : algorithms) {
+    if (!opt.algorithm.empty() && opt.algorithm != bela::hash::AlgorithmName(a)) {
+      continue;
+    }
+    bela::FPrintF(stderr, L"bench %s\n", bela::hash::AlgorithmName(a));
+    if (a == Algorithm::SHA224 || a == Algorithm::SHA256) {
+      for (const auto &[b, name] : sha256_backends) {
+        if (bela::hash::sha256::SetBackend(b)) {
+          BenchAlgorithm(a, name, buffer.get(), opt, pool);
+        }
+      }
+      bela::hash::sha256::SetBackend(sha256_backend::Auto);
+      continue;
+    }
+    if (a == Algorithm::BLAKE3) {
+      for (const auto &[b, name] : blake3_backends) {
+        if (bela::hash::blake3::SetBackend(b)) {
+          BenchAlgorithm(a, name, buffer.get(), opt, pool);
+        }
+      }
+      bela::hash::blake3::SetBackend(blake3_backend::Auto);
+      continue;
+    }
+    BenchAlgorithm(a, L"default", buffer.get(), opt, pool);
+  }
+  bela::FPrintF(stdout, L"\n  ]\n}\n");
+  return 0;
+}
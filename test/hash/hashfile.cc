@@ -0,0 +1,86 @@
+// HashFile mapped and streamed reads against a one-shot hash of the same bytes, empty file and error paths
+#include <string>
+#include <bela/terminal.hpp>
+#include <bela/hashfile.hpp>
+#include <bela/io.hpp>
+#include <bela/fs.hpp>
+#include "../testdata.hpp"
+
+using bela::hash::Algorithm;
+
+constexpr Algorithm algorithms[] = {Algorithm::SHA256, Algorithm::BLAKE3, Algorithm::SHA3_512, Algorithm::SHA256};
+constexpr std::pair<bela::hash::ReadMode, std::wstring_view> modes[] = {
+    {bela::hash::ReadMode::Auto, L"auto"},
+    {bela::hash::ReadMode::Mapped, L"mapped"},
+    {bela::hash::ReadMode::Streamed, L"streamed"}};
+
+int check(std::wstring_view file, const std::string &data) {
+  int failed = 0;
+  for (const auto &[mode, name] : modes) {
+    bela::hash::HashFileOptions options;
+    options.mode = mode;
+    options.buffer_size = 1; // rounded up to one 64KB buffer, the file spans several
+    bela::error_code ec;
+    std::vector<bela::hash::FileDigest> digests;
+    if (!bela::hash::HashFile(file, algorithms, digests, ec, options)) {
+      bela::FPrintF(stderr, L"%s %d bytes: FAIL HashFile: %s\n", name, data.size(), ec.message);
+      failed++;
+      continue;
+    }
+    // the duplicate SHA256 is ignored
+    if (digests.size() != std::size(algorithms) - 1) {
+      bela::FPrintF(stderr, L"%s %d bytes: FAIL %d digests\n", name, data.size(), digests.size());
+      failed++;
+      continue;
+    }
+    for (size_t i = 0; i < digests.size(); i++) {
+      bela::hash::AnyHasher h(algorithms[i]);
+      h.Update(data.data(), data.size());
+      auto want = h.Finalize();
+      if (digests[i].algorithm != algorithms[i] || digests[i].Hex() != want) {
+        bela::FPrintF(stderr, L"%s %d bytes: FAIL %s: %s want %s\n", name, data.size(),
+                      bela::hash::AlgorithmName(algorithms[i]), digests[i].Hex(), want);
+        failed++;
+      }
+    }
+  }
+  return failed;
+}
+
+int wmain() {
+  constexpr std::wstring_view file = L"hashfile_test.bin";
+  constexpr size_t buffer = 64 * 1024;
+  // empty, shorter than a buffer, exactly two buffers (the last read returns nothing) and a partial third
+  constexpr size_t sizes[] = {0, 1000, 2 * buffer, 3 * buffer + 12345};
+  std::string data(sizes[std::size(sizes) - 1], '\0');
+  bela::test::Fill(data);
+  int failed = 0;
+  for (auto size : sizes) {
+    auto part = data.substr(0, size);
+    bela::error_code ec;
+    if (!bela::io::WriteText(part, file, ec)) {
+      bela::FPrintF(stderr, L"write %s: %s\n", file, ec.message);
+      return 1;
+    }
+    failed += check(file, part);
+  }
+  bela::error_code ec;
+  bela::fs::Remove(file, ec);
+  // error paths: no algorithm, missing file
+  std::vector<bela::hash::FileDigest> digests;
+  if (bela::hash::HashFile(file, {}, digests, ec) || !ec) {
+    bela::FPrintF(stderr, L"FAIL HashFile without algorithms succeeded\n");
+    failed++;
+  }
+  ec = {};
+  if (bela::hash::HashFile(file, algorithms, digests, ec) || !ec) {
+    bela::FPrintF(stderr, L"FAIL HashFile of a missing file succeeded\n");
+    failed++;
+  }
+  if (auto d = bela::hash::HashFile(L"hashfile_test_missing.bin", algorithms, ec); d) {
+    bela::FPrintF(stderr, L"FAIL optional HashFile of a missing file succeeded\n");
+    failed++;
+  }
+  bela::FPrintF(stderr, L"hashfile: %d failed\n", failed);
+  return failed == 0 ? 0 : 1;
+}
@@ -0,0 +1,66 @@
+// checkpoint every hasher halfway, resume from the saved state and compare with a straight run
+#include <string>
+#include <bela/terminal.hpp>
+#include <bela/hash.hpp>
+#include "../testdata.hpp"
+
+using bela::hash::Algorithm;
+using bela::hash::StateStatus;
+
+int wmain() {
+  std::string data(1024 * 1024 + 77, '\0');
+  bela::test::Fill(data);
+  constexpr Algorithm algorithms[] = {Algorithm::SHA224,   Algorithm::SHA256,   Algorithm::SHA384,   Algorithm::SHA512,
+                                      Algorithm::SHA3_224, Algorithm::SHA3_256, Algorithm::SHA3_384, Algorithm::SHA3_512,
+                                      Algorithm::BLAKE3,   Algorithm::SM3};
+  constexpr size_t cuts[] = {0, 1, 63, 64, 65, 1025, 65536, 777777};
+  int failed = 0;
+  for (auto a : algorithms) {
+    bela::hash::AnyHasher straight(a);
+    straight.Update(data.data(), data.size());
+    auto want = straight.Finalize();
+    for (auto cut : cuts) {
+      bela::hash::AnyHasher h(a);
+      h.Update(data.data(), cut);
+      auto state = h.SaveState();
+      bela::hash::AnyHasher resumed;
+      if (auto status = resumed.RestoreState(state); status != StateStatus::Ok) {
+        bela::FPrintF(stderr, L"%s cut %d: status %d\n", bela::hash::AlgorithmName(a), cut, static_cast<int>(status));
+        failed++;
+        continue;
+      }
+      resumed.Update(data.data() + cut, data.size() - cut);
+      if (auto got = resumed.Finalize(); got != want) {
+        bela::FPrintF(stderr, L"%s cut %d: %s want %s\n", bela::hash::AlgorithmName(a), cut, got, want);
+        failed++;
+      }
+      if (resumed.RestoreState(state.substr(0, state.size() - 1)) != StateStatus::Corrupt ||
+          resumed.RestoreState(state + '\0') != StateStatus::Corrupt) {
+        bela::FPrintF(stderr, L"%s cut %d: truncated or padded state accepted\n", bela::hash::AlgorithmName(a), cut);
+        failed++;
+      }
+    }
+  }
+  // header checks: magic, version, algorithm id, and a typed hasher handed another algorithm's state
+  bela::hash::sha256::Hasher sha256;
+  sha256.Initialize();
+  auto state = sha256.SaveState();
+  bela::hash::sha3::Hasher sha3;
+  sha3.Initialize();
+  auto bad_magic = state;
+  bad_magic[0] = 'X';
+  auto bad_version = state;
+  bad_version[3]++;
+  auto bad_algorithm = state;
+  bad_algorithm[4] = 0x7F;
+  if (sha3.RestoreState(state) != StateStatus::WrongAlgorithm ||
+      sha256.RestoreState(bad_magic) != StateStatus::NotState ||
+      sha256.RestoreState(bad_version) != StateStatus::UnsupportedVersion ||
+      sha256.RestoreState(bad_algorithm) != StateStatus::WrongAlgorithm ||
+      sha256.RestoreState(std::string_view()) != StateStatus::NotState) {
+    bela::FPrintF(stderr, L"state header checks failed\n");
+    failed++;
+  }
+  bela::FPrintF(stderr, L"hashstate: %d failed\n", failed);
+  return failed == 0 ? 0 : 1;
+}
@@ -0,0 +1,86 @@
+// feed one buffer to MultiHasher in uneven pieces and compare every digest with the individual hasher
+#include <cstring>
+#include <string>
+#include <bela/terminal.hpp>
+#include <bela/multihash.hpp>
+#include <bela/threadpool.hpp>
+#include "../testdata.hpp"
+
+using bela::hash::Algorithm;
+
+int wmain() {
+  std::string data(3 * 4096 + 1234, '\0');
+  bela::test::Fill(data);
+  constexpr Algorithm algorithms[] = {Algorithm::SHA224,   Algorithm::SHA256,   Algorithm::SHA384,   Algorithm::SHA512,
+                                      Algorithm::SHA3_224, Algorithm::SHA3_256, Algorithm::SHA3_384, Algorithm::SHA3_512,
+                                      Algorithm::BLAKE3,   Algorithm::SM3};
+  // pieces smaller than, equal to and straddling the 4096 byte block, the last one takes the rest
+  constexpr size_t pieces[] = {1, 7, 4088, 4096, 0, 4097, 63};
+  // the default pool, and a single worker so the producer runs queued blocks itself while it waits
+  bela::ThreadPool single(1);
+  bela::ThreadPool *pools[] = {nullptr, &single};
+  constexpr const wchar_t *modes[] = {L"update", L"acquire", L"in place"};
+  int failed = 0;
+  for (auto pool : pools) {
+    for (int mode = 0; mode < 3; mode++) {
+      bela::hash::MultiHasher mh;
+      if (!mh.Initialize(algorithms, 4096, pool) || mh.Size() != std::size(algorithms)) {
+        bela::FPrintF(stderr, L"pool %d: Initialize FAIL\n", pool == nullptr ? 0 : 1);
+        failed++;
+        continue;
+      }
+      size_t pos = 0;
+      for (size_t i = 0; pos < data.size(); i++) {
+        auto n = i < std::size(pieces) ? pieces[i] : data.size() - pos;
+        n = (std::min)(n, data.size() - pos);
+        if (mode == 0) {
+          mh.Update(data.data() + pos, n);
+          pos += n;
+          continue;
+        }
+        // in place pieces interleave with copied blocks, both must keep the byte order
+        if (mode == 2 && i % 2 == 0) {
+          mh.UpdateInPlace(data.data() + pos, n);
+          pos += n;
+          continue;
+        }
+        // Acquire may return less than asked for, loop until the piece is in
+        for (auto end = pos + n; pos < end;) {
+          size_t capacity = 0;
+          auto p = mh.Acquire(capacity);
+          auto m = (std::min)(capacity, end - pos);
+          memcpy(p, data.data() + pos, m);
+          mh.Commit(m);
+          pos += m;
+        }
+      }
+      mh.Finalize();
+      for (auto a : algorithms) {
+        bela::hash::AnyHasher h(a);
+        h.Update(data.data(), data.size());
+        uint8_t want[bela::hash::max_digest_length];
+        h.Finalize(want, h.DigestLength());
+        uint8_t got[bela::hash::max_digest_length];
+        auto len = mh.Digest(a, got, sizeof(got));
+        if (len != h.DigestLength() || memcmp(got, want, len) != 0) {
+          bela::FPrintF(stderr, L"pool %d %s: FAIL %s: %s\n", pool == nullptr ? 0 : 1, modes[mode],
+                        bela::hash::AlgorithmName(a), mh.Digest(a));
+          failed++;
+        }
+      }
+    }
+  }
+  // an algorithm not selected has no digest
+  bela::hash::MultiHasher mh;
+  constexpr Algorithm one[] = {Algorithm::SHA256, Algorithm::SHA256};
+  mh.Initialize(one, 4096);
+  mh.Update(data.data(), data.size());
+  mh.Finalize();
+  uint8_t out[bela::hash::max_digest_length];
+  if (mh.Size() != 1 || mh.Digest(Algorithm::BLAKE3, out, sizeof(out)) != 0) {
+    bela::FPrintF(stderr, L"FAIL duplicate/unselected algorithm\n");
+    failed++;
+  }
+  bela::FPrintF(stderr, L"multihash: %d failed\n", failed);
+  return failed == 0 ? 0 : 1;
+}
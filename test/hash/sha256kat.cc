@@ -0,0 +1,54 @@
+// SHA-256 known-answer tests, run against every backend the CPU supports
+#include <bela/terminal.hpp>
+#include <bela/hash.hpp>
+
+struct kat_t {
+  std::string_view input;
+  size_t repeat;
+  bela::hash::sha256::HashBits hb;
+  std::wstring_view digest;
+};
+
+constexpr kat_t kats[] = {
+    {"", 1, bela::hash::sha256::HashBits::SHA256, L"e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855"},
+    {"abc", 1, bela::hash::sha256::HashBits::SHA256,
+     L"ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad"},
+    {"abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq", 1, bela::hash::sha256::HashBits::SHA256,
+     L"248d6a61d20638b8e5c026930c3e6039a33ce45964ff2167f6ecedd419db06c1"},
+    {"a", 1000000, bela::hash::sha256::HashBits::SHA256,
+     L"cdc76e5c9914fb9281a1c7e284d73e67f1809a48a497200e046d39ccc7112cd0"},
+    {"abc", 1, bela::hash::sha256::HashBits::SHA224, L"23097d223405d8228642a477bda255b32aadbce4bda0b3f7e36c9da7"},
+};
+
+int wmain() {
+  using bela::hash::sha256::Backend;
+  constexpr std::pair<Backend, std::wstring_view> backends[] = {
+      {Backend::Portable, L"portable"}, {Backend::AVX2, L"avx2"}, {Backend::SHANI, L"sha-ni"}};
+  int failed = 0;
+  for (const auto &[b, name] : backends) {
+    if (!bela::hash::sha256::SetBackend(b)) {
+      bela::FPrintF(stderr, L"backend %s: unsupported, skip\n", name);
+      continue;
+    }
+    for (const auto &k : kats) {
+      bela::hash::sha256::Hasher h;
+      h.Initialize(k.hb);
+      if (k.repeat == 1) {
+        h.Update(k.input.data(), k.input.size());
+      } else {
+        std::string block(1000, k.input[0]);
+        for (size_t i = 0; i < k.repeat / block.size(); i++) {
+          h.Update(block.data(), block.size());
+        }
+      }
+      auto digest = h.Finalize();
+      if (digest != k.digest) {
+        bela::FPrintF(stderr, L"backend %s: FAIL '%s' x%d: %s\n", name, k.input, k.repeat, digest);
+        failed++;
+      }
+    }
+    bela::FPrintF(stderr, L"backend %s: done\n", name);
+  }
+  bela::hash::sha256::SetBackend(Backend::Auto);
+  return failed == 0 ? 0 : 1;
+}
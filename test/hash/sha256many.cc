@@ -0,0 +1,107 @@
+// sha256::HashMany vs per-message Initialize/Update/Finalize, mixed lengths in one batch for SHA224 and SHA256,
+// then with --bench the throughput of equal length batches
+#include <chrono>
+#include <cstring>
+#include <random>
+#include <vector>
+#include <bela/terminal.hpp>
+#include <bela/hash.hpp>
+
+using bela::hash::sha256::HashBits;
+
+// lengths around the 55/56 byte padding split and the 64 byte block, one batch holds all of them
+constexpr size_t lengths[] = {0, 1, 55, 56, 57, 63, 64, 65, 119, 120, 127, 128, 129, 1000, 4096};
+
+int Check(const std::vector<uint8_t> &pool, size_t count, HashBits hb) {
+  std::vector<bela::Span<const uint8_t>> messages;
+  for (size_t i = 0; i < count; i++) {
+    // rotate the start so equal lengths don't hash equal bytes
+    messages.emplace_back(pool.data() + i, lengths[i % std::size(lengths)]);
+  }
+  std::vector<bela::hash::sha256::Digest> many(count);
+  bela::hash::sha256::HashMany(messages, bela::MakeSpan(many), hb);
+  const size_t size = hb == HashBits::SHA224 ? bela::hash::sha256::sha224_hash_size
+                                             : bela::hash::sha256::sha256_hash_size;
+  int failed = 0;
+  for (size_t i = 0; i < count; i++) {
+    bela::hash::sha256::Hasher h;
+    h.Initialize(hb);
+    h.Update(messages[i].data(), messages[i].size());
+    uint8_t want[bela::hash::sha256::sha256_hash_size];
+    h.Finalize(want, size);
+    if (memcmp(many[i].data(), want, size) != 0) {
+      bela::FPrintF(stderr, L"FAIL SHA%d batch of %d: message %d (%d bytes) MISMATCH\n", static_cast<int>(hb), count,
+                    i, messages[i].size());
+      failed++;
+    }
+  }
+  return failed;
+}
+
+void Bench(std::mt19937 &gen) {
+  for (size_t msgsize : {32, 64, 256, 1024, 4096}) {
+    constexpr size_t count = 100000;
+    std::vector<uint8_t> pool(msgsize * count);
+    for (auto &c : pool) {
+      c = static_cast<uint8_t>(gen());
+    }
+    std::vector<bela::Span<const uint8_t>> messages;
+    for (size_t i = 0; i < count; i++) {
+      messages.emplace_back(pool.data() + i * msgsize, msgsize);
+    }
+    std::vector<bela::hash::sha256::Digest> many(count);
+    std::vector<bela::hash::sha256::Digest> loop(count);
+    auto t0 = std::chrono::steady_clock::now();
+    bela::hash::sha256::HashMany(messages, bela::MakeSpan(many));
+    auto t1 = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < count; i++) {
+      bela::hash::sha256::Hasher h;
+      h.Initialize();
+      h.Update(messages[i].data(), messages[i].size());
+      h.Finalize(loop[i].data(), loop[i].size());
+    }
+    auto t2 = std::chrono::steady_clock::now();
+    auto manyms = std::chrono::duration<double, std::milli>(t1 - t0).count();
+    auto loopms = std::chrono::duration<double, std::milli>(t2 - t1).count();
+    bela::FPrintF(stderr, L"%d x %d bytes: HashMany %.2fms loop %.2fms speedup %.2f\n", count, msgsize, manyms,
+                  loopms, loopms / manyms);
+  }
+}
+
+int wmain(int argc, wchar_t **argv) {
+  std::mt19937 gen(2020);
+  std::vector<uint8_t> pool(4096 + 64);
+  for (auto &c : pool) {
+    c = static_cast<uint8_t>(gen());
+  }
+  int failed = 0;
+  // batches below, at and past the 8 and 16 lane widths, the last one cycles every length twice
+  constexpr size_t counts[] = {1, 7, 8, 9, 16, 17, 2 * std::size(lengths) + 1};
+  for (auto count : counts) {
+    failed += Check(pool, count, HashBits::SHA256);
+    failed += Check(pool, count, HashBits::SHA224);
+  }
+  // digests shorter than messages: only the first digests.size() messages are hashed
+  {
+    std::vector<bela::Span<const uint8_t>> messages(9, bela::Span<const uint8_t>(pool.data(), 65));
+    std::vector<bela::hash::sha256::Digest> digests(4);
+    bela::hash::sha256::HashMany(messages, bela::MakeSpan(digests));
+    bela::hash::sha256::Hasher h;
+    h.Initialize();
+    h.Update(pool.data(), 65);
+    bela::hash::sha256::Digest want;
+    h.Finalize(want.data(), want.size());
+    for (const auto &d : digests) {
+      if (d != want) {
+        bela::FPrintF(stderr, L"FAIL short digests span MISMATCH\n");
+        failed++;
+      }
+    }
+  }
+  bela::FPrintF(stderr, L"sha256many: %d failed\n", failed);
+  if (argc < 2 || std::wstring_view(argv[1]) != L"--bench") {
+    return failed == 0 ? 0 : 1;
+  }
+  Bench(gen);
+  return failed == 0 ? 0 : 1;
+}
@@ -0,0 +1,115 @@
+// SHA-3 known-answer tests (FIPS 202) and sha3::HashMany against the one message at a time Hasher
+#include <cstring>
+#include <random>
+#include <vector>
+#include <bela/terminal.hpp>
+#include <bela/hash.hpp>
+
+using bela::hash::sha3::HashBits;
+
+struct kat_t {
+  std::string_view input;
+  size_t repeat;
+  HashBits hb;
+  std::wstring_view digest;
+};
+
+// 112 bytes, more than one block for SHA3-384 (104 byte rate) and SHA3-512 (72 byte rate)
+constexpr std::string_view msg896 =
+    "abcdefghbcdefghicdefghijdefghijkefghijklfghijklmghijklmnhijklmnoijklmnopjklmnopqklmnopqrlmnopqrsmnopqrstnopqrstu";
+
+constexpr kat_t kats[] = {
+    {"", 1, HashBits::SHA3224, L"6b4e03423667dbb73b6e15454f0eb1abd4597f9a1b078e3f5b5a6bc7"},
+    {"", 1, HashBits::SHA3256, L"a7ffc6f8bf1ed76651c14756a061d662f580ff4de43b49fa82d80a4b80f8434a"},
+    {"", 1, HashBits::SHA3384,
+     L"0c63a75b845e4f7d01107d852e4c2485c51a50aaaa94fc61995e71bbee983a2ac3713831264adb47fb6bd1e058d5f004"},
+    {"", 1, HashBits::SHA3512,
+     L"a69f73cca23a9ac5c8b567dc185a756e97c982164fe25859e0d1dcc1475c80a615b2123af1f5f94c11e3e9402c3ac558f500199d95b6d3e3"
+     L"01758586281dcd26"},
+    {"abc", 1, HashBits::SHA3224, L"e642824c3f8cf24ad09234ee7d3c766fc9a3a5168d0c94ad73b46fdf"},
+    {"abc", 1, HashBits::SHA3256, L"3a985da74fe225b2045c172d6bd390bd855f086e3e9d525b46bfe24511431532"},
+    {"abc", 1, HashBits::SHA3384,
+     L"ec01498288516fc926459f58e2c6ad8df9b473cb0fc08c2596da7cf0e49be4b298d88cea927ac7f539f1edf228376d25"},
+    {"abc", 1, HashBits::SHA3512,
+     L"b751850b1a57168a5693cd924b6b096e08f621827444f70d884f5d0240d2712e10e116e9192af3c91a7ec57647e3934057340b4cf408d5a5"
+     L"6592f8274eec53f0"},
+    {msg896, 1, HashBits::SHA3224, L"543e6868e1666c1a643630df77367ae5a62a85070a51c14cbf665cbc"},
+    {msg896, 1, HashBits::SHA3256, L"916f6061fe879741ca6469b43971dfdb28b1a32dc36cb3254e812be27aad1d18"},
+    {msg896, 1, HashBits::SHA3384,
+     L"79407d3b5916b59c3e30b09822974791c313fb9ecc849e406f23592d04f625dc8c709b98b43b3852b337216179aa7fc7"},
+    {msg896, 1, HashBits::SHA3512,
+     L"afebb2ef542e6579c50cad06d2e578f9f8dd6881d7dc824d26360feebf18a4fa73e3261122948efcfd492e74e82e2189ed0fb440d187f382"
+     L"270cb455f21dd185"},
+    {"a", 1000000, HashBits::SHA3224, L"d69335b93325192e516a912e6d19a15cb51c6ed5c15243e7a7fd653c"},
+    {"a", 1000000, HashBits::SHA3256, L"5c8875ae474a3634ba4fd55ec85bffd661f32aca75c6d699d0cdcb6c115891c1"},
+    {"a", 1000000, HashBits::SHA3384,
+     L"eee9e24d78c1855337983451df97c8ad9eedf256c6334f8e948d252d5e0e76847aa0774ddb90a842190d2c558b4b8340"},
+    {"a", 1000000, HashBits::SHA3512,
+     L"3c3a876da14034ab60627c077bb98f7e120a2a5370212dffb3385a18d4f38859ed311d0a9d5141ce9cc5c66ee689b266a8aa18ace8282a0e"
+     L"0db596c90b0a7b87"},
+};
+
+constexpr HashBits bits[] = {HashBits::SHA3224, HashBits::SHA3256, HashBits::SHA3384, HashBits::SHA3512};
+
+int wmain() {
+  int failed = 0;
+  for (const auto &k : kats) {
+    bela::hash::sha3::Hasher h;
+    h.Initialize(k.hb);
+    if (k.repeat == 1) {
+      h.Update(k.input.data(), k.input.size());
+    } else {
+      // 1000 does not divide any rate, every Update leaves a partial block behind
+      std::string block(1000, k.input[0]);
+      for (size_t i = 0; i < k.repeat / block.size(); i++) {
+        h.Update(block.data(), block.size());
+      }
+    }
+    auto digest = h.Finalize();
+    if (digest != k.digest) {
+      bela::FPrintF(stderr, L"SHA3-%d: FAIL '%s' x%d: %s\n", static_cast<int>(k.hb), k.input, k.repeat, digest);
+      failed++;
+    }
+  }
+  // HashMany: message counts below, at and past the four lanes, lengths around every rate so lanes finish at
+  // different blocks and the last busy lane is completed by the scalar permutation
+  std::mt19937 gen(2020);
+  std::vector<uint8_t> pool(4096);
+  for (auto &c : pool) {
+    c = static_cast<uint8_t>(gen());
+  }
+  constexpr size_t lengths[] = {0, 1, 71, 72, 73, 103, 104, 105, 135, 136, 137, 143, 144, 145, 1000, 4096};
+  constexpr size_t counts[] = {0, 1, 2, 3, 4, 5, 7, 8, 9, 17, 33};
+  for (auto hb : bits) {
+    const auto digest_length = static_cast<size_t>(hb) / 8;
+    for (auto count : counts) {
+      std::vector<bela::Span<const uint8_t>> messages;
+      for (size_t i = 0; i < count; i++) {
+        const auto len = lengths[(i * 7 + count) % std::size(lengths)];
+        messages.emplace_back(pool.data() + (i * 31) % (pool.size() - len + 1), len);
+      }
+      // one more digest than messages, it must stay untouched
+      std::vector<bela::hash::sha3::Digest> many(count + 1);
+      bela::hash::sha3::HashMany(messages, bela::MakeSpan(many), hb);
+      for (size_t i = 0; i < count; i++) {
+        bela::hash::sha3::Hasher h;
+        h.Initialize(hb);
+        h.Update(messages[i].data(), messages[i].size());
+        bela::hash::sha3::Digest want;
+        h.Finalize(want.data(), digest_length);
+        if (memcmp(many[i].data(), want.data(), digest_length) != 0) {
+          bela::FPrintF(stderr, L"SHA3-%d HashMany: FAIL message %d/%d (%d bytes)\n", static_cast<int>(hb), i, count,
+                        messages[i].size());
+          failed++;
+        }
+      }
+      if (many[count] != bela::hash::sha3::Digest{}) {
+        bela::FPrintF(stderr, L"SHA3-%d HashMany: FAIL %d messages wrote past the last digest\n", static_cast<int>(hb),
+                      count);
+        failed++;
+      }
+    }
+  }
+  bela::FPrintF(stderr, L"sha3: %d failed\n", failed);
+  return failed == 0 ? 0 : 1;
+}
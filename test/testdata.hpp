@@ -0,0 +1,34 @@
+// Reproducible test input shared by the test programs: a fixed seed xorshift64 stream, so the data is the
+// same on every run and platform without being checked in
+#ifndef BELA_TEST_TESTDATA_HPP
+#define BELA_TEST_TESTDATA_HPP
+#include <cstddef>
+#include <cstdint>
+
+namespace bela::test {
+class Xorshift {
+public:
+  uint64_t Next() {
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    return x;
+  }
+
+private:
+  uint64_t x{0x9E3779B97F4A7C15ULL};
+};
+
+template <typename T> void Fill(T *data, size_t size) {
+  Xorshift r;
+  for (size_t i = 0; i < size; i++) {
+    data[i] = static_cast<T>(r.Next());
+  }
+}
+
+// Fill any contiguous container of bytes (std::string, std::vector<uint8_t>)
+template <typename Container> void Fill(Container &c) { Fill(c.data(), c.size()); }
+
+} // namespace bela::test
+
+#endif